@@ -0,0 +1,606 @@
+#include <allocation_trace.h>
+#include <allocator_boundary_tags.h>
+#include <allocator_buddies_system.h>
+#include <allocator_global_heap.h>
+#include <allocator_red_black_tree.h>
+#include <allocator_slab.h>
+#include <allocator_sorted_list.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Single step of an allocation trace. Blocks are named by ids, so a trace does not depend on addresses
+ */
+struct trace_event
+{
+    bool allocate;
+
+    size_t id;
+
+    size_t size;
+
+    size_t alignment;
+};
+
+using trace = std::vector<trace_event>;
+
+struct run_result
+{
+    size_t operations = 0;
+
+    size_t failed = 0;
+
+    double seconds = 0;
+
+    uint64_t p99_nanoseconds = 0;
+
+    size_t peak_rss_delta = 0;
+
+    size_t peak_bytes_in_use = 0;
+
+    double fragmentation = 0;
+};
+
+struct subject
+{
+    std::string name;
+
+    std::string fit_mode;
+
+    std::function<std::unique_ptr<smart_mem_resource>()> create;
+};
+
+/**
+ * Resident set size of the process, 0 where /proc is not available
+ */
+size_t resident_set_size()
+{
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+
+    if (!(statm >> total_pages >> resident_pages))
+    {
+        return 0;
+    }
+
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * Parent of the benchmarked allocators. Spaces are mapped directly, so pages touched by one run
+ * are returned to the system when its allocator is destroyed and do not hide growth of the next run
+ */
+class mapped_resource final : public std::pmr::memory_resource
+{
+    static constexpr const size_t mapping_threshold = size_t(1) << 20;
+
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (bytes < mapping_threshold)
+        {
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void *mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        return mapping;
+    }
+
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        if (bytes < mapping_threshold)
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        munmap(p, bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+mapped_resource spaces_parent;
+
+/**
+ * Collects per operation latencies and samples RSS every few thousand operations
+ */
+class run_meter final
+{
+    std::vector<uint64_t> _latencies;
+
+    size_t _rss_baseline;
+
+    size_t _peak_rss = 0;
+
+    std::chrono::steady_clock::time_point _start;
+
+    static constexpr const size_t rss_sample_period = 4096;
+
+public:
+
+    run_meter(size_t operations_count, size_t rss_baseline):
+        _rss_baseline(rss_baseline),
+        _start(std::chrono::steady_clock::now())
+    {
+        _latencies.reserve(operations_count);
+    }
+
+    template<typename F>
+    bool measure(F &&operation)
+    {
+        auto start = std::chrono::steady_clock::now();
+        bool succeeded = true;
+
+        try
+        {
+            operation();
+        }
+        catch (std::bad_alloc const &)
+        {
+            succeeded = false;
+        }
+
+        _latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+        if (_latencies.size() % rss_sample_period == 0)
+        {
+            sample_rss();
+        }
+
+        return succeeded;
+    }
+
+    void sample_rss()
+    {
+        _peak_rss = std::max(_peak_rss, resident_set_size());
+    }
+
+    void finish(run_result &result)
+    {
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+        result.operations = _latencies.size();
+        sample_rss();
+        result.peak_rss_delta = _peak_rss > _rss_baseline ? _peak_rss - _rss_baseline : 0;
+
+        if (!_latencies.empty())
+        {
+            auto p99 = _latencies.begin() + static_cast<std::ptrdiff_t>(_latencies.size() * 99 / 100);
+            std::nth_element(_latencies.begin(), p99, _latencies.end());
+            result.p99_nanoseconds = *p99;
+        }
+    }
+};
+
+void collect_statistics(smart_mem_resource &resource, run_result &result)
+{
+    if (auto *with_statistics = dynamic_cast<allocator_with_statistics *>(&resource))
+    {
+        auto statistics = with_statistics->get_statistics();
+
+        result.peak_bytes_in_use = statistics.peak_bytes_in_use;
+        result.fragmentation = statistics.fragmentation();
+    }
+}
+
+run_result replay(smart_mem_resource &resource, trace const &events, size_t rss_baseline)
+{
+    size_t ids_count = 0;
+
+    for (auto const &event : events)
+    {
+        ids_count = std::max(ids_count, event.id + 1);
+    }
+
+    std::vector<void *> blocks(ids_count, nullptr);
+    std::vector<trace_event const *> allocations(ids_count, nullptr);
+    run_result result;
+    run_meter meter(events.size(), rss_baseline);
+
+    for (auto const &event : events)
+    {
+        void *&block = blocks[event.id];
+
+        if (event.allocate)
+        {
+            allocations[event.id] = &event;
+
+            if (!meter.measure([&] { block = resource.allocate(event.size, event.alignment); }))
+            {
+                ++result.failed;
+            }
+        }
+        else if (block != nullptr)
+        {
+            meter.measure([&] { resource.deallocate(block, event.size, event.alignment); });
+            block = nullptr;
+        }
+    }
+
+    meter.finish(result);
+
+    // fragmentation is taken with the trace live set still allocated
+    collect_statistics(resource, result);
+
+    for (size_t id = 0; id < ids_count; ++id)
+    {
+        if (blocks[id] != nullptr)
+        {
+            resource.deallocate(blocks[id], allocations[id]->size, allocations[id]->alignment);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Appends allocation and matching deallocation events. Deallocation events carry size of the block,
+ * as std::pmr::memory_resource expects
+ */
+class trace_builder final
+{
+    trace _events;
+
+    size_t _next_id = 0;
+
+    std::vector<std::pair<size_t, size_t>> _sizes;
+
+public:
+
+    size_t allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        _events.push_back({ true, _next_id, size, alignment });
+        _sizes.emplace_back(size, alignment);
+
+        return _next_id++;
+    }
+
+    void deallocate(size_t id)
+    {
+        _events.push_back({ false, id, _sizes[id].first, _sizes[id].second });
+    }
+
+    trace build() &&
+    {
+        return std::move(_events);
+    }
+};
+
+/**
+ * Sizes uniform in [16, 512], every step frees a random live block and allocates a new one
+ */
+trace uniform_trace(size_t operations_count, size_t live_count)
+{
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<size_t> size_distribution(16, 512);
+    trace_builder builder;
+    std::vector<size_t> live;
+
+    while (live.size() < live_count)
+    {
+        live.push_back(builder.allocate(size_distribution(generator)));
+    }
+
+    for (size_t i = live_count; i < operations_count; i += 2)
+    {
+        size_t &slot = live[std::uniform_int_distribution<size_t>(0, live.size() - 1)(generator)];
+
+        builder.deallocate(slot);
+        slot = builder.allocate(size_distribution(generator));
+    }
+
+    return std::move(builder).build();
+}
+
+/**
+ * Pareto distributed sizes: mostly small objects with a heavy tail of buffers up to 16 KiB.
+ * Lifetimes are random as in uniform trace
+ */
+trace power_law_trace(size_t operations_count, size_t live_count)
+{
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    trace_builder builder;
+    std::vector<size_t> live;
+
+    auto next_size = [&]
+    {
+        double size = 16.0 / std::pow(1.0 - unit(generator), 1.0 / 1.2);
+
+        return static_cast<size_t>(std::min(size, 16384.0));
+    };
+
+    while (live.size() < live_count)
+    {
+        live.push_back(builder.allocate(next_size()));
+    }
+
+    for (size_t i = live_count; i < operations_count; i += 2)
+    {
+        size_t &slot = live[std::uniform_int_distribution<size_t>(0, live.size() - 1)(generator)];
+
+        builder.deallocate(slot);
+        slot = builder.allocate(next_size());
+    }
+
+    return std::move(builder).build();
+}
+
+/**
+ * Stack discipline: bursts of allocations released in reverse order, as temporaries of nested calls are
+ */
+trace lifo_trace(size_t operations_count)
+{
+    std::mt19937 generator(17);
+    std::uniform_int_distribution<size_t> size_distribution(8, 1024);
+    std::uniform_int_distribution<size_t> depth_distribution(1, 256);
+    trace_builder builder;
+    std::vector<size_t> stack;
+
+    for (size_t operations = 0; operations < operations_count; )
+    {
+        size_t depth = depth_distribution(generator);
+
+        for (size_t i = 0; i < depth; ++i, ++operations)
+        {
+            stack.push_back(builder.allocate(size_distribution(generator)));
+        }
+
+        size_t release = std::uniform_int_distribution<size_t>(1, stack.size())(generator);
+
+        for (size_t i = 0; i < release; ++i, ++operations)
+        {
+            builder.deallocate(stack.back());
+            stack.pop_back();
+        }
+    }
+
+    return std::move(builder).build();
+}
+
+/**
+ * Queue discipline: blocks are released in allocation order once window is full, as messages in a pipeline are
+ */
+trace fifo_trace(size_t operations_count, size_t window)
+{
+    std::mt19937 generator(19);
+    std::uniform_int_distribution<size_t> size_distribution(32, 2048);
+    trace_builder builder;
+    std::vector<size_t> queue;
+    size_t head = 0;
+
+    for (size_t operations = 0; operations < operations_count; ++operations)
+    {
+        if (queue.size() - head == window)
+        {
+            builder.deallocate(queue[head++]);
+            ++operations;
+        }
+
+        queue.push_back(builder.allocate(size_distribution(generator)));
+    }
+
+    return std::move(builder).build();
+}
+
+/**
+ * Trace written by trace_recording_resource, replayed sequentially in recorded order
+ */
+trace load_trace(std::string const &path)
+{
+    trace events;
+
+    for (auto const &r : allocation_trace::read(path))
+    {
+        events.push_back({ r.kind == allocation_trace::operation::allocate, r.id, r.size, r.alignment() });
+    }
+
+    return events;
+}
+
+/**
+ * Ordered index workload: node per element, inserts and erases of random keys
+ */
+run_result map_workload(smart_mem_resource &resource, size_t operations_count, size_t rss_baseline)
+{
+    using map = std::map<size_t, std::pair<size_t, size_t>, std::less<size_t>, pp_allocator<std::pair<size_t const, std::pair<size_t, size_t>>>>;
+
+    std::mt19937 generator(23);
+    std::uniform_int_distribution<size_t> key_distribution(0, operations_count / 4);
+    run_result result;
+    run_meter meter(operations_count, rss_baseline);
+
+    {
+        map subject{ pp_allocator<map::value_type>(&resource) };
+
+        for (size_t i = 0; i < operations_count; ++i)
+        {
+            size_t key = key_distribution(generator);
+            bool succeeded = i % 3 == 2
+                ? meter.measure([&] { subject.erase(key); })
+                : meter.measure([&] { subject.emplace(key, std::make_pair(i, key)); });
+
+            if (!succeeded)
+            {
+                ++result.failed;
+            }
+        }
+
+        meter.finish(result);
+        collect_statistics(resource, result);
+    }
+
+    return result;
+}
+
+/**
+ * Hash index workload: bucket array growth plus node per element, keys are strings
+ */
+run_result hash_workload(smart_mem_resource &resource, size_t operations_count, size_t rss_baseline)
+{
+    using string = std::basic_string<char, std::char_traits<char>, pp_allocator<char>>;
+    using hash_map = std::unordered_map<size_t, string, std::hash<size_t>, std::equal_to<size_t>, pp_allocator<std::pair<size_t const, string>>>;
+
+    std::mt19937 generator(29);
+    std::uniform_int_distribution<size_t> key_distribution(0, operations_count / 4);
+    std::uniform_int_distribution<size_t> length_distribution(0, 64);
+    run_result result;
+    run_meter meter(operations_count, rss_baseline);
+
+    {
+        hash_map subject{ 0, std::hash<size_t>(), std::equal_to<size_t>(), pp_allocator<hash_map::value_type>(&resource) };
+
+        for (size_t i = 0; i < operations_count; ++i)
+        {
+            size_t key = key_distribution(generator);
+            size_t length = length_distribution(generator);
+            bool succeeded = i % 3 == 2
+                ? meter.measure([&] { subject.erase(key); })
+                : meter.measure([&] { subject.emplace(key, string(length, 'x', pp_allocator<char>(&resource))); });
+
+            if (!succeeded)
+            {
+                ++result.failed;
+            }
+        }
+
+        meter.finish(result);
+        collect_statistics(resource, result);
+    }
+
+    return result;
+}
+
+std::vector<subject> subjects(size_t space_power)
+{
+    size_t space_size = size_t(1) << space_power;
+    std::vector<subject> result;
+
+    std::pair<allocator_with_fit_mode::fit_mode, std::string> const modes[] =
+        {
+            { allocator_with_fit_mode::fit_mode::first_fit, "first" },
+            { allocator_with_fit_mode::fit_mode::the_best_fit, "best" },
+            { allocator_with_fit_mode::fit_mode::the_worst_fit, "worst" }
+        };
+
+    for (auto const &[mode, mode_name] : modes)
+    {
+        result.push_back({ "sorted_list", mode_name, [=] { return std::make_unique<allocator_sorted_list>(space_size, &spaces_parent, nullptr, mode); } });
+        result.push_back({ "boundary_tags", mode_name, [=] { return std::make_unique<allocator_boundary_tags>(space_size, &spaces_parent, nullptr, mode); } });
+        result.push_back({ "red_black_tree", mode_name, [=] { return std::make_unique<allocator_red_black_tree>(space_size, &spaces_parent, nullptr, mode); } });
+        result.push_back({ "buddies_system", mode_name, [=] { return std::make_unique<allocator_buddies_system>(space_power, &spaces_parent, nullptr, mode); } });
+    }
+
+    result.push_back({ "slab", "-", [=] { return std::make_unique<allocator_slab>(space_size, &spaces_parent); } });
+    result.push_back({ "global_heap", "-", [] { return std::make_unique<allocator_global_heap>(); } });
+
+    return result;
+}
+
+void print_header(std::string const &workload)
+{
+    std::cout << std::endl << workload << std::endl
+              << std::setw(16) << "allocator"
+              << std::setw(8) << "fit"
+              << std::setw(14) << "ops/sec"
+              << std::setw(10) << "p99 ns"
+              << std::setw(14) << "rss KiB"
+              << std::setw(14) << "peak KiB"
+              << std::setw(8) << "frag"
+              << std::setw(10) << "failed" << std::endl;
+}
+
+void print_result(subject const &s, run_result const &result)
+{
+    std::cout << std::setw(16) << s.name
+              << std::setw(8) << s.fit_mode
+              << std::setw(14) << std::fixed << std::setprecision(0) << result.operations / result.seconds
+              << std::setw(10) << result.p99_nanoseconds
+              << std::setw(14) << result.peak_rss_delta / 1024
+              << std::setw(14) << result.peak_bytes_in_use / 1024
+              << std::setw(8) << std::setprecision(3) << result.fragmentation
+              << std::setw(10) << result.failed << std::endl;
+}
+
+/**
+ * Runs every allocator and fit mode over synthetic traces, container workloads and optionally a recorded trace.
+ * Usage: mp_os_allctr_allctr_bnchmrk [operations count] [space size power] [trace file]
+ * rss KiB is the growth of resident set during the run. The global heap does not take a parent and keeps
+ * its arena chunks for the life of the process, so only its first run shows real growth
+ */
+int main(
+    int argc,
+    char *argv[])
+{
+    size_t operations_count = argc > 1 ? std::stoul(argv[1]) : 200'000;
+    size_t space_power = argc > 2 ? std::stoul(argv[2]) : 24;
+
+    std::vector<std::pair<std::string, trace>> traces;
+    traces.emplace_back("uniform sizes, random lifetimes", uniform_trace(operations_count, 2048));
+    traces.emplace_back("power law sizes, random lifetimes", power_law_trace(operations_count, 2048));
+    traces.emplace_back("LIFO lifetimes", lifo_trace(operations_count));
+    traces.emplace_back("FIFO lifetimes", fifo_trace(operations_count, 1024));
+
+    if (argc > 3)
+    {
+        traces.emplace_back(std::string("recorded trace ") + argv[3], load_trace(argv[3]));
+    }
+
+    auto all_subjects = subjects(space_power);
+
+    for (auto const &[workload, events] : traces)
+    {
+        print_header(workload);
+
+        for (auto const &s : all_subjects)
+        {
+            size_t rss_baseline = resident_set_size();
+            auto resource = s.create();
+
+            print_result(s, replay(*resource, events, rss_baseline));
+        }
+    }
+
+    std::pair<std::string, std::function<run_result(smart_mem_resource &, size_t, size_t)>> const container_workloads[] =
+        {
+            { "std::map through pp_allocator", map_workload },
+            { "std::unordered_map with pp_allocator strings", hash_workload }
+        };
+
+    for (auto const &[workload, run] : container_workloads)
+    {
+        print_header(workload);
+
+        for (auto const &s : all_subjects)
+        {
+            size_t rss_baseline = resident_set_size();
+            auto resource = s.create();
+
+            print_result(s, run(*resource, operations_count, rss_baseline));
+        }
+    }
+
+    return 0;
+}
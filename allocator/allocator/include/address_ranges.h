@@ -0,0 +1,203 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ADDRESS_RANGES_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ADDRESS_RANGES_H
+
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+/**
+ * Maps addresses to owners of memory ranges, for resources built of several allocator instances
+ * that route deallocated pointers back to the instance owning them.
+ * Ranges added before seal are fixed for the lifetime of the map, they are kept in a sorted vector searched without locks.
+ * Ranges added later are kept in a map guarded by a shared mutex, only they can be removed
+ */
+template<typename owner_type>
+class address_ranges final
+{
+
+    struct range
+    {
+        unsigned char *begin;
+
+        unsigned char *end;
+
+        owner_type owner;
+    };
+
+    std::vector<range> _fixed;
+
+    std::map<unsigned char *, range> _late;
+
+    mutable std::shared_mutex _late_mutex;
+
+    bool _sealed = false;
+
+public:
+
+    /**
+     * Not thread safe before seal
+     */
+    void add(
+        void *begin,
+        size_t size,
+        owner_type owner);
+
+    void remove(
+        void *begin);
+
+    /**
+     * Sorts fixed ranges, called once by the thread that added them
+     */
+    void seal();
+
+    std::optional<owner_type> find(
+        void const *at) const;
+};
+
+/**
+ * Parent of a single allocator instance: forwards to parent allocator and records the memory instance got
+ */
+template<typename owner_type>
+class address_range_parent final:
+    public std::pmr::memory_resource
+{
+    std::pmr::memory_resource *_parent;
+
+    address_ranges<owner_type> *_ranges;
+
+    owner_type _owner;
+
+public:
+
+    address_range_parent(
+        std::pmr::memory_resource *parent,
+        address_ranges<owner_type> *ranges,
+        owner_type owner) noexcept;
+
+private:
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void *at, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+};
+
+template<typename owner_type>
+void address_ranges<owner_type>::add(
+    void *begin,
+    size_t size,
+    owner_type owner)
+{
+    auto *first = reinterpret_cast<unsigned char *>(begin);
+
+    if (!_sealed)
+    {
+        _fixed.push_back({ first, first + size, owner });
+
+        return;
+    }
+
+    std::unique_lock lock(_late_mutex);
+
+    _late[first] = { first, first + size, owner };
+}
+
+template<typename owner_type>
+void address_ranges<owner_type>::remove(
+    void *begin)
+{
+    if (!_sealed)
+    {
+        return;
+    }
+
+    std::unique_lock lock(_late_mutex);
+
+    _late.erase(reinterpret_cast<unsigned char *>(begin));
+}
+
+template<typename owner_type>
+void address_ranges<owner_type>::seal()
+{
+    std::sort(_fixed.begin(), _fixed.end(), [](range const &left, range const &right)
+    {
+        return left.begin < right.begin;
+    });
+    _sealed = true;
+}
+
+template<typename owner_type>
+std::optional<owner_type> address_ranges<owner_type>::find(
+    void const *at) const
+{
+    auto *pointer = reinterpret_cast<unsigned char *>(const_cast<void *>(at));
+    auto fixed = std::upper_bound(_fixed.begin(), _fixed.end(), pointer, [](unsigned char *value, range const &candidate)
+    {
+        return value < candidate.begin;
+    });
+
+    if (fixed != _fixed.begin() && pointer < std::prev(fixed)->end)
+    {
+        return std::prev(fixed)->owner;
+    }
+
+    std::shared_lock lock(_late_mutex);
+
+    auto late = _late.upper_bound(pointer);
+
+    if (late != _late.begin() && pointer < std::prev(late)->second.end)
+    {
+        return std::prev(late)->second.owner;
+    }
+
+    return std::nullopt;
+}
+
+template<typename owner_type>
+address_range_parent<owner_type>::address_range_parent(
+    std::pmr::memory_resource *parent,
+    address_ranges<owner_type> *ranges,
+    owner_type owner) noexcept:
+    _parent(parent),
+    _ranges(ranges),
+    _owner(owner)
+{
+}
+
+template<typename owner_type>
+void *address_range_parent<owner_type>::do_allocate(size_t bytes, size_t alignment)
+{
+    void *block = _parent->allocate(bytes, alignment);
+
+    try
+    {
+        _ranges->add(block, bytes, _owner);
+    }
+    catch (...)
+    {
+        _parent->deallocate(block, bytes, alignment);
+        throw;
+    }
+
+    return block;
+}
+
+template<typename owner_type>
+void address_range_parent<owner_type>::do_deallocate(void *at, size_t bytes, size_t alignment)
+{
+    _ranges->remove(at);
+    _parent->deallocate(at, bytes, alignment);
+}
+
+template<typename owner_type>
+bool address_range_parent<owner_type>::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ADDRESS_RANGES_H
@@ -17,11 +17,27 @@ public:
 
 protected:
 
-    static std::string get_dump(char* data, size_t size);
+    static constexpr const size_t dump_bytes_per_line = 32;
+
+    /**
+     * Bytes as upper case hex pairs separated by spaces, every bytes_per_line bytes start a new line.
+     * 0 bytes per line means a single line
+     */
+    static std::string get_dump(char const* data, size_t size, size_t bytes_per_line = dump_bytes_per_line);
+
+    /**
+     * Writes dump into buffer of at least size * 3 chars without allocating, returns dump_length(size)
+     */
+    static size_t dump_to(char* buffer, char const* data, size_t size, size_t bytes_per_line = dump_bytes_per_line) noexcept;
+
+    static constexpr size_t dump_length(size_t size) noexcept
+    {
+        return size == 0 ? 0 : size * 3 - 1;
+    }
 
     static std::string dump_byte(char byte);
 
     static char int_to_char(int val);
 };
 
-#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_H
\ No newline at end of file
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_H
@@ -0,0 +1,113 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_GUARDS_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_GUARDS_H
+
+#include <allocator_dbg_helper.h>
+#include <cstddef>
+#include <string>
+
+#ifdef MP_OS_ALLOCATOR_GUARDS
+inline constexpr bool allocator_guards_enabled = true;
+#else
+inline constexpr bool allocator_guards_enabled = false;
+#endif
+
+/**
+ * Debug policy applied by smart_mem_resource to every block of every allocator.
+ * Enabled by MP_OS_ALLOCATOR_GUARDS cmake option, disabled policy does nothing and compiles away
+ */
+template<bool enabled>
+class allocator_guards;
+
+template<>
+class allocator_guards<false>
+{
+
+public:
+
+    static constexpr size_t overhead(size_t) noexcept
+    {
+        return 0;
+    }
+
+    static constexpr void *arm(void *block, size_t, size_t, void const *) noexcept
+    {
+        return block;
+    }
+
+    static constexpr void *disarm(void *payload, size_t) noexcept
+    {
+        return payload;
+    }
+};
+
+/**
+ * Block is laid out as [padding][requested size][call site][front red zone][payload][back red zone].
+ * Fresh payload is filled with allocated_pattern, red zones are checked on deallocation,
+ * then the whole block is filled with freed_pattern before it is returned to allocator
+ */
+template<>
+class allocator_guards<true> :
+    private allocator_dbg_helper
+{
+
+public:
+
+    static constexpr const size_t red_zone_size = 16;
+
+    static constexpr const unsigned char red_zone_pattern = 0xFD;
+
+    static constexpr const unsigned char allocated_pattern = 0xCD;
+
+    static constexpr const unsigned char freed_pattern = 0xDD;
+
+public:
+
+    /**
+     * Size added to requested size of block with given alignment
+     */
+    static size_t overhead(
+        size_t alignment) noexcept;
+
+    /**
+     * Lays out guards in block got from allocator and returns payload
+     */
+    static void *arm(
+        void *block,
+        size_t size,
+        size_t alignment,
+        void const *call_site) noexcept;
+
+    /**
+     * Checks guards, prints report and aborts if they are broken. Poisons block and returns its start
+     */
+    static void *disarm(
+        void *payload,
+        size_t alignment) noexcept;
+
+    /**
+     * Empty if guards of payload are intact, description of damage otherwise
+     */
+    static std::string check(
+        void const *payload);
+
+    static size_t requested_size(
+        void const *payload) noexcept;
+
+    /**
+     * Return address of the code that called allocate, resolve it with addr2line
+     */
+    static void const *call_site(
+        void const *payload) noexcept;
+
+private:
+
+    static constexpr const size_t header_size = sizeof(size_t) + sizeof(void const *) + red_zone_size;
+
+    static size_t front_size(
+        size_t alignment) noexcept;
+
+    static size_t first_broken(
+        unsigned char const *zone) noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_GUARDS_H
@@ -2,6 +2,7 @@
 #define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_TEST_UTILS_H
 
 #include <cstddef>
+#include <memory_resource>
 #include <vector>
 #include <string>
 
@@ -33,6 +34,17 @@ public:
     //synchronized interface, delegates to _inner version
     virtual std::vector<block_info> get_blocks_info() const = 0;
 
+public:
+
+    /**
+     * For every alignment from 8 to max_alignment allocates blocks of 1, alignment - 1 and alignment * 3 + 5 bytes,
+     * fills them, checks their addresses and contents and deallocates them; if resource reports its blocks,
+     * all of them must be free afterwards. Returns description of the first violation, empty string if there is none
+     */
+    static std::string check_alignments(
+        std::pmr::memory_resource &resource,
+        size_t max_alignment = 4096);
+
 protected:
 
     //without synchronization, real implementation
@@ -0,0 +1,53 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_WITH_COMPACTION_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_WITH_COMPACTION_H
+
+#include <cstddef>
+
+class allocator_with_compaction
+{
+
+public:
+
+    /**
+     * Owner of blocks that can be moved, told about every move. Called under allocator lock,
+     * so it must not call allocator back
+     */
+    class relocation_listener
+    {
+
+    public:
+
+        virtual ~relocation_listener() noexcept = default;
+
+    public:
+
+        /**
+         * Asked for every occupied block in address order. Movable blocks must not rely on alignment
+         * stricter than alignof(std::max_align_t)
+         */
+        virtual bool is_movable(
+            void *at) const noexcept = 0;
+
+        /**
+         * Contents of the block are already at their new place
+         */
+        virtual void on_moved(
+            void *from,
+            void *to) noexcept = 0;
+    };
+
+public:
+
+    virtual ~allocator_with_compaction() noexcept = default;
+
+public:
+
+    /**
+     * Slides movable occupied blocks towards the space start, so free space between them merges into bigger blocks.
+     * Unmovable blocks stay where they are and split free space. Returns count of moved blocks
+     */
+    virtual size_t compact(
+        relocation_listener &listener) = 0;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_WITH_COMPACTION_H
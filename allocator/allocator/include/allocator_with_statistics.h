@@ -0,0 +1,129 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_WITH_STATISTICS_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_WITH_STATISTICS_H
+
+#include <logger.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * Cheap statistics of an allocator. Counters are atomics updated on every allocation and deallocation,
+ * so they can be read at any moment without taking allocator mutex and without walking its blocks.
+ * Allocator without a lock of its own may keep counters its own way and override get_statistics.
+ */
+class allocator_with_statistics
+{
+
+public:
+
+    /**
+     * Bucket 0 counts empty requests, bucket k counts requests of [2^(k-1), 2^k) bytes
+     */
+    static constexpr const size_t request_size_histogram_size = sizeof(size_t) * 8 + 1;
+
+    struct statistics final
+    {
+
+        size_t allocations;
+
+        size_t deallocations;
+
+        size_t failed_allocations;
+
+        /**
+         * Bytes of occupied blocks including their metadata
+         */
+        size_t bytes_in_use;
+
+        size_t peak_bytes_in_use;
+
+        size_t free_bytes;
+
+        size_t largest_free_block;
+
+        std::array<size_t, request_size_histogram_size> request_size_histogram;
+
+        /**
+         * 0 when all free space is a single block, tends to 1 when free space is split into many small blocks
+         */
+        double fragmentation() const noexcept;
+
+        std::string to_string() const;
+
+    };
+
+public:
+
+    virtual ~allocator_with_statistics() noexcept = default;
+
+public:
+
+    virtual statistics get_statistics() const noexcept;
+
+    void log_statistics(
+        logger::severity severity = logger::severity::information) const;
+
+protected:
+
+    allocator_with_statistics();
+
+    allocator_with_statistics(
+        allocator_with_statistics &&other) noexcept = default;
+
+    allocator_with_statistics &operator=(
+        allocator_with_statistics &&other) noexcept = default;
+
+protected:
+
+    void record_allocation(
+        size_t requested_size,
+        size_t block_size) noexcept;
+
+    void record_failed_allocation(
+        size_t requested_size) noexcept;
+
+    void record_deallocation(
+        size_t block_size) noexcept;
+
+    /**
+     * Called by allocator after every change of its free space, while it still holds its own lock
+     */
+    void record_free_space(
+        size_t free_bytes,
+        size_t largest_free_block) noexcept;
+
+    size_t bytes_in_use() const noexcept;
+
+    static size_t histogram_bucket(size_t size) noexcept;
+
+    inline virtual logger *get_logger() const = 0;
+
+private:
+
+    struct counters
+    {
+        std::atomic<size_t> allocations = 0;
+
+        std::atomic<size_t> deallocations = 0;
+
+        std::atomic<size_t> failed_allocations = 0;
+
+        std::atomic<size_t> bytes_in_use = 0;
+
+        std::atomic<size_t> peak_bytes_in_use = 0;
+
+        std::atomic<size_t> free_bytes = 0;
+
+        std::atomic<size_t> largest_free_block = 0;
+
+        std::array<std::atomic<size_t>, request_size_histogram_size> request_size_histogram{};
+    };
+
+    std::unique_ptr<counters> _counters;
+
+    void record_request(size_t requested_size) noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_WITH_STATISTICS_H
@@ -15,9 +15,32 @@ private:
 
     void do_deallocate(void* p, size_t, size_t) final;
 
+    /**
+     * Must return block aligned by alignof(std::max_align_t) if size is not less than it
+     */
     virtual void* do_allocate_sm(size_t) =0;
 
     void * do_allocate(size_t _Bytes, size_t _Align) final;
+
+protected:
+
+    /**
+     * Default implementation forwards fundamental alignments to do_allocate_sm(size_t).
+     * Stricter alignments are served by over-allocating and recording padding right before returned pointer
+     */
+    virtual void* do_allocate_sm(size_t size, size_t alignment);
+
+    /**
+     * Called with the same alignment as was passed to allocate, finds true block start by recorded padding
+     */
+    virtual void do_deallocate_sm(void* p, size_t alignment);
+
+    static constexpr const size_t aligned_padding_size = sizeof(size_t);
+
+    static constexpr bool is_extended_alignment(size_t alignment) noexcept
+    {
+        return alignment > alignof(std::max_align_t);
+    }
 };
 
 
@@ -2,35 +2,141 @@
 // Created by Des Caldnd on 4/1/2024.
 //
 #include "allocator_dbg_helper.h"
+#include <array>
+#include <cstring>
 
-std::string allocator_dbg_helper::get_dump(char *data, size_t size)
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+namespace
 {
-    std::string res;
+    constexpr char hex_digits[] = "0123456789ABCDEF";
+
+    constexpr std::array<std::array<char, 2>, 256> hex_table = []
+    {
+        std::array<std::array<char, 2>, 256> table{};
+
+        for (size_t byte = 0; byte < 256; ++byte)
+        {
+            table[byte] = { hex_digits[byte >> 4], hex_digits[byte & 0xF] };
+        }
+
+        return table;
+    }();
+
+#ifdef __SSSE3__
+
+    /**
+     * 16 bytes take 48 chars, every third of them is a separator. Char j of output chunk c comes from hex pair
+     * (16 * c + j) / 3, pairs 0..7 are held by one vector and pairs 8..15 by another, so each chunk is merged
+     * from two byte shuffles and a separators mask
+     */
+    constexpr std::array<char, 16> pair_shuffle(size_t chunk, size_t first_pair)
+    {
+        std::array<char, 16> indices{};
+
+        for (size_t j = 0; j < 16; ++j)
+        {
+            size_t position = chunk * 16 + j;
+            size_t pair = position / 3;
 
-    if (size > 0)
+            indices[j] = position % 3 != 2 && pair >= first_pair && pair < first_pair + 8
+                ? static_cast<char>(2 * (pair - first_pair) + position % 3)
+                : static_cast<char>(0x80);
+        }
+
+        return indices;
+    }
+
+    constexpr std::array<char, 16> separators(size_t chunk)
     {
-        res.reserve(size * 3);
+        std::array<char, 16> mask{};
+
+        for (size_t j = 0; j < 16; ++j)
+        {
+            mask[j] = (chunk * 16 + j) % 3 == 2 ? ' ' : '\0';
+        }
+
+        return mask;
+    }
 
-        res += dump_byte(data[0]);
+    constexpr std::array<std::array<std::array<char, 16>, 3>, 3> chunk_masks =
+        {{
+            { pair_shuffle(0, 0), pair_shuffle(0, 8), separators(0) },
+            { pair_shuffle(1, 0), pair_shuffle(1, 8), separators(1) },
+            { pair_shuffle(2, 0), pair_shuffle(2, 8), separators(2) }
+        }};
 
-        for (size_t i = 1; i < size; ++i)
+    void encode_16(char *out, unsigned char const *bytes) noexcept
+    {
+        __m128i digits = _mm_loadu_si128(reinterpret_cast<__m128i const *>(hex_digits));
+        __m128i nibble_mask = _mm_set1_epi8(0x0F);
+        __m128i in = _mm_loadu_si128(reinterpret_cast<__m128i const *>(bytes));
+        __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), nibble_mask));
+        __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(in, nibble_mask));
+        __m128i first_pairs = _mm_unpacklo_epi8(high, low);
+        __m128i last_pairs = _mm_unpackhi_epi8(high, low);
+
+        for (size_t chunk = 0; chunk < 3; ++chunk)
         {
-            res += " " + dump_byte(data[i]);
+            auto const &masks = chunk_masks[chunk];
+            __m128i chars = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_shuffle_epi8(first_pairs, _mm_loadu_si128(reinterpret_cast<__m128i const *>(masks[0].data()))),
+                    _mm_shuffle_epi8(last_pairs, _mm_loadu_si128(reinterpret_cast<__m128i const *>(masks[1].data())))),
+                _mm_loadu_si128(reinterpret_cast<__m128i const *>(masks[2].data())));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + chunk * 16), chars);
         }
     }
+
+#endif
+}
+
+std::string allocator_dbg_helper::get_dump(char const *data, size_t size, size_t bytes_per_line)
+{
+    std::string res(size * 3, '\0');
+
+    res.resize(dump_to(res.data(), data, size, bytes_per_line));
+
     return res;
 }
 
-std::string allocator_dbg_helper::dump_byte(char byte)
+size_t allocator_dbg_helper::dump_to(char *buffer, char const *data, size_t size, size_t bytes_per_line) noexcept
 {
-    std::string res;
+    auto const *bytes = reinterpret_cast<unsigned char const *>(data);
+    size_t i = 0;
 
-    constexpr const char right_mask = 0u | (1u << 3) | (1u << 2) | (1u << 1) | (1u);
+#ifdef __SSSE3__
+    for (; i + 16 <= size; i += 16)
+    {
+        encode_16(buffer + i * 3, bytes + i);
+    }
+#endif
 
-    res.push_back(int_to_char((byte >> 4) & right_mask));
-    res.push_back(int_to_char(byte & right_mask));
+    for (; i < size; ++i)
+    {
+        std::memcpy(buffer + i * 3, hex_table[bytes[i]].data(), 2);
+        buffer[i * 3 + 2] = ' ';
+    }
 
-    return res;
+    if (bytes_per_line != 0)
+    {
+        for (size_t line_end = bytes_per_line; line_end < size; line_end += bytes_per_line)
+        {
+            buffer[line_end * 3 - 1] = '\n';
+        }
+    }
+
+    return dump_length(size);
+}
+
+std::string allocator_dbg_helper::dump_byte(char byte)
+{
+    auto const &pair = hex_table[static_cast<unsigned char>(byte)];
+
+    return { pair[0], pair[1] };
 }
 
 char allocator_dbg_helper::int_to_char(int val)
@@ -38,5 +144,5 @@ char allocator_dbg_helper::int_to_char(int val)
     if (val < 10)
         return '0' + val;
     else
-        return 'A' + val;
-}
\ No newline at end of file
+        return 'A' + val - 10;
+}
@@ -0,0 +1,116 @@
+#include "../include/allocator_guards.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+size_t allocator_guards<true>::overhead(size_t alignment) noexcept
+{
+    return front_size(alignment) + red_zone_size;
+}
+
+void *allocator_guards<true>::arm(void *block, size_t size, size_t alignment, void const *call_site) noexcept
+{
+    auto *payload = reinterpret_cast<unsigned char *>(block) + front_size(alignment);
+
+    std::memcpy(payload - header_size, &size, sizeof(size_t));
+    std::memcpy(payload - header_size + sizeof(size_t), &call_site, sizeof(void const *));
+    std::memset(payload - red_zone_size, red_zone_pattern, red_zone_size);
+    std::memset(payload, allocated_pattern, size);
+    std::memset(payload + size, red_zone_pattern, red_zone_size);
+
+    return payload;
+}
+
+void *allocator_guards<true>::disarm(void *payload, size_t alignment) noexcept
+{
+    if (payload == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto const *front = reinterpret_cast<unsigned char const *>(payload) - red_zone_size;
+
+    // zones are checked without allocating, report is built only for broken blocks
+    if (first_broken(front) != red_zone_size || first_broken(front + red_zone_size + requested_size(payload)) != red_zone_size)
+    {
+        std::cerr << "allocator guards: " << check(payload) << std::endl;
+        std::abort();
+    }
+
+    auto *block = reinterpret_cast<unsigned char *>(payload) - front_size(alignment);
+
+    std::memset(block, freed_pattern, front_size(alignment) + requested_size(payload) + red_zone_size);
+
+    return block;
+}
+
+std::string allocator_guards<true>::check(void const *payload)
+{
+    auto const *front = reinterpret_cast<unsigned char const *>(payload) - red_zone_size;
+    size_t broken = first_broken(front);
+
+    if (broken != red_zone_size)
+    {
+        std::stringstream result;
+
+        result << "block " << payload;
+
+        if (std::all_of(front, front + red_zone_size, [](unsigned char byte) { return byte == freed_pattern; }))
+        {
+            result << " is already deallocated";
+        }
+        else
+        {
+            result << " is damaged before its start, front red zone: "
+                   << get_dump(reinterpret_cast<char const *>(front), red_zone_size);
+        }
+
+        return result.str();
+    }
+
+    auto const *back = reinterpret_cast<unsigned char const *>(payload) + requested_size(payload);
+    broken = first_broken(back);
+
+    if (broken != red_zone_size)
+    {
+        std::stringstream result;
+
+        result << "block " << payload << " of " << requested_size(payload) << " bytes allocated at " << call_site(payload)
+               << " is overrun, first damaged byte is " << broken << " bytes past its end, back red zone: "
+               << get_dump(reinterpret_cast<char const *>(back), red_zone_size);
+
+        return result.str();
+    }
+
+    return {};
+}
+
+size_t allocator_guards<true>::requested_size(void const *payload) noexcept
+{
+    size_t size;
+
+    std::memcpy(&size, reinterpret_cast<unsigned char const *>(payload) - header_size, sizeof(size_t));
+
+    return size;
+}
+
+void const *allocator_guards<true>::call_site(void const *payload) noexcept
+{
+    void const *site;
+
+    std::memcpy(&site, reinterpret_cast<unsigned char const *>(payload) - header_size + sizeof(size_t), sizeof(void const *));
+
+    return site;
+}
+
+size_t allocator_guards<true>::front_size(size_t alignment) noexcept
+{
+    return std::max(header_size, alignment);
+}
+
+size_t allocator_guards<true>::first_broken(unsigned char const *zone) noexcept
+{
+    return std::find_if(zone, zone + red_zone_size, [](unsigned char byte) { return byte != red_zone_pattern; }) - zone;
+}
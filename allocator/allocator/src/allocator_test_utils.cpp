@@ -1,6 +1,9 @@
 #include "../include/allocator_test_utils.h"
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 bool allocator_test_utils::block_info::operator==(
     allocator_test_utils::block_info const &other) const noexcept
@@ -34,3 +37,49 @@ std::string allocator_test_utils::print_blocks() const
 
     return res.str();
 }
+
+std::string allocator_test_utils::check_alignments(
+    std::pmr::memory_resource &resource,
+    size_t max_alignment)
+{
+    for (size_t alignment = 8; alignment <= max_alignment; alignment <<= 1)
+    {
+        std::vector<std::pair<unsigned char *, size_t>> blocks;
+
+        for (size_t size : { size_t(1), alignment - 1, alignment * 3 + 5 })
+        {
+            auto *block = reinterpret_cast<unsigned char *>(resource.allocate(size, alignment));
+
+            if (reinterpret_cast<uintptr_t>(block) % alignment != 0)
+            {
+                return "block of " + std::to_string(size) + " bytes is not aligned by " + std::to_string(alignment);
+            }
+
+            memset(block, static_cast<int>(size % 256), size);
+            blocks.emplace_back(block, size);
+        }
+
+        for (auto [block, size] : blocks)
+        {
+            if (block[0] != static_cast<unsigned char>(size % 256) || block[size - 1] != static_cast<unsigned char>(size % 256))
+            {
+                return "block of " + std::to_string(size) + " bytes aligned by " + std::to_string(alignment) + " is overwritten";
+            }
+
+            resource.deallocate(block, size, alignment);
+        }
+    }
+
+    if (auto *utils = dynamic_cast<allocator_test_utils *>(&resource))
+    {
+        for (auto const &block : utils->get_blocks_info())
+        {
+            if (block.is_block_occupied)
+            {
+                return "occupied block of " + std::to_string(block.block_size) + " bytes is left after deallocation";
+            }
+        }
+    }
+
+    return {};
+}
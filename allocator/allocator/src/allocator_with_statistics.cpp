@@ -0,0 +1,126 @@
+#include "../include/allocator_with_statistics.h"
+#include <bit>
+#include <sstream>
+
+double allocator_with_statistics::statistics::fragmentation() const noexcept
+{
+    return free_bytes == 0 ? 0 : 1 - static_cast<double>(largest_free_block) / static_cast<double>(free_bytes);
+}
+
+std::string allocator_with_statistics::statistics::to_string() const
+{
+    std::stringstream result;
+
+    result << "allocations: " << allocations
+           << ", deallocations: " << deallocations
+           << ", failed allocations: " << failed_allocations
+           << ", bytes in use: " << bytes_in_use
+           << ", peak bytes in use: " << peak_bytes_in_use
+           << ", free bytes: " << free_bytes
+           << ", largest free block: " << largest_free_block
+           << ", fragmentation: " << fragmentation()
+           << ", request sizes:";
+
+    for (size_t k = 0; k < request_size_histogram_size; ++k)
+    {
+        if (request_size_histogram[k] != 0)
+        {
+            result << " [" << (k == 0 ? 0 : size_t(1) << (k - 1)) << ", " << (k == 0 ? 1 : (size_t(1) << (k - 1)) * 2) << "): " << request_size_histogram[k];
+        }
+    }
+
+    return result.str();
+}
+
+allocator_with_statistics::allocator_with_statistics():
+    _counters(std::make_unique<counters>())
+{
+}
+
+allocator_with_statistics::statistics allocator_with_statistics::get_statistics() const noexcept
+{
+    statistics result{};
+
+    if (_counters == nullptr)
+    {
+        return result;
+    }
+
+    result.allocations = _counters->allocations.load(std::memory_order_relaxed);
+    result.deallocations = _counters->deallocations.load(std::memory_order_relaxed);
+    result.failed_allocations = _counters->failed_allocations.load(std::memory_order_relaxed);
+    result.bytes_in_use = _counters->bytes_in_use.load(std::memory_order_relaxed);
+    result.peak_bytes_in_use = _counters->peak_bytes_in_use.load(std::memory_order_relaxed);
+    result.free_bytes = _counters->free_bytes.load(std::memory_order_relaxed);
+    result.largest_free_block = _counters->largest_free_block.load(std::memory_order_relaxed);
+
+    for (size_t k = 0; k < request_size_histogram_size; ++k)
+    {
+        result.request_size_histogram[k] = _counters->request_size_histogram[k].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+void allocator_with_statistics::log_statistics(
+    logger::severity severity) const
+{
+    logger *target = get_logger();
+
+    if (target != nullptr)
+    {
+        target->log(get_statistics().to_string(), severity);
+    }
+}
+
+void allocator_with_statistics::record_allocation(
+    size_t requested_size,
+    size_t block_size) noexcept
+{
+    record_request(requested_size);
+    _counters->allocations.fetch_add(1, std::memory_order_relaxed);
+
+    size_t in_use = _counters->bytes_in_use.fetch_add(block_size, std::memory_order_relaxed) + block_size;
+    size_t peak = _counters->peak_bytes_in_use.load(std::memory_order_relaxed);
+
+    while (in_use > peak && !_counters->peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+    {
+    }
+}
+
+void allocator_with_statistics::record_failed_allocation(
+    size_t requested_size) noexcept
+{
+    record_request(requested_size);
+    _counters->failed_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void allocator_with_statistics::record_deallocation(
+    size_t block_size) noexcept
+{
+    _counters->deallocations.fetch_add(1, std::memory_order_relaxed);
+    _counters->bytes_in_use.fetch_sub(block_size, std::memory_order_relaxed);
+}
+
+void allocator_with_statistics::record_free_space(
+    size_t free_bytes,
+    size_t largest_free_block) noexcept
+{
+    _counters->free_bytes.store(free_bytes, std::memory_order_relaxed);
+    _counters->largest_free_block.store(largest_free_block, std::memory_order_relaxed);
+}
+
+size_t allocator_with_statistics::bytes_in_use() const noexcept
+{
+    return _counters->bytes_in_use.load(std::memory_order_relaxed);
+}
+
+size_t allocator_with_statistics::histogram_bucket(size_t size) noexcept
+{
+    return std::bit_width(size);
+}
+
+void allocator_with_statistics::record_request(size_t requested_size) noexcept
+{
+    _counters->request_size_histogram[histogram_bucket(requested_size)].fetch_add(1, std::memory_order_relaxed);
+}
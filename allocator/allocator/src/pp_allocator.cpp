@@ -2,17 +2,84 @@
 // Created by Des Caldnd on 6/29/2024.
 //
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
 #include "pp_allocator.h"
+#include "allocator_guards.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MP_OS_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define MP_OS_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
 
-void smart_mem_resource::do_deallocate(void* p, size_t, size_t)
+using guards = allocator_guards<allocator_guards_enabled>;
+
+void smart_mem_resource::do_deallocate(void* p, size_t, size_t _Align)
 {
-    do_deallocate_sm(p);
+    do_deallocate_sm(guards::disarm(p, _Align), _Align);
 }
 
 void * smart_mem_resource::do_allocate(size_t _Bytes, size_t _Align)
 {
-    return do_allocate_sm(_Bytes);
+    if ((_Align & (_Align - 1)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    if (_Bytes > std::numeric_limits<size_t>::max() - guards::overhead(_Align))
+    {
+        throw std::bad_alloc();
+    }
+
+    // memory_resource::allocate is inlined, so return address points into its caller
+    return guards::arm(do_allocate_sm(_Bytes + guards::overhead(_Align), _Align), _Bytes, _Align,
+                       allocator_guards_enabled ? MP_OS_RETURN_ADDRESS() : nullptr);
+}
+
+void* smart_mem_resource::do_allocate_sm(size_t size, size_t alignment)
+{
+    if (!is_extended_alignment(alignment))
+    {
+        return do_allocate_sm(size);
+    }
+
+    if (size > std::numeric_limits<size_t>::max() - alignment)
+    {
+        throw std::bad_alloc();
+    }
+
+    // block is aligned by alignof(std::max_align_t), so padding never exceeds alignment
+    auto* block = reinterpret_cast<unsigned char*>(do_allocate_sm(size + alignment));
+    auto address = reinterpret_cast<uintptr_t>(block) + aligned_padding_size;
+    auto* aligned = reinterpret_cast<unsigned char*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+    size_t padding = aligned - block;
+
+    std::memcpy(aligned - aligned_padding_size, &padding, aligned_padding_size);
+
+    return aligned;
+}
+
+void smart_mem_resource::do_deallocate_sm(void* p, size_t alignment)
+{
+    if (!is_extended_alignment(alignment))
+    {
+        do_deallocate_sm(p);
+        return;
+    }
+
+    if (p == nullptr)
+    {
+        return;
+    }
+
+    size_t padding;
+    std::memcpy(&padding, reinterpret_cast<unsigned char*>(p) - aligned_padding_size, aligned_padding_size);
+
+    do_deallocate_sm(reinterpret_cast<unsigned char*>(p) - padding);
 }
 
 void* test_mem_resource::do_allocate_sm(size_t n)
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <allocator_dbg_helper.h>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+class dump_checker final :
+    private allocator_dbg_helper
+{
+
+public:
+
+    using allocator_dbg_helper::get_dump;
+
+    using allocator_dbg_helper::dump_to;
+
+    using allocator_dbg_helper::dump_byte;
+
+    using allocator_dbg_helper::int_to_char;
+
+    static std::string reference_dump(char const *data, size_t size, size_t bytes_per_line)
+    {
+        std::string result;
+        char pair[3];
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (i != 0)
+            {
+                result += bytes_per_line != 0 && i % bytes_per_line == 0 ? '\n' : ' ';
+            }
+
+            std::snprintf(pair, sizeof(pair), "%02X", static_cast<unsigned char>(data[i]));
+            result += pair;
+        }
+
+        return result;
+    }
+};
+
+TEST(allocatorDbgHelperPositiveTests, test1)
+{
+    ASSERT_EQ(dump_checker::int_to_char(9), '9');
+    ASSERT_EQ(dump_checker::int_to_char(10), 'A');
+    ASSERT_EQ(dump_checker::int_to_char(15), 'F');
+    ASSERT_EQ(dump_checker::dump_byte(static_cast<char>(0xAF)), "AF");
+    ASSERT_EQ(dump_checker::dump_byte(0x0C), "0C");
+
+    char const data[] = { 0x00, 0x1B, static_cast<char>(0xFE) };
+
+    ASSERT_EQ(dump_checker::get_dump(data, 3), "00 1B FE");
+    ASSERT_EQ(dump_checker::get_dump(data, 3, 2), "00 1B\nFE");
+    ASSERT_EQ(dump_checker::get_dump(data, 0), "");
+}
+
+TEST(allocatorDbgHelperPositiveTests, test2)
+{
+    std::mt19937 generator(17);
+    std::vector<char> data(200);
+
+    for (auto &byte : data)
+    {
+        byte = static_cast<char>(generator());
+    }
+
+    for (size_t size = 0; size <= data.size(); ++size)
+    {
+        for (size_t bytes_per_line : { size_t(0), size_t(1), size_t(7), size_t(16), size_t(32) })
+        {
+            ASSERT_EQ(dump_checker::get_dump(data.data(), size, bytes_per_line), dump_checker::reference_dump(data.data(), size, bytes_per_line));
+        }
+    }
+
+    std::vector<char> buffer(data.size() * 3, '#');
+
+    ASSERT_EQ(dump_checker::dump_to(buffer.data(), data.data(), data.size()), data.size() * 3 - 1);
+    ASSERT_EQ(std::string(buffer.data(), data.size() * 3 - 1), dump_checker::reference_dump(data.data(), data.size(), 32));
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <allocator_guards.h>
+#include <pp_allocator.h>
+#include <cstdint>
+#include <vector>
+
+using enabled_guards = allocator_guards<true>;
+
+static_assert(allocator_guards<false>::overhead(alignof(std::max_align_t)) == 0);
+
+TEST(allocatorGuardsPositiveTests, test1)
+{
+    alignas(std::max_align_t) unsigned char block[256];
+    int site;
+
+    auto *payload = reinterpret_cast<unsigned char *>(enabled_guards::arm(block, 40, alignof(std::max_align_t), &site));
+
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(payload) % alignof(std::max_align_t), 0);
+    ASSERT_LE(payload + 40 + enabled_guards::red_zone_size, block + enabled_guards::overhead(alignof(std::max_align_t)) + 40);
+    ASSERT_EQ(enabled_guards::requested_size(payload), 40);
+    ASSERT_EQ(enabled_guards::call_site(payload), &site);
+    ASSERT_EQ(payload[0], enabled_guards::allocated_pattern);
+    ASSERT_EQ(payload[39], enabled_guards::allocated_pattern);
+    ASSERT_TRUE(enabled_guards::check(payload).empty());
+
+    payload[39] = 0;
+
+    ASSERT_TRUE(enabled_guards::check(payload).empty());
+    ASSERT_EQ(enabled_guards::disarm(payload, alignof(std::max_align_t)), block);
+    ASSERT_EQ(payload[0], enabled_guards::freed_pattern);
+    ASSERT_EQ(block[0], enabled_guards::freed_pattern);
+}
+
+TEST(allocatorGuardsPositiveTests, test2)
+{
+    alignas(64) unsigned char block[256];
+
+    auto *payload = reinterpret_cast<unsigned char *>(enabled_guards::arm(block, 7, 64, nullptr));
+
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(payload) % 64, 0);
+    ASSERT_TRUE(enabled_guards::check(payload).empty());
+    ASSERT_EQ(enabled_guards::disarm(payload, 64), block);
+}
+
+TEST(allocatorGuardsPositiveTests, test3)
+{
+    test_mem_resource resource;
+
+    auto *payload = resource.allocate(24);
+
+    if constexpr (allocator_guards_enabled)
+    {
+        ASSERT_EQ(enabled_guards::requested_size(payload), 24);
+        ASSERT_NE(enabled_guards::call_site(payload), nullptr);
+        ASSERT_TRUE(enabled_guards::check(payload).empty());
+    }
+
+    resource.deallocate(payload, 24);
+}
+
+TEST(allocatorGuardsNegativeTests, test1)
+{
+    alignas(std::max_align_t) unsigned char block[256];
+
+    auto *payload = reinterpret_cast<unsigned char *>(enabled_guards::arm(block, 40, alignof(std::max_align_t), nullptr));
+
+    payload[41] = 0;
+
+    auto report = enabled_guards::check(payload);
+
+    ASSERT_NE(report.find("overrun"), std::string::npos);
+    ASSERT_NE(report.find("1 bytes past its end"), std::string::npos);
+    ASSERT_DEATH(enabled_guards::disarm(payload, alignof(std::max_align_t)), "overrun");
+}
+
+TEST(allocatorGuardsNegativeTests, test2)
+{
+    alignas(std::max_align_t) unsigned char block[256];
+
+    auto *payload = reinterpret_cast<unsigned char *>(enabled_guards::arm(block, 40, alignof(std::max_align_t), nullptr));
+
+    payload[-1] = 0;
+
+    ASSERT_NE(enabled_guards::check(payload).find("before its start"), std::string::npos);
+
+    payload[-1] = enabled_guards::red_zone_pattern;
+
+    static_cast<void>(enabled_guards::disarm(payload, alignof(std::max_align_t)));
+
+    ASSERT_NE(enabled_guards::check(payload).find("already deallocated"), std::string::npos);
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATOR_ARENA_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATOR_ARENA_H
+
+#include <pp_allocator.h>
+#include <logger_guardant.h>
+#include <typename_holder.h>
+
+/**
+ * Monotonic resource for objects that die together, e.g. temporaries of a single request.
+ * Blocks are bump allocated from chunks taken from parent allocator, deallocation of a single block does nothing.
+ * reset() drops all blocks at once and keeps chunks for reuse, release() also returns chunks to parent.
+ * Chunks are kept in allocation order, so a scope can rewind arena to the state it had when scope was opened.
+ * Like std::pmr::monotonic_buffer_resource, arena is not synchronized and is meant to be owned by a single thread.
+ */
+class allocator_arena final:
+    public smart_mem_resource,
+    private logger_guardant,
+    private typename_holder
+{
+
+public:
+
+    static constexpr const size_t default_chunk_size = size_t(1) << 16;
+
+    /**
+     * Rewinds arena to the state it had on construction when destroyed.
+     * Blocks allocated inside scope must not be used after it, blocks allocated before are kept.
+     * Scopes may be nested, inner scope must be destroyed first.
+     * reset() and release() must not be called while a scope is open.
+     */
+    class scope final
+    {
+
+        friend class allocator_arena;
+
+    private:
+
+        allocator_arena *_arena;
+
+        void *_chunk;
+
+        unsigned char *_top;
+
+    public:
+
+        explicit scope(
+            allocator_arena &arena) noexcept;
+
+        scope(
+            scope const &other) = delete;
+
+        scope &operator=(
+            scope const &other) = delete;
+
+        ~scope() noexcept;
+
+    };
+
+private:
+
+    /**
+     * Next chunk, size of chunk including header
+     */
+    static constexpr const size_t chunk_metadata_size = (sizeof(void *) + sizeof(size_t) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    std::pmr::memory_resource *_parent;
+
+    logger *_logger;
+
+    size_t _chunk_size;
+
+    /**
+     * Chunks in use from oldest to current one
+     */
+    void *_first_chunk = nullptr;
+
+    void *_current_chunk = nullptr;
+
+    /**
+     * Chunks dropped by reset or rewinding scope, reused before asking parent for new ones
+     */
+    void *_spare_chunks = nullptr;
+
+    unsigned char *_top = nullptr;
+
+    unsigned char *_end = nullptr;
+
+public:
+
+    explicit allocator_arena(
+        size_t chunk_size = default_chunk_size,
+        std::pmr::memory_resource *parent_allocator = nullptr,
+        logger *logger = nullptr);
+
+    allocator_arena(
+        allocator_arena const &other) = delete;
+
+    allocator_arena &operator=(
+        allocator_arena const &other) = delete;
+
+    allocator_arena(
+        allocator_arena &&other) noexcept;
+
+    allocator_arena &operator=(
+        allocator_arena &&other) noexcept;
+
+    ~allocator_arena() override;
+
+public:
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size) override;
+
+    void do_deallocate_sm(
+        void *at) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+
+    /**
+     * Drops all blocks in O(1), chunks stay in arena and are reused by next allocations
+     */
+    void reset() noexcept;
+
+    /**
+     * Drops all blocks and returns every chunk to parent allocator
+     */
+    void release() noexcept;
+
+    /**
+     * Chunks currently taken from parent, both used and spare
+     */
+    size_t chunks_count() const noexcept;
+
+protected:
+
+    /**
+     * Extended alignment is served by aligning bump pointer, no padding has to be recorded
+     * since blocks are never deallocated one by one
+     */
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size,
+        size_t alignment) override;
+
+    void do_deallocate_sm(
+        void *at,
+        size_t alignment) override;
+
+private:
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    void *bump(
+        size_t size,
+        size_t alignment) noexcept;
+
+    void *allocate_in_new_chunk(
+        size_t size,
+        size_t alignment);
+
+    void rewind(
+        void *chunk,
+        unsigned char *top) noexcept;
+
+    static void *&chunk_next_ref(void *chunk) noexcept;
+
+    static size_t &chunk_size_ref(void *chunk) noexcept;
+
+    static unsigned char *chunk_begin(void *chunk) noexcept;
+
+    static unsigned char *chunk_end(void *chunk) noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATOR_ARENA_H
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "../include/allocator_arena.h"
+
+allocator_arena::allocator_arena(
+    size_t chunk_size,
+    std::pmr::memory_resource *parent_allocator,
+    logger *logger):
+    _parent(parent_allocator == nullptr ? std::pmr::get_default_resource() : parent_allocator),
+    _logger(logger),
+    _chunk_size(std::max(chunk_size, chunk_metadata_size + alignof(std::max_align_t)))
+{
+    debug_with_guard(get_typename() + ": created with chunks of " + std::to_string(_chunk_size) + " bytes");
+}
+
+allocator_arena::allocator_arena(
+    allocator_arena &&other) noexcept:
+    _parent(other._parent),
+    _logger(other._logger),
+    _chunk_size(other._chunk_size),
+    _first_chunk(std::exchange(other._first_chunk, nullptr)),
+    _current_chunk(std::exchange(other._current_chunk, nullptr)),
+    _spare_chunks(std::exchange(other._spare_chunks, nullptr)),
+    _top(std::exchange(other._top, nullptr)),
+    _end(std::exchange(other._end, nullptr))
+{
+}
+
+allocator_arena &allocator_arena::operator=(
+    allocator_arena &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+
+        _parent = other._parent;
+        _logger = other._logger;
+        _chunk_size = other._chunk_size;
+        _first_chunk = std::exchange(other._first_chunk, nullptr);
+        _current_chunk = std::exchange(other._current_chunk, nullptr);
+        _spare_chunks = std::exchange(other._spare_chunks, nullptr);
+        _top = std::exchange(other._top, nullptr);
+        _end = std::exchange(other._end, nullptr);
+    }
+
+    return *this;
+}
+
+allocator_arena::~allocator_arena()
+{
+    release();
+
+    debug_with_guard(get_typename() + ": destroyed");
+}
+
+[[nodiscard]] void *allocator_arena::do_allocate_sm(
+    size_t size)
+{
+    return do_allocate_sm(size, alignof(std::max_align_t));
+}
+
+void allocator_arena::do_deallocate_sm(
+    void *)
+{
+}
+
+[[nodiscard]] void *allocator_arena::do_allocate_sm(
+    size_t size,
+    size_t alignment)
+{
+    // every block starts at least at alignof(std::max_align_t), as smart_mem_resource requires
+    alignment = std::max(alignment, alignof(std::max_align_t));
+
+    void *block = bump(size, alignment);
+
+    return block != nullptr ? block : allocate_in_new_chunk(size, alignment);
+}
+
+void allocator_arena::do_deallocate_sm(
+    void *,
+    size_t)
+{
+}
+
+bool allocator_arena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+void allocator_arena::reset() noexcept
+{
+    rewind(nullptr, nullptr);
+}
+
+void allocator_arena::release() noexcept
+{
+    reset();
+
+    while (_spare_chunks != nullptr)
+    {
+        void *chunk = _spare_chunks;
+
+        _spare_chunks = chunk_next_ref(chunk);
+        _parent->deallocate(chunk, chunk_size_ref(chunk), alignof(std::max_align_t));
+    }
+}
+
+size_t allocator_arena::chunks_count() const noexcept
+{
+    size_t count = 0;
+
+    for (void *chunk = _first_chunk; chunk != nullptr; chunk = chunk_next_ref(chunk))
+    {
+        ++count;
+    }
+
+    for (void *chunk = _spare_chunks; chunk != nullptr; chunk = chunk_next_ref(chunk))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+void *allocator_arena::bump(
+    size_t size,
+    size_t alignment) noexcept
+{
+    if (_top == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto address = reinterpret_cast<uintptr_t>(_top);
+    auto *aligned = _top + ((alignment - address % alignment) % alignment);
+
+    if (aligned > _end || size > static_cast<size_t>(_end - aligned))
+    {
+        return nullptr;
+    }
+
+    _top = aligned + size;
+
+    return aligned;
+}
+
+void *allocator_arena::allocate_in_new_chunk(
+    size_t size,
+    size_t alignment)
+{
+    if (size > std::numeric_limits<size_t>::max() - chunk_metadata_size - alignment)
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        throw std::bad_alloc();
+    }
+
+    // alignment above alignof(std::max_align_t) may need up to alignment bytes of padding after chunk header
+    size_t need = chunk_metadata_size + size + (alignment - alignof(std::max_align_t));
+    void **link = &_spare_chunks;
+
+    while (*link != nullptr && chunk_size_ref(*link) < need)
+    {
+        link = &chunk_next_ref(*link);
+    }
+
+    void *chunk = *link;
+
+    if (chunk != nullptr)
+    {
+        *link = chunk_next_ref(chunk);
+    }
+    else
+    {
+        size_t chunk_size = std::max(_chunk_size, need);
+
+        try
+        {
+            chunk = _parent->allocate(chunk_size, alignof(std::max_align_t));
+        }
+        catch (std::bad_alloc const &)
+        {
+            error_with_guard(get_typename() + ": can't allocate chunk of " + std::to_string(chunk_size) + " bytes");
+            throw;
+        }
+
+        chunk_size_ref(chunk) = chunk_size;
+
+        trace_with_guard([&] { return get_typename() + ": got chunk of " + std::to_string(chunk_size) + " bytes from parent allocator"; });
+    }
+
+    chunk_next_ref(chunk) = nullptr;
+
+    if (_current_chunk != nullptr)
+    {
+        chunk_next_ref(_current_chunk) = chunk;
+    }
+    else
+    {
+        _first_chunk = chunk;
+    }
+
+    _current_chunk = chunk;
+    _top = chunk_begin(chunk);
+    _end = chunk_end(chunk);
+
+    return bump(size, alignment);
+}
+
+void allocator_arena::rewind(
+    void *chunk,
+    unsigned char *top) noexcept
+{
+    void *dropped = chunk == nullptr ? _first_chunk : chunk_next_ref(chunk);
+
+    if (dropped != nullptr)
+    {
+        chunk_next_ref(_current_chunk) = _spare_chunks;
+        _spare_chunks = dropped;
+    }
+
+    if (chunk == nullptr)
+    {
+        _first_chunk = nullptr;
+        _current_chunk = nullptr;
+        _top = nullptr;
+        _end = nullptr;
+        return;
+    }
+
+    chunk_next_ref(chunk) = nullptr;
+    _current_chunk = chunk;
+    _top = top;
+    _end = chunk_end(chunk);
+}
+
+void *&allocator_arena::chunk_next_ref(void *chunk) noexcept
+{
+    return *reinterpret_cast<void **>(chunk);
+}
+
+size_t &allocator_arena::chunk_size_ref(void *chunk) noexcept
+{
+    return *reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(chunk) + sizeof(void *));
+}
+
+unsigned char *allocator_arena::chunk_begin(void *chunk) noexcept
+{
+    return reinterpret_cast<unsigned char *>(chunk) + chunk_metadata_size;
+}
+
+unsigned char *allocator_arena::chunk_end(void *chunk) noexcept
+{
+    return reinterpret_cast<unsigned char *>(chunk) + chunk_size_ref(chunk);
+}
+
+inline logger *allocator_arena::get_logger() const
+{
+    return _logger;
+}
+
+inline std::string allocator_arena::get_typename() const
+{
+    return "allocator_arena";
+}
+
+allocator_arena::scope::scope(
+    allocator_arena &arena) noexcept:
+    _arena(&arena),
+    _chunk(arena._current_chunk),
+    _top(arena._top)
+{
+}
+
+allocator_arena::scope::~scope() noexcept
+{
+    _arena->rewind(_chunk, _top);
+}
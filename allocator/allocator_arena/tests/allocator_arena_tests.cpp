@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <allocator_arena.h>
+#include <allocator_test_utils.h>
+#include <cstring>
+#include <list>
+#include <set>
+#include <vector>
+
+class counting_mem_resource final : public std::pmr::memory_resource
+{
+
+public:
+
+    size_t allocations = 0;
+
+    size_t deallocations = 0;
+
+private:
+
+    void *do_allocate(size_t size, size_t alignment) override
+    {
+        ++allocations;
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void do_deallocate(void *at, size_t, size_t alignment) override
+    {
+        ++deallocations;
+        ::operator delete(at, std::align_val_t(alignment));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(allocatorArenaPositiveTests, test1)
+{
+    counting_mem_resource parent;
+
+    {
+        allocator_arena arena(1024, &parent);
+        std::vector<unsigned char *> blocks;
+
+        for (size_t i = 0; i < 100; ++i)
+        {
+            auto *block = reinterpret_cast<unsigned char *>(arena.allocate(i + 1));
+
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t), 0);
+
+            memset(block, static_cast<int>(i), i + 1);
+            blocks.push_back(block);
+        }
+
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            ASSERT_EQ(blocks[i][0], static_cast<unsigned char>(i));
+            ASSERT_EQ(blocks[i][i], static_cast<unsigned char>(i));
+
+            arena.deallocate(blocks[i], i + 1);
+        }
+
+        ASSERT_EQ(arena.chunks_count(), parent.allocations);
+        ASSERT_GT(parent.allocations, 1);
+        ASSERT_EQ(parent.deallocations, 0);
+    }
+
+    ASSERT_EQ(parent.deallocations, parent.allocations);
+}
+
+TEST(allocatorArenaPositiveTests, test2)
+{
+    counting_mem_resource parent;
+    allocator_arena arena(4096, &parent);
+
+    auto fill = [&arena]
+    {
+        std::set<void *> blocks;
+
+        for (size_t i = 0; i < 200; ++i)
+        {
+            blocks.insert(arena.allocate(64));
+        }
+
+        return blocks;
+    };
+
+    auto first = fill();
+    size_t chunks = parent.allocations;
+
+    arena.reset();
+
+    auto second = fill();
+
+    ASSERT_EQ(parent.allocations, chunks);
+    ASSERT_EQ(first, second);
+
+    arena.release();
+
+    ASSERT_EQ(arena.chunks_count(), 0);
+    ASSERT_EQ(parent.deallocations, chunks);
+}
+
+TEST(allocatorArenaPositiveTests, test3)
+{
+    counting_mem_resource parent;
+    allocator_arena arena(1024, &parent);
+
+    void *kept = arena.allocate(100);
+    void *inner_first;
+
+    {
+        allocator_arena::scope outer(arena);
+        void *outer_first = arena.allocate(100);
+
+        {
+            allocator_arena::scope inner(arena);
+
+            inner_first = arena.allocate(100);
+
+            for (size_t i = 0; i < 50; ++i)
+            {
+                ASSERT_NE(arena.allocate(100), kept);
+            }
+        }
+
+        ASSERT_EQ(arena.allocate(100), inner_first);
+        ASSERT_NE(outer_first, kept);
+    }
+
+    size_t chunks = parent.allocations;
+
+    ASSERT_NE(arena.allocate(100), kept);
+    ASSERT_EQ(parent.allocations, chunks);
+}
+
+TEST(allocatorArenaPositiveTests, test4)
+{
+    allocator_arena arena(1024);
+
+    ASSERT_EQ(allocator_test_utils::check_alignments(arena), "");
+
+    auto *large = reinterpret_cast<unsigned char *>(arena.allocate(1 << 16));
+    memset(large, 1, 1 << 16);
+
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(arena.allocate(1)) % alignof(std::max_align_t), 0);
+}
+
+TEST(allocatorArenaPositiveTests, test5)
+{
+    allocator_arena first_arena;
+    allocator_arena second_arena;
+
+    std::list<int, pp_allocator<int>> first{ pp_allocator<int>(&first_arena) };
+    std::list<int, pp_allocator<int>> second{ pp_allocator<int>(&second_arena) };
+
+    for (int i = 0; i < 10; ++i)
+    {
+        first.push_back(i);
+        second.push_back(-i);
+    }
+
+    second = std::move(first);
+
+    ASSERT_EQ(second.get_allocator().resource(), &first_arena);
+    ASSERT_EQ(second.size(), 10);
+    ASSERT_EQ(second.back(), 9);
+}
+
+TEST(allocatorArenaPositiveTests, test6)
+{
+    allocator_arena arena;
+    void *block = arena.allocate(100);
+
+    allocator_arena moved(std::move(arena));
+
+    ASSERT_EQ(moved.chunks_count(), 1);
+    ASSERT_EQ(arena.chunks_count(), 0);
+    ASSERT_GT(moved.allocate(100), block);
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,262 @@
+#include <allocator_boundary_tags.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Previous allocator_boundary_tags: address ordered list of occupied blocks, free space is the gaps between them,
+ * so every allocation walks the whole heap.
+ */
+class linear_boundary_tags final : public smart_mem_resource, public allocator_with_fit_mode
+{
+    struct block
+    {
+        size_t size;
+        block *prev;
+        block *next;
+        void *trusted;
+    };
+
+    std::vector<unsigned char> _space;
+
+    block *_first = nullptr;
+
+    fit_mode _mode;
+
+public:
+
+    linear_boundary_tags(size_t space_size, fit_mode mode):
+        _space(space_size),
+        _mode(mode)
+    {
+    }
+
+    void set_fit_mode(fit_mode mode) override
+    {
+        _mode = mode;
+    }
+
+    std::pair<size_t, size_t> free_and_largest_free()
+    {
+        size_t free = 0, largest = 0;
+        block *prev = nullptr;
+
+        do
+        {
+            size_t gap = gap_end(prev) - gap_begin(prev);
+            free += gap;
+            largest = std::max(largest, gap);
+            prev = prev == nullptr ? _first : prev->next;
+        }
+        while (prev != nullptr);
+
+        return { free, largest };
+    }
+
+private:
+
+    unsigned char *gap_begin(block *prev)
+    {
+        return prev == nullptr ? _space.data() : reinterpret_cast<unsigned char *>(prev + 1) + prev->size;
+    }
+
+    unsigned char *gap_end(block *prev)
+    {
+        block *next = prev == nullptr ? _first : prev->next;
+
+        return next == nullptr ? _space.data() + _space.size() : reinterpret_cast<unsigned char *>(next);
+    }
+
+    void *do_allocate_sm(size_t size) override
+    {
+        size = (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        block *chosen_prev = nullptr, *prev = nullptr;
+        size_t chosen_gap = 0;
+        bool found = false;
+
+        do
+        {
+            size_t gap = gap_end(prev) - gap_begin(prev);
+
+            if (gap >= sizeof(block) + size
+                && (!found || (_mode == fit_mode::the_best_fit && gap < chosen_gap) || (_mode == fit_mode::the_worst_fit && gap > chosen_gap)))
+            {
+                chosen_prev = prev;
+                chosen_gap = gap;
+                found = true;
+
+                if (_mode == fit_mode::first_fit)
+                {
+                    break;
+                }
+            }
+
+            prev = prev == nullptr ? _first : prev->next;
+        }
+        while (prev != nullptr);
+
+        if (!found)
+        {
+            throw std::bad_alloc();
+        }
+
+        auto *result = reinterpret_cast<block *>(gap_begin(chosen_prev));
+        block *next = chosen_prev == nullptr ? _first : chosen_prev->next;
+
+        *result = { size, chosen_prev, next, this };
+        (chosen_prev == nullptr ? _first : chosen_prev->next) = result;
+
+        if (next != nullptr)
+        {
+            next->prev = result;
+        }
+
+        return result + 1;
+    }
+
+    void do_deallocate_sm(void *at) override
+    {
+        block *b = reinterpret_cast<block *>(at) - 1;
+
+        (b->prev == nullptr ? _first : b->prev->next) = b->next;
+
+        if (b->next != nullptr)
+        {
+            b->next->prev = b->prev;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+struct run_result
+{
+    double ops_per_second;
+    size_t failures;
+    size_t free;
+    size_t largest_free;
+};
+
+/**
+ * Keeps the heap around half full with blocks of mixed sizes, so both allocators work on a fragmented heap
+ */
+template<typename resource, typename free_info>
+run_result run(resource &subject, size_t space_size, size_t operations_count, free_info const &get_free_info)
+{
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<size_t> small_distribution(8, 256);
+    std::uniform_int_distribution<size_t> large_distribution(256, 4096);
+    std::vector<void *> blocks;
+    size_t live = 0, failures = 0;
+    std::vector<size_t> sizes;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < operations_count; ++i)
+    {
+        if (blocks.empty() || generator() % 4 < (live < space_size / 2 ? 3 : 1))
+        {
+            size_t size = generator() % 8 == 0 ? large_distribution(generator) : small_distribution(generator);
+
+            try
+            {
+                blocks.push_back(subject.allocate(size));
+                sizes.push_back(size);
+                live += size;
+            }
+            catch (std::bad_alloc const &)
+            {
+                ++failures;
+            }
+        }
+        else
+        {
+            size_t index = generator() % blocks.size();
+
+            std::swap(blocks[index], blocks.back());
+            std::swap(sizes[index], sizes.back());
+            subject.deallocate(blocks.back(), sizes.back());
+            live -= sizes.back();
+            blocks.pop_back();
+            sizes.pop_back();
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    auto [free, largest_free] = get_free_info();
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        subject.deallocate(blocks[i], sizes[i]);
+    }
+
+    return { static_cast<double>(operations_count) / elapsed.count(), failures, free, largest_free };
+}
+
+void print(std::string const &name, run_result const &result)
+{
+    double fragmentation = result.free == 0 ? 0 : 1 - static_cast<double>(result.largest_free) / static_cast<double>(result.free);
+
+    std::cout << std::setw(28) << name
+              << std::setw(16) << std::fixed << std::setprecision(0) << result.ops_per_second
+              << std::setw(12) << result.failures
+              << std::setw(16) << std::setprecision(3) << fragmentation << std::endl;
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    size_t space_size = argc > 1 ? std::stoul(argv[1]) : size_t(1) << 22;
+    size_t operations_count = argc > 2 ? std::stoul(argv[2]) : 200'000;
+
+    std::cout << std::setw(28) << "allocator"
+              << std::setw(16) << "ops/sec"
+              << std::setw(12) << "failures"
+              << std::setw(16) << "fragmentation" << std::endl;
+
+    std::pair<allocator_with_fit_mode::fit_mode, std::string> const modes[] =
+        {
+            { allocator_with_fit_mode::fit_mode::first_fit, "first fit" },
+            { allocator_with_fit_mode::fit_mode::the_best_fit, "best fit" },
+            { allocator_with_fit_mode::fit_mode::the_worst_fit, "worst fit" }
+        };
+
+    for (auto const &[mode, mode_name] : modes)
+    {
+        linear_boundary_tags linear(space_size, mode);
+
+        print("linear, " + mode_name, run(linear, space_size, operations_count, [&linear]()
+        {
+            return linear.free_and_largest_free();
+        }));
+
+        allocator_boundary_tags segregated(space_size, nullptr, nullptr, mode);
+
+        print("segregated, " + mode_name, run(segregated, space_size, operations_count, [&segregated]()
+        {
+            size_t free = 0, largest_free = 0;
+
+            for (auto const &block : segregated.get_blocks_info())
+            {
+                if (!block.is_block_occupied)
+                {
+                    free += block.block_size;
+                    largest_free = std::max(largest_free, block.block_size);
+                }
+            }
+
+            return std::pair{ free, largest_free };
+        }));
+    }
+
+    return 0;
+}
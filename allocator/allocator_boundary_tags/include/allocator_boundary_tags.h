@@ -2,17 +2,24 @@
 #define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATOR_BOUNDARY_TAGS_H
 
 #include <allocator_test_utils.h>
+#include <allocator_with_statistics.h>
 #include <allocator_with_fit_mode.h>
+#include <allocator_with_compaction.h>
 #include <pp_allocator.h>
 #include <logger_guardant.h>
 #include <typename_holder.h>
+#include <array>
+#include <cstdint>
 #include <iterator>
 #include <mutex>
+#include <string>
 
 class allocator_boundary_tags final :
     public smart_mem_resource,
     public allocator_test_utils,
     public allocator_with_fit_mode,
+    public allocator_with_statistics,
+    public allocator_with_compaction,
     private logger_guardant,
     private typename_holder
 {
@@ -20,14 +27,53 @@ class allocator_boundary_tags final :
 private:
 
     /**
-     * TODO: You must improve it for alignment support
+     * Every block starts with a tag of its total size and occupancy flags, free blocks also end with a footer
+     * holding their size, so both physical neighbours of a block are found in O(1).
+     * Free blocks are threaded into segregated lists: list k holds blocks with total size in [16 * 2^k, 16 * 2^(k+1)),
+     * bit k of free classes bitmap is set iff list k is not empty
      */
-    static constexpr const size_t allocator_metadata_size = sizeof(logger*) + sizeof(memory_resource*) + sizeof(allocator_with_fit_mode::fit_mode) +
-                                                            sizeof(size_t) + sizeof(std::mutex) + sizeof(void*);
+    static constexpr const size_t free_classes_count = sizeof(uint64_t) * 8;
 
-    static constexpr const size_t occupied_block_metadata_size = sizeof(size_t) + sizeof(void*) + sizeof(void*) + sizeof(void*);
+    static constexpr const size_t free_list_heads_offset = sizeof(logger*) + sizeof(memory_resource*) + sizeof(size_t) + sizeof(std::mutex) + sizeof(uint64_t) +
+                                                           (sizeof(allocator_with_fit_mode::fit_mode) + alignof(size_t) - 1) / alignof(size_t) * alignof(size_t);
 
-    static constexpr const size_t free_block_metadata_size = 0;
+    /**
+     * Rounded up to alignof(std::max_align_t), so first block of space starts aligned
+     */
+    static constexpr const size_t allocator_metadata_size = (free_list_heads_offset + sizeof(size_t) * free_classes_count + alignof(std::max_align_t) - 1) /
+                                                            alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    /**
+     * Size tag, two offsets used as free list links while block is free, offset of the block itself
+     */
+    static constexpr const size_t occupied_block_metadata_size = 4 * sizeof(size_t);
+
+    /**
+     * Footer of the smallest free block overlaps offset word of its header
+     */
+    static constexpr const size_t free_block_metadata_size = occupied_block_metadata_size;
+
+    static constexpr const size_t occupied_flag = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+    static constexpr const size_t prev_occupied_flag = occupied_flag >> 1;
+
+    /**
+     * Persistent heap file starts with this header, trusted memory follows it.
+     * Heap is marked clean only while no process has it attached
+     */
+    struct mapping_header
+    {
+        std::array<char, 8> magic;
+        uint64_t space_size;
+        uint64_t root;
+        void *base;
+        int descriptor;
+        uint32_t clean;
+    };
+
+    static constexpr const size_t mapping_header_size = (sizeof(mapping_header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    static constexpr const std::array<char, 8> mapping_magic = { 'M', 'P', 'O', 'S', 'B', 'T', 'H', '1' };
 
     void *_trusted_memory;
 
@@ -35,9 +81,9 @@ public:
     
     ~allocator_boundary_tags() override;
     
-    allocator_boundary_tags(allocator_boundary_tags const &other);
+    allocator_boundary_tags(allocator_boundary_tags const &other) = delete;
     
-    allocator_boundary_tags &operator=(allocator_boundary_tags const &other);
+    allocator_boundary_tags &operator=(allocator_boundary_tags const &other) = delete;
     
     allocator_boundary_tags(
         allocator_boundary_tags &&other) noexcept;
@@ -53,6 +99,23 @@ public:
             logger *logger = nullptr,
             allocator_with_fit_mode::fit_mode allocate_fit_mode = allocator_with_fit_mode::fit_mode::first_fit);
 
+    /**
+     * Heap kept in memory mapped file. If file holds a heap that was detached cleanly, it is attached with all its
+     * blocks and space_size is ignored, if file is empty or does not exist, a new heap of space_size bytes is made in it.
+     * Links inside the heap are offsets, so it works wherever the file is mapped. The address of the previous mapping
+     * is requested, so raw pointers kept by containers living in the heap stay valid when the system grants it.
+     * File is locked while attached. Throws std::runtime_error on file errors, for files that are not heaps,
+     * and for heaps that were not detached cleanly unless recover is set.
+     * Recovery walks the size tags, keeps occupied blocks whose header is intact and makes everything else free,
+     * it throws std::runtime_error if the tags do not cover the space exactly
+     */
+    allocator_boundary_tags(
+            std::string const &file_path,
+            size_t space_size,
+            logger *logger = nullptr,
+            allocator_with_fit_mode::fit_mode allocate_fit_mode = allocator_with_fit_mode::fit_mode::first_fit,
+            bool recover = false);
+
 public:
     
     [[nodiscard]] void *do_allocate_sm(
@@ -61,6 +124,14 @@ public:
     void do_deallocate_sm(
         void *at) override;
 
+    [[nodiscard]] void *do_allocate_sm(
+        size_t bytes,
+        size_t alignment) override;
+
+    void do_deallocate_sm(
+        void *at,
+        size_t alignment) override;
+
     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
 
 public:
@@ -72,16 +143,170 @@ public:
     
     std::vector<allocator_test_utils::block_info> get_blocks_info() const override;
 
+public:
+
+    /**
+     * Largest free block is looked up here under the lock, so allocation and deallocation don't scan free lists
+     */
+    statistics get_statistics() const noexcept override;
+
+public:
+
+    /**
+     * Segregated lists are rebuilt from the free blocks left between unmovable blocks.
+     * Links are offsets, so persistent heaps are compacted in place as well
+     */
+    size_t compact(
+        relocation_listener &listener) override;
+
+public:
+
+    bool is_persistent() const noexcept;
+
+    /**
+     * Root object of persistent heap, the way to find data again after re-attaching.
+     * Throws std::logic_error for heaps not backed by a file
+     */
+    void set_root(
+        void *root);
+
+    void *get_root() const;
+
+    /**
+     * Position of a block inside the heap, stays the same when persistent heap is mapped at another address
+     */
+    size_t to_offset(
+        void const *at) const noexcept;
+
+    void *from_offset(
+        size_t offset) const noexcept;
+
 private:
 
     std::vector<allocator_test_utils::block_info> get_blocks_info_inner() const override;
 
-/** TODO: Highly recommended for helper functions to return references */
-
     inline logger *get_logger() const override;
 
     inline std::string get_typename() const noexcept override;
 
+    void destroy() noexcept;
+
+    /**
+     * Fills header fields that are kept in trusted memory and makes the whole space a single free block
+     */
+    void format(
+        size_t space_size,
+        std::pmr::memory_resource *parent_allocator,
+        logger *logger,
+        allocator_with_fit_mode::fit_mode allocate_fit_mode) noexcept;
+
+    mapping_header &mapping_header_ref() const noexcept;
+
+    /**
+     * Checks that size tags chain through the whole space, then rewrites flags, footers and segregated lists.
+     * Occupied block with wrong offset word was being allocated or freed when the process died, so it becomes free.
+     * Returns count of such blocks, or nothing is changed and space_size + 1 is returned if tags are broken
+     */
+    size_t rebuild() noexcept;
+
+    /**
+     * Places block with payload aligned by alignment into the free block chosen by current fit mode.
+     * Payload size is rounded up to alignof(std::max_align_t), so blocks placed right after it stay aligned too
+     */
+    void *allocate_inner(
+        size_t size,
+        size_t alignment);
+
+    /**
+     * Looks only into the class of requested size and, if nothing fits there, into the nearest non empty greater classes
+     */
+    void *find_free(
+        size_t size,
+        size_t alignment) const noexcept;
+
+    /**
+     * Returns payload of block with given size and alignment placed into free block, or nullptr if it does not fit.
+     * Space skipped before the block is either empty or big enough to stay free
+     */
+    static unsigned char *place(
+        void *free_block,
+        size_t size,
+        size_t alignment) noexcept;
+
+    static size_t free_class(size_t block_size) noexcept;
+
+    /**
+     * Records free bytes only, largest free block is left to get_statistics
+     */
+    void publish_free_space() noexcept;
+
+    /**
+     * Largest free block is in the greatest non empty class, so only that list is scanned
+     */
+    size_t largest_free_block() const noexcept;
+
+    void push_free(void *block) noexcept;
+
+    void erase_free(void *block) noexcept;
+
+    /**
+     * Makes [at, at + size) a free block, updates footer and flag of the next block
+     */
+    void *make_free(void *at, size_t size, bool prev_occupied) noexcept;
+
+    static logger *&logger_ref(void *trusted) noexcept;
+
+    static std::pmr::memory_resource *&parent_ref(void *trusted) noexcept;
+
+    static size_t &space_size_ref(void *trusted) noexcept;
+
+    static std::mutex &mutex_ref(void *trusted) noexcept;
+
+    static uint64_t &free_classes_ref(void *trusted) noexcept;
+
+    static fit_mode &fit_mode_ref(void *trusted) noexcept;
+
+    static size_t &free_list_head_ref(void *trusted, size_t k) noexcept;
+
+    static void *space_begin(void *trusted) noexcept;
+
+    static void *space_end(void *trusted) noexcept;
+
+    static size_t &block_tag_ref(void *block) noexcept;
+
+    static size_t block_size(void *block) noexcept;
+
+    static bool block_occupied(void *block) noexcept;
+
+    static bool block_prev_occupied(void *block) noexcept;
+
+    static size_t &block_prev_free_ref(void *block) noexcept;
+
+    static size_t &block_next_free_ref(void *block) noexcept;
+
+    /**
+     * Offset of occupied block itself, checked on deallocation. Zeroed when block becomes free
+     */
+    static size_t &block_offset_ref(void *block) noexcept;
+
+    /**
+     * Links inside trusted memory are offsets from its start, 0 stands for no block.
+     * They stay valid wherever trusted memory is mapped
+     */
+    static void *block_at(void *trusted, size_t offset) noexcept;
+
+    static size_t offset_of(void *trusted, void const *block) noexcept;
+
+    static void *block_end(void *block) noexcept;
+
+    /**
+     * Footer is omitted for the last block of space, nobody looks behind it
+     */
+    static void set_footer(void *trusted, void *block) noexcept;
+
+    /**
+     * Walks all blocks in address order
+     */
     class boundary_iterator
     {
         void* _occupied_ptr;
@@ -1,21 +1,38 @@
-#include <not_implemented.h>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "../include/allocator_boundary_tags.h"
 
 allocator_boundary_tags::~allocator_boundary_tags()
 {
-    throw not_implemented("allocator_boundary_tags::~allocator_boundary_tags()", "your code should be here...");
+    destroy();
 }
 
 allocator_boundary_tags::allocator_boundary_tags(
-    allocator_boundary_tags &&other) noexcept
+    allocator_boundary_tags &&other) noexcept:
+    allocator_with_statistics(std::move(other)),
+    _trusted_memory(other._trusted_memory)
 {
-    throw not_implemented("allocator_boundary_tags::allocator_boundary_tags(allocator_boundary_tags &&) noexcept", "your code should be here...");
+    other._trusted_memory = nullptr;
 }
 
 allocator_boundary_tags &allocator_boundary_tags::operator=(
     allocator_boundary_tags &&other) noexcept
 {
-    throw not_implemented("allocator_boundary_tags &allocator_boundary_tags::operator=(allocator_boundary_tags &&) noexcept", "your code should be here...");
+    if (this != &other)
+    {
+        destroy();
+        allocator_with_statistics::operator=(std::move(other));
+        _trusted_memory = other._trusted_memory;
+        other._trusted_memory = nullptr;
+    }
+
+    return *this;
 }
 
 
@@ -27,132 +44,959 @@ allocator_boundary_tags::allocator_boundary_tags(
         logger *logger,
         allocator_with_fit_mode::fit_mode allocate_fit_mode)
 {
-    throw not_implemented("allocator_boundary_tags::allocator_boundary_tags(size_t,std::pmr::memory_resource *,logger *,allocator_with_fit_mode::fit_mode)", "your code should be here...");
+    if (space_size < occupied_block_metadata_size)
+    {
+        throw std::logic_error("allocator_boundary_tags: space size must hold at least one block metadata");
+    }
+
+    if (parent_allocator == nullptr)
+    {
+        parent_allocator = std::pmr::get_default_resource();
+    }
+
+    _trusted_memory = parent_allocator->allocate(allocator_metadata_size + space_size, alignof(std::max_align_t));
+
+    format(space_size, parent_allocator, logger, allocate_fit_mode);
+
+    debug_with_guard(get_typename() + ": created with " + std::to_string(space_size) + " bytes of space");
+}
+
+allocator_boundary_tags::allocator_boundary_tags(
+        std::string const &file_path,
+        size_t space_size,
+        logger *logger,
+        allocator_with_fit_mode::fit_mode allocate_fit_mode,
+        bool recover)
+{
+    int descriptor = open(file_path.c_str(), O_RDWR | O_CREAT, 0644);
+
+    if (descriptor == -1)
+    {
+        throw std::runtime_error("Cannot open file: " + file_path);
+    }
+
+    auto fail = [descriptor](std::string const &message)
+    {
+        close(descriptor);
+        throw std::runtime_error(message);
+    };
+
+    if (flock(descriptor, LOCK_EX | LOCK_NB) == -1)
+    {
+        fail("Heap file is attached by another allocator: " + file_path);
+    }
+
+    struct stat file_stat{};
+    mapping_header header{};
+
+    if (fstat(descriptor, &file_stat) == -1)
+    {
+        fail("Cannot stat file: " + file_path);
+    }
+
+    bool attach = file_stat.st_size != 0;
+
+    if (attach)
+    {
+        if (static_cast<size_t>(file_stat.st_size) < mapping_header_size + allocator_metadata_size
+            || pread(descriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+            || header.magic != mapping_magic
+            || static_cast<size_t>(file_stat.st_size) != mapping_header_size + allocator_metadata_size + header.space_size)
+        {
+            fail("Not a heap file: " + file_path);
+        }
+
+        if (header.clean == 0 && !recover)
+        {
+            fail("Heap was not detached cleanly: " + file_path);
+        }
+
+        space_size = header.space_size;
+    }
+    else
+    {
+        if (space_size < occupied_block_metadata_size)
+        {
+            close(descriptor);
+            throw std::logic_error("allocator_boundary_tags: space size must hold at least one block metadata");
+        }
+
+        if (ftruncate(descriptor, static_cast<off_t>(mapping_header_size + allocator_metadata_size + space_size)) == -1)
+        {
+            fail("Cannot resize file: " + file_path);
+        }
+    }
+
+    size_t mapping_size = mapping_header_size + allocator_metadata_size + space_size;
+    void *mapping = mmap(attach ? header.base : nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+        fail("Cannot map file: " + file_path);
+    }
+
+    _trusted_memory = reinterpret_cast<unsigned char *>(mapping) + mapping_header_size;
+
+    auto &mapped_header = mapping_header_ref();
+
+    if (attach)
+    {
+        logger_ref(_trusted_memory) = logger;
+        parent_ref(_trusted_memory) = nullptr;
+        new (&mutex_ref(_trusted_memory)) std::mutex();
+        fit_mode_ref(_trusted_memory) = allocate_fit_mode;
+
+        if (header.clean == 0)
+        {
+            space_size_ref(_trusted_memory) = space_size;
+
+            size_t dropped = rebuild();
+
+            if (dropped > space_size)
+            {
+                munmap(mapping, mapping_size);
+                _trusted_memory = nullptr;
+                fail("Heap is damaged beyond recovery: " + file_path);
+            }
+
+            warning_with_guard(get_typename() + ": recovered heap that was not detached cleanly, " + std::to_string(dropped) +
+                " blocks caught in the middle of allocation or deallocation are free now");
+        }
+
+        if (mapping != header.base)
+        {
+            warning_with_guard(get_typename() + ": heap is mapped at another address, raw pointers kept inside it are not valid");
+        }
+
+        for (auto it = begin(), last = end(); it != last; ++it)
+        {
+            if (it.occupied())
+            {
+                record_allocation(it.size() - occupied_block_metadata_size, it.size());
+            }
+        }
+
+        publish_free_space();
+    }
+    else
+    {
+        mapped_header.magic = mapping_magic;
+        mapped_header.space_size = space_size;
+        mapped_header.root = 0;
+
+        format(space_size, nullptr, logger, allocate_fit_mode);
+    }
+
+    mapped_header.base = mapping;
+    mapped_header.descriptor = descriptor;
+    mapped_header.clean = 0;
+
+    debug_with_guard(get_typename() + (attach ? ": attached " : ": created ") + file_path + " with " + std::to_string(space_size) + " bytes of space");
+}
+
+void allocator_boundary_tags::format(
+    size_t space_size,
+    std::pmr::memory_resource *parent_allocator,
+    logger *logger,
+    allocator_with_fit_mode::fit_mode allocate_fit_mode) noexcept
+{
+    logger_ref(_trusted_memory) = logger;
+    parent_ref(_trusted_memory) = parent_allocator;
+    space_size_ref(_trusted_memory) = space_size;
+    new (&mutex_ref(_trusted_memory)) std::mutex();
+    free_classes_ref(_trusted_memory) = 0;
+    fit_mode_ref(_trusted_memory) = allocate_fit_mode;
+
+    for (size_t k = 0; k < free_classes_count; ++k)
+    {
+        free_list_head_ref(_trusted_memory, k) = 0;
+    }
+
+    make_free(space_begin(_trusted_memory), space_size, true);
+    publish_free_space();
+}
+
+void allocator_boundary_tags::destroy() noexcept
+{
+    if (_trusted_memory == nullptr)
+    {
+        return;
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+
+    auto *parent = parent_ref(_trusted_memory);
+    size_t trusted_size = allocator_metadata_size + space_size_ref(_trusted_memory);
+
+    mutex_ref(_trusted_memory).~mutex();
+
+    if (parent == nullptr)
+    {
+        // mutex and logger are process local, they are rebuilt on the next attach
+        auto &header = mapping_header_ref();
+        int descriptor = header.descriptor;
+        void *mapping = &header;
+
+        msync(mapping, mapping_header_size + trusted_size, MS_SYNC);
+        header.clean = 1;
+        msync(mapping, mapping_header_size, MS_SYNC);
+        munmap(mapping, mapping_header_size + trusted_size);
+        close(descriptor);
+    }
+    else
+    {
+        parent->deallocate(_trusted_memory, trusted_size, alignof(std::max_align_t));
+    }
+
+    _trusted_memory = nullptr;
 }
 
 [[nodiscard]] void *allocator_boundary_tags::do_allocate_sm(
     size_t size)
 {
-    throw not_implemented("[[nodiscard]] void *allocator_boundary_tags::do_allocate_sm(size_t)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    return allocate_inner(size, alignof(std::max_align_t));
+}
+
+[[nodiscard]] void *allocator_boundary_tags::do_allocate_sm(
+    size_t size,
+    size_t alignment)
+{
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    return allocate_inner(size, std::max(alignment, alignof(std::max_align_t)));
+}
+
+void *allocator_boundary_tags::allocate_inner(
+    size_t size,
+    size_t alignment)
+{
+    if (size > space_size_ref(_trusted_memory))
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        record_failed_allocation(size);
+        throw std::bad_alloc();
+    }
+
+    size_t requested_size = size;
+
+    size = (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    auto *free_block = reinterpret_cast<unsigned char *>(find_free(size, alignment));
+
+    if (free_block == nullptr)
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        record_failed_allocation(requested_size);
+        throw std::bad_alloc();
+    }
+
+    auto *payload = place(free_block, size, alignment);
+    auto *block = payload - occupied_block_metadata_size;
+    auto *free_end = reinterpret_cast<unsigned char *>(block_end(free_block));
+    bool prev_occupied = block_prev_occupied(free_block);
+
+    erase_free(free_block);
+
+    size_t tail = free_end - payload - size;
+
+    if (tail < free_block_metadata_size)
+    {
+        size += tail;
+        tail = 0;
+    }
+
+    // headers are written from the end of the free block, so size tags chain through the space
+    // whenever the process dies and a heap backed by a file can be recovered
+    if (tail != 0)
+    {
+        make_free(payload + size, tail, true);
+    }
+    else if (free_end != space_end(_trusted_memory))
+    {
+        block_tag_ref(free_end) |= prev_occupied_flag;
+    }
+
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    block_tag_ref(block) = (occupied_block_metadata_size + size) | occupied_flag | (prev_occupied && block == free_block ? prev_occupied_flag : 0);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    block_offset_ref(block) = offset_of(_trusted_memory, block);
+
+    if (block != free_block)
+    {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        make_free(free_block, block - free_block, prev_occupied);
+    }
+
+    record_allocation(requested_size, block_size(block));
+    publish_free_space();
+
+    return payload;
+}
+
+void allocator_boundary_tags::publish_free_space() noexcept
+{
+    record_free_space(space_size_ref(_trusted_memory) - bytes_in_use(), 0);
+}
+
+size_t allocator_boundary_tags::largest_free_block() const noexcept
+{
+    uint64_t classes = free_classes_ref(_trusted_memory);
+    size_t largest = 0;
+
+    if (classes != 0)
+    {
+        for (void *block = block_at(_trusted_memory, free_list_head_ref(_trusted_memory, std::bit_width(classes) - 1)); block != nullptr;
+             block = block_at(_trusted_memory, block_next_free_ref(block)))
+        {
+            largest = std::max(largest, block_size(block));
+        }
+    }
+
+    return largest;
+}
+
+void *allocator_boundary_tags::find_free(
+    size_t size,
+    size_t alignment) const noexcept
+{
+    auto const mode = fit_mode_ref(_trusted_memory);
+    uint64_t classes = free_classes_ref(_trusted_memory) & (~uint64_t(0) << free_class(occupied_block_metadata_size + size));
+
+    while (classes != 0)
+    {
+        size_t k = mode == fit_mode::the_worst_fit ? std::bit_width(classes) - 1 : std::countr_zero(classes);
+        void *chosen = nullptr;
+
+        classes &= ~(uint64_t(1) << k);
+
+        for (void *block = block_at(_trusted_memory, free_list_head_ref(_trusted_memory, k)); block != nullptr;
+             block = block_at(_trusted_memory, block_next_free_ref(block)))
+        {
+            if (place(block, size, alignment) == nullptr)
+            {
+                continue;
+            }
+
+            if (mode == fit_mode::first_fit)
+            {
+                return block;
+            }
+
+            if (chosen == nullptr
+                || (mode == fit_mode::the_best_fit && block_size(block) < block_size(chosen))
+                || (mode == fit_mode::the_worst_fit && block_size(block) > block_size(chosen)))
+            {
+                chosen = block;
+            }
+        }
+
+        if (chosen != nullptr)
+        {
+            return chosen;
+        }
+    }
+
+    return nullptr;
+}
+
+unsigned char *allocator_boundary_tags::place(
+    void *free_block,
+    size_t size,
+    size_t alignment) noexcept
+{
+    auto begin = reinterpret_cast<uintptr_t>(free_block);
+    auto payload = (begin + occupied_block_metadata_size + alignment - 1) & ~(uintptr_t(alignment) - 1);
+
+    if (payload - occupied_block_metadata_size - begin != 0 && payload - occupied_block_metadata_size - begin < free_block_metadata_size)
+    {
+        payload += alignment;
+    }
+
+    if (payload - begin > block_size(free_block) || block_size(free_block) - (payload - begin) < size)
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<unsigned char *>(payload);
+}
+
+size_t allocator_boundary_tags::free_class(size_t block_size) noexcept
+{
+    return std::min<size_t>(std::bit_width(block_size / alignof(std::max_align_t)) - 1, free_classes_count - 1);
+}
+
+void allocator_boundary_tags::push_free(void *block) noexcept
+{
+    size_t k = free_class(block_size(block));
+    size_t &head = free_list_head_ref(_trusted_memory, k);
+    size_t offset = offset_of(_trusted_memory, block);
+
+    block_prev_free_ref(block) = 0;
+    block_next_free_ref(block) = head;
+
+    if (head != 0)
+    {
+        block_prev_free_ref(block_at(_trusted_memory, head)) = offset;
+    }
+
+    head = offset;
+    free_classes_ref(_trusted_memory) |= uint64_t(1) << k;
+}
+
+void allocator_boundary_tags::erase_free(void *block) noexcept
+{
+    size_t k = free_class(block_size(block));
+    size_t prev = block_prev_free_ref(block);
+    size_t next = block_next_free_ref(block);
+
+    (prev == 0 ? free_list_head_ref(_trusted_memory, k) : block_next_free_ref(block_at(_trusted_memory, prev))) = next;
+
+    if (next != 0)
+    {
+        block_prev_free_ref(block_at(_trusted_memory, next)) = prev;
+    }
+
+    if (free_list_head_ref(_trusted_memory, k) == 0)
+    {
+        free_classes_ref(_trusted_memory) &= ~(uint64_t(1) << k);
+    }
+}
+
+void *allocator_boundary_tags::make_free(void *at, size_t size, bool prev_occupied) noexcept
+{
+    block_tag_ref(at) = size | (prev_occupied ? prev_occupied_flag : 0);
+    set_footer(_trusted_memory, at);
+    push_free(at);
+
+    void *next = block_end(at);
+
+    if (next != space_end(_trusted_memory))
+    {
+        block_tag_ref(next) &= ~prev_occupied_flag;
+    }
+
+    return at;
 }
 
 void allocator_boundary_tags::do_deallocate_sm(
     void *at)
 {
-    throw not_implemented("void allocator_boundary_tags::do_deallocate_sm(void *)", "your code should be here...");
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    auto *block = reinterpret_cast<unsigned char *>(at) - occupied_block_metadata_size;
+
+    if (block < space_begin(_trusted_memory) || block >= space_end(_trusted_memory)
+        || !block_occupied(block) || block_offset_ref(block) != offset_of(_trusted_memory, block))
+    {
+        error_with_guard(get_typename() + ": pointer does not belong to allocated block");
+        throw std::logic_error("allocator_boundary_tags: pointer does not belong to allocated block");
+    }
+
+    unsigned char *begin = block;
+    size_t size = block_size(block);
+    bool prev_occupied = block_prev_occupied(block);
+    auto *next = reinterpret_cast<unsigned char *>(block_end(block));
+
+    block_offset_ref(block) = 0;
+    record_deallocation(size);
+
+    if (next != space_end(_trusted_memory) && !block_occupied(next))
+    {
+        size += block_size(next);
+        erase_free(next);
+    }
+
+    if (!prev_occupied)
+    {
+        size_t prev_size = *reinterpret_cast<size_t *>(block - sizeof(size_t));
+
+        begin = block - prev_size;
+        size += prev_size;
+        prev_occupied = block_prev_occupied(begin);
+        erase_free(begin);
+    }
+
+    make_free(begin, size, prev_occupied);
+    publish_free_space();
+}
+
+void allocator_boundary_tags::do_deallocate_sm(
+    void *at,
+    size_t alignment)
+{
+    do_deallocate_sm(at);
 }
 
 inline void allocator_boundary_tags::set_fit_mode(
     allocator_with_fit_mode::fit_mode mode)
 {
-    throw not_implemented("inline void allocator_boundary_tags::set_fit_mode(allocator_with_fit_mode::fit_mode)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    fit_mode_ref(_trusted_memory) = mode;
 }
 
 
 std::vector<allocator_test_utils::block_info> allocator_boundary_tags::get_blocks_info() const
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_boundary_tags::get_blocks_info() const", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    return get_blocks_info_inner();
+}
+
+allocator_with_statistics::statistics allocator_boundary_tags::get_statistics() const noexcept
+{
+    auto result = allocator_with_statistics::get_statistics();
+
+    if (_trusted_memory != nullptr)
+    {
+        std::lock_guard lock(mutex_ref(_trusted_memory));
+
+        result.free_bytes = space_size_ref(_trusted_memory) - bytes_in_use();
+        result.largest_free_block = largest_free_block();
+    }
+
+    return result;
+}
+
+size_t allocator_boundary_tags::compact(
+    relocation_listener &listener)
+{
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    auto *end = reinterpret_cast<unsigned char *>(space_end(_trusted_memory));
+    auto *block = reinterpret_cast<unsigned char *>(space_begin(_trusted_memory));
+    auto *cursor = block;
+    bool prev_occupied = true;
+    size_t moved_count = 0;
+
+    free_classes_ref(_trusted_memory) = 0;
+
+    for (size_t k = 0; k < free_classes_count; ++k)
+    {
+        free_list_head_ref(_trusted_memory, k) = 0;
+    }
+
+    // free space between two unmovable blocks is a sum of whole free blocks, so it is big enough to be a free block again
+    while (block != end)
+    {
+        auto *next = reinterpret_cast<unsigned char *>(block_end(block));
+        size_t size = next - block;
+
+        if (!block_occupied(block))
+        {
+            block = next;
+            continue;
+        }
+
+        if (listener.is_movable(block + occupied_block_metadata_size))
+        {
+            if (cursor != block)
+            {
+                std::memmove(cursor, block, size);
+                block_offset_ref(cursor) = offset_of(_trusted_memory, cursor);
+                listener.on_moved(block + occupied_block_metadata_size, cursor + occupied_block_metadata_size);
+                ++moved_count;
+            }
+
+            block_tag_ref(cursor) = size | occupied_flag | (prev_occupied ? prev_occupied_flag : 0);
+            cursor += size;
+        }
+        else
+        {
+            if (cursor != block)
+            {
+                make_free(cursor, block - cursor, prev_occupied);
+            }
+            else
+            {
+                block_tag_ref(block) = size | occupied_flag | (prev_occupied ? prev_occupied_flag : 0);
+            }
+
+            cursor = next;
+        }
+
+        prev_occupied = true;
+        block = next;
+    }
+
+    if (cursor != end)
+    {
+        make_free(cursor, end - cursor, prev_occupied);
+    }
+
+    publish_free_space();
+    debug_with_guard(get_typename() + ": compacted, " + std::to_string(moved_count) + " blocks moved");
+
+    return moved_count;
+}
+
+size_t allocator_boundary_tags::rebuild() noexcept
+{
+    auto *end = reinterpret_cast<unsigned char *>(space_end(_trusted_memory));
+    auto *block = reinterpret_cast<unsigned char *>(space_begin(_trusted_memory));
+
+    // the whole chain is checked before anything is written, so a broken heap is left as it was
+    while (block != end)
+    {
+        size_t size = block_size(block);
+
+        if (size < free_block_metadata_size || size % alignof(std::max_align_t) != 0 || size > static_cast<size_t>(end - block))
+        {
+            return space_size_ref(_trusted_memory) + 1;
+        }
+
+        block += size;
+    }
+
+    free_classes_ref(_trusted_memory) = 0;
+
+    for (size_t k = 0; k < free_classes_count; ++k)
+    {
+        free_list_head_ref(_trusted_memory, k) = 0;
+    }
+
+    unsigned char *free_begin = nullptr;
+    bool prev_occupied = true;
+    size_t dropped = 0;
+
+    for (block = reinterpret_cast<unsigned char *>(space_begin(_trusted_memory)); block != end;)
+    {
+        auto *next = reinterpret_cast<unsigned char *>(block_end(block));
+        bool intact = block_occupied(block) && block_offset_ref(block) == offset_of(_trusted_memory, block);
+
+        dropped += block_occupied(block) && !intact ? 1 : 0;
+
+        if (!intact)
+        {
+            free_begin = free_begin == nullptr ? block : free_begin;
+            block = next;
+            continue;
+        }
+
+        // adjacent free blocks are merged, a crash may have left them apart
+        if (free_begin != nullptr)
+        {
+            make_free(free_begin, block - free_begin, prev_occupied);
+            free_begin = nullptr;
+            prev_occupied = false;
+        }
+
+        block_tag_ref(block) = (next - block) | occupied_flag | (prev_occupied ? prev_occupied_flag : 0);
+        prev_occupied = true;
+        block = next;
+    }
+
+    if (free_begin != nullptr)
+    {
+        make_free(free_begin, end - free_begin, prev_occupied);
+    }
+
+    return dropped;
+}
+
+bool allocator_boundary_tags::is_persistent() const noexcept
+{
+    return parent_ref(_trusted_memory) == nullptr;
+}
+
+void allocator_boundary_tags::set_root(
+    void *root)
+{
+    if (!is_persistent())
+    {
+        throw std::logic_error("allocator_boundary_tags: root is kept only by heaps backed by a file");
+    }
+
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    mapping_header_ref().root = to_offset(root);
+}
+
+void *allocator_boundary_tags::get_root() const
+{
+    if (!is_persistent())
+    {
+        throw std::logic_error("allocator_boundary_tags: root is kept only by heaps backed by a file");
+    }
+
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    return from_offset(mapping_header_ref().root);
+}
+
+size_t allocator_boundary_tags::to_offset(
+    void const *at) const noexcept
+{
+    return offset_of(_trusted_memory, at);
+}
+
+void *allocator_boundary_tags::from_offset(
+    size_t offset) const noexcept
+{
+    return block_at(_trusted_memory, offset);
+}
+
+allocator_boundary_tags::mapping_header &allocator_boundary_tags::mapping_header_ref() const noexcept
+{
+    return *reinterpret_cast<mapping_header *>(reinterpret_cast<unsigned char *>(_trusted_memory) - mapping_header_size);
 }
 
 inline logger *allocator_boundary_tags::get_logger() const
 {
-    throw not_implemented("inline logger *allocator_boundary_tags::get_logger() const", "your code should be here...");
+    return _trusted_memory == nullptr ? nullptr : logger_ref(_trusted_memory);
 }
 
 inline std::string allocator_boundary_tags::get_typename() const noexcept
 {
-    throw not_implemented("inline std::string allocator_boundary_tags::get_typename() const noexcept", "your code should be here...");
+    return "allocator_boundary_tags";
 }
 
 
 allocator_boundary_tags::boundary_iterator allocator_boundary_tags::begin() const noexcept
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator allocator_boundary_tags::begin() const noexcept", "your code should be here...");
+    return boundary_iterator(_trusted_memory);
 }
 
 allocator_boundary_tags::boundary_iterator allocator_boundary_tags::end() const noexcept
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator allocator_boundary_tags::end() const noexcept", "your code should be here...");
+    return boundary_iterator();
 }
 
 std::vector<allocator_test_utils::block_info> allocator_boundary_tags::get_blocks_info_inner() const
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_boundary_tags::get_blocks_info_inner() const", "your code should be here...");
+    std::vector<allocator_test_utils::block_info> result;
+
+    for (auto it = begin(), last = end(); it != last; ++it)
+    {
+        result.push_back({ .block_size = it.size(), .is_block_occupied = it.occupied() });
+    }
+
+    return result;
+}
+
+bool allocator_boundary_tags::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    auto *other_boundary_tags = dynamic_cast<const allocator_boundary_tags *>(&other);
+
+    return other_boundary_tags != nullptr && other_boundary_tags->_trusted_memory == _trusted_memory;
 }
 
-allocator_boundary_tags::allocator_boundary_tags(const allocator_boundary_tags &other)
+logger *&allocator_boundary_tags::logger_ref(void *trusted) noexcept
 {
-    throw not_implemented("allocator_boundary_tags::allocator_boundary_tags(const allocator_boundary_tags &other)", "your code should be here...");
+    return *reinterpret_cast<logger **>(trusted);
 }
 
-allocator_boundary_tags &allocator_boundary_tags::operator=(const allocator_boundary_tags &other)
+std::pmr::memory_resource *&allocator_boundary_tags::parent_ref(void *trusted) noexcept
 {
-    throw not_implemented("allocator_boundary_tags &allocator_boundary_tags::operator=(const allocator_boundary_tags &other)", "your code should be here...");
+    return *reinterpret_cast<std::pmr::memory_resource **>(reinterpret_cast<unsigned char *>(trusted) + sizeof(logger *));
 }
 
-bool allocator_boundary_tags::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+size_t &allocator_boundary_tags::space_size_ref(void *trusted) noexcept
 {
-    throw not_implemented("bool allocator_boundary_tags::do_is_equal(const std::pmr::memory_resource &other) const noexcept", "your code should be here...");
+    return *reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(&parent_ref(trusted)) + sizeof(std::pmr::memory_resource *));
+}
+
+std::mutex &allocator_boundary_tags::mutex_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<std::mutex *>(&space_size_ref(trusted) + 1);
+}
+
+uint64_t &allocator_boundary_tags::free_classes_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<uint64_t *>(reinterpret_cast<unsigned char *>(&mutex_ref(trusted)) + sizeof(std::mutex));
+}
+
+allocator_with_fit_mode::fit_mode &allocator_boundary_tags::fit_mode_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<fit_mode *>(&free_classes_ref(trusted) + 1);
+}
+
+size_t &allocator_boundary_tags::free_list_head_ref(void *trusted, size_t k) noexcept
+{
+    return reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(trusted) + free_list_heads_offset)[k];
+}
+
+void *allocator_boundary_tags::space_begin(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(trusted) + allocator_metadata_size;
+}
+
+void *allocator_boundary_tags::space_end(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(space_begin(trusted)) + space_size_ref(trusted);
+}
+
+size_t &allocator_boundary_tags::block_tag_ref(void *block) noexcept
+{
+    return *reinterpret_cast<size_t *>(block);
+}
+
+size_t allocator_boundary_tags::block_size(void *block) noexcept
+{
+    return block_tag_ref(block) & ~(occupied_flag | prev_occupied_flag);
+}
+
+bool allocator_boundary_tags::block_occupied(void *block) noexcept
+{
+    return (block_tag_ref(block) & occupied_flag) != 0;
+}
+
+bool allocator_boundary_tags::block_prev_occupied(void *block) noexcept
+{
+    return (block_tag_ref(block) & prev_occupied_flag) != 0;
+}
+
+size_t &allocator_boundary_tags::block_prev_free_ref(void *block) noexcept
+{
+    return *(&block_tag_ref(block) + 1);
+}
+
+size_t &allocator_boundary_tags::block_next_free_ref(void *block) noexcept
+{
+    return *(&block_tag_ref(block) + 2);
+}
+
+size_t &allocator_boundary_tags::block_offset_ref(void *block) noexcept
+{
+    return *(&block_tag_ref(block) + 3);
+}
+
+void *allocator_boundary_tags::block_at(void *trusted, size_t offset) noexcept
+{
+    return offset == 0 ? nullptr : reinterpret_cast<unsigned char *>(trusted) + offset;
+}
+
+size_t allocator_boundary_tags::offset_of(void *trusted, void const *block) noexcept
+{
+    return block == nullptr ? 0 : reinterpret_cast<unsigned char const *>(block) - reinterpret_cast<unsigned char *>(trusted);
+}
+
+void *allocator_boundary_tags::block_end(void *block) noexcept
+{
+    return reinterpret_cast<unsigned char *>(block) + block_size(block);
+}
+
+void allocator_boundary_tags::set_footer(void *trusted, void *block) noexcept
+{
+    auto *end = reinterpret_cast<unsigned char *>(block_end(block));
+
+    if (end != space_end(trusted))
+    {
+        *reinterpret_cast<size_t *>(end - sizeof(size_t)) = block_size(block);
+    }
 }
 
 bool allocator_boundary_tags::boundary_iterator::operator==(
         const allocator_boundary_tags::boundary_iterator &other) const noexcept
 {
-    throw not_implemented("bool allocator_boundary_tags::boundary_iterator::operator==(const allocator_boundary_tags::boundary_iterator &) const noexcept", "your code should be here...");
+    return _occupied_ptr == other._occupied_ptr && _occupied == other._occupied;
 }
 
 bool allocator_boundary_tags::boundary_iterator::operator!=(
         const allocator_boundary_tags::boundary_iterator & other) const noexcept
 {
-    throw not_implemented("bool allocator_boundary_tags::boundary_iterator::operator!=(const allocator_boundary_tags::boundary_iterator &) const noexcept", "your code should be here...");
+    return !(*this == other);
 }
 
 allocator_boundary_tags::boundary_iterator &allocator_boundary_tags::boundary_iterator::operator++() & noexcept
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator &allocator_boundary_tags::boundary_iterator::operator++() & noexcept", "your code should be here...");
+    _occupied_ptr = block_end(_occupied_ptr);
+
+    if (_occupied_ptr == space_end(_trusted_memory))
+    {
+        _occupied_ptr = nullptr;
+        _occupied = true;
+    }
+    else
+    {
+        _occupied = block_occupied(_occupied_ptr);
+    }
+
+    return *this;
 }
 
 allocator_boundary_tags::boundary_iterator &allocator_boundary_tags::boundary_iterator::operator--() & noexcept
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator &allocator_boundary_tags::boundary_iterator::operator--() & noexcept", "your code should be here...");
+    if (_occupied_ptr == space_begin(_trusted_memory))
+    {
+        return *this;
+    }
+
+    if (_occupied_ptr != nullptr && !block_prev_occupied(_occupied_ptr))
+    {
+        _occupied_ptr = reinterpret_cast<unsigned char *>(_occupied_ptr) - *(reinterpret_cast<size_t *>(_occupied_ptr) - 1);
+    }
+    else
+    {
+        void *end = _occupied_ptr == nullptr ? space_end(_trusted_memory) : _occupied_ptr;
+        void *prev = space_begin(_trusted_memory);
+
+        while (block_end(prev) != end)
+        {
+            prev = block_end(prev);
+        }
+
+        _occupied_ptr = prev;
+    }
+
+    _occupied = block_occupied(_occupied_ptr);
+
+    return *this;
 }
 
 allocator_boundary_tags::boundary_iterator allocator_boundary_tags::boundary_iterator::operator++(int n)
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator allocator_boundary_tags::boundary_iterator::operator++(int n)", "your code should be here...");
+    auto copy = *this;
+    ++*this;
+
+    return copy;
 }
 
 allocator_boundary_tags::boundary_iterator allocator_boundary_tags::boundary_iterator::operator--(int n)
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator allocator_boundary_tags::boundary_iterator::operator--(int n)", "your code should be here...");
+    auto copy = *this;
+    --*this;
+
+    return copy;
 }
 
 size_t allocator_boundary_tags::boundary_iterator::size() const noexcept
 {
-    throw not_implemented("size_t allocator_boundary_tags::boundary_iterator::size() const noexcept", "your code should be here...");
+    return block_size(_occupied_ptr);
 }
 
 bool allocator_boundary_tags::boundary_iterator::occupied() const noexcept
 {
-    throw not_implemented("bool allocator_boundary_tags::boundary_iterator::occupied() const noexcept", "your code should be here...");
+    return _occupied;
 }
 
 void* allocator_boundary_tags::boundary_iterator::operator*() const noexcept
 {
-    throw not_implemented("void* allocator_boundary_tags::boundary_iterator::operator*() const noexcept", "your code should be here...");
+    return _occupied_ptr;
 }
 
-allocator_boundary_tags::boundary_iterator::boundary_iterator()
+allocator_boundary_tags::boundary_iterator::boundary_iterator():
+    _occupied_ptr(nullptr),
+    _occupied(true),
+    _trusted_memory(nullptr)
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator::boundary_iterator()", "your code should be here...");
 }
 
-allocator_boundary_tags::boundary_iterator::boundary_iterator(void *trusted)
+allocator_boundary_tags::boundary_iterator::boundary_iterator(void *trusted):
+    _occupied_ptr(space_begin(trusted)),
+    _occupied(block_occupied(space_begin(trusted))),
+    _trusted_memory(trusted)
 {
-    throw not_implemented("allocator_boundary_tags::boundary_iterator::boundary_iterator(void *)", "your code should be here...");
 }
 
 void *allocator_boundary_tags::boundary_iterator::get_ptr() const noexcept
 {
-    throw not_implemented("void *allocator_boundary_tags::boundary_iterator::get_ptr() const noexcept", "your code should be here...");
+    return _occupied_ptr;
 }
@@ -1,9 +1,15 @@
 #include <gtest/gtest.h>
+#include <allocator_guards.h>
 #include <allocator_dbg_helper.h>
 #include <allocator_boundary_tags.h>
 #include <client_logger_builder.h>
+#include <cstdio>
+#include <fstream>
 #include <memory>
 #include <list>
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
 
 logger *create_logger(
     std::vector<std::pair<std::string, logger::severity>> const &output_file_streams_setup,
@@ -27,10 +33,15 @@ logger *create_logger(
     return logger_instance;
 }
 
-//TODO: recalculate size
+// payload sizes are rounded up to alignof(std::max_align_t)
 
 TEST(positiveTests, test1)
 {
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "heap is sized for the exact requests, guards overhead does not fit";
+    }
+
     std::unique_ptr<logger> logger(create_logger(std::vector<std::pair<std::string, logger::severity>>
         {
             {
@@ -38,14 +49,14 @@ TEST(positiveTests, test1)
                 logger::severity::information
             }
         }));
-    std::unique_ptr<smart_mem_resource> subject(new allocator_boundary_tags(sizeof(int) * 70, nullptr, logger.get(), allocator_with_fit_mode::fit_mode::first_fit));
+    std::unique_ptr<smart_mem_resource> subject(new allocator_boundary_tags(sizeof(int) * 104, nullptr, logger.get(), allocator_with_fit_mode::fit_mode::first_fit));
     
-    auto *first_block = reinterpret_cast<int *>(subject->allocate(sizeof(int) * 10));
-    auto *second_block = reinterpret_cast<int *>(subject->allocate(sizeof(int) * 10));
-    auto *third_block = reinterpret_cast<int *>(subject->allocate(sizeof(int) * 10));
+    auto *first_block = reinterpret_cast<int *>(subject->allocate(sizeof(int) * 20));
+    auto *second_block = reinterpret_cast<int *>(subject->allocate(sizeof(int) * 20));
+    auto *third_block = reinterpret_cast<int *>(subject->allocate(sizeof(int) * 20));
     
-    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(first_block + 10) + sizeof(size_t) + sizeof(void*) * 3), second_block);
-    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(second_block + 10) + sizeof(size_t) + sizeof(void*) * 3), third_block);
+    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(first_block + 20) + sizeof(size_t) + sizeof(void*) * 3), second_block);
+    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(second_block + 20) + sizeof(size_t) + sizeof(void*) * 3), third_block);
     
     subject->deallocate(const_cast<void *>(reinterpret_cast<void const *>(second_block)), 1);
     
@@ -55,8 +66,8 @@ TEST(positiveTests, test1)
     the_same_subject->set_fit_mode(allocator_with_fit_mode::fit_mode::the_best_fit);
     auto *fifth_block = reinterpret_cast<int *>(subject->allocate(sizeof(int) * 1));
     
-    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(first_block + 10) + sizeof(size_t) + sizeof(void*) * 3), fourth_block);
-    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(fourth_block + 1) + sizeof(size_t) + sizeof(void*) * 3), fifth_block);
+    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(first_block + 20) + sizeof(size_t) + sizeof(void*) * 3), fourth_block);
+    ASSERT_EQ(reinterpret_cast<int*>(reinterpret_cast<char*>(fourth_block + 4) + sizeof(size_t) + sizeof(void*) * 3), fifth_block);
     
     subject->deallocate(const_cast<void *>(reinterpret_cast<void const *>(first_block)), 1);
     subject->deallocate(const_cast<void *>(reinterpret_cast<void const *>(third_block)), 1);
@@ -67,6 +78,11 @@ TEST(positiveTests, test1)
 
 TEST(positiveTests, test2)
 {
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "block layout depends on allocator guards overhead";
+    }
+
     std::unique_ptr<logger> logger_instance(create_logger(std::vector<std::pair<std::string, logger::severity>>
         {
             {
@@ -83,9 +99,9 @@ TEST(positiveTests, test2)
     auto actual_blocks_state = dynamic_cast<allocator_test_utils *>(allocator_instance.get())->get_blocks_info();
     std::vector<allocator_test_utils::block_info> expected_blocks_state
         {
-            { .block_size = 1000 + sizeof(allocator_dbg_helper::block_size_t) + sizeof(allocator_dbg_helper::block_pointer_t) * 3, .is_block_occupied = true },
+            { .block_size = 1008 + sizeof(allocator_dbg_helper::block_size_t) + sizeof(allocator_dbg_helper::block_pointer_t) * 3, .is_block_occupied = true },
             { .block_size = sizeof(allocator_dbg_helper::block_size_t) + sizeof(allocator_dbg_helper::block_pointer_t) * 3, .is_block_occupied = true },
-            { .block_size = 3000 - (1000 + (sizeof(allocator_dbg_helper::block_size_t) + sizeof(allocator_dbg_helper::block_pointer_t) * 3) * 2), .is_block_occupied = false }
+            { .block_size = 3000 - (1008 + (sizeof(allocator_dbg_helper::block_size_t) + sizeof(allocator_dbg_helper::block_pointer_t) * 3) * 2), .is_block_occupied = false }
         };
     
     ASSERT_EQ(actual_blocks_state.size(), expected_blocks_state.size());
@@ -98,6 +114,252 @@ TEST(positiveTests, test2)
     allocator_instance->deallocate(second_block, 1);
 }
 
+TEST(positiveTests, test3)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_boundary_tags(1 << 16));
+
+    ASSERT_EQ(allocator_test_utils::check_alignments(*alloc), "");
+}
+
+TEST(positiveTests, test4)
+{
+    constexpr size_t space_size = 1 << 16;
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_boundary_tags(space_size));
+    auto *the_same_subject = dynamic_cast<allocator_with_fit_mode *>(alloc.get());
+    auto *utils = dynamic_cast<allocator_test_utils *>(alloc.get());
+
+    auto *first_block = alloc->allocate(100);
+    auto *second_block = alloc->allocate(100);
+    auto *third_block = alloc->allocate(100);
+
+    alloc->deallocate(first_block, 1);
+    alloc->deallocate(third_block, 1);
+    alloc->deallocate(second_block, 1);
+
+    ASSERT_EQ(utils->get_blocks_info().size(), 1);
+
+    std::mt19937 generator(42);
+    std::vector<void *> blocks;
+
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        if (blocks.empty() || generator() % 3 != 0)
+        {
+            the_same_subject->set_fit_mode(static_cast<allocator_with_fit_mode::fit_mode>(generator() % 3));
+
+            try
+            {
+                blocks.push_back(alloc->allocate(generator() % 1000));
+            }
+            catch (std::bad_alloc const &)
+            {
+            }
+        }
+        else
+        {
+            std::swap(blocks[generator() % blocks.size()], blocks.back());
+            alloc->deallocate(blocks.back(), 1);
+            blocks.pop_back();
+        }
+
+        if (i % 1000 == 0)
+        {
+            size_t total = 0;
+            bool prev_free = false;
+
+            for (auto const &block : utils->get_blocks_info())
+            {
+                ASSERT_FALSE(prev_free && !block.is_block_occupied);
+                prev_free = !block.is_block_occupied;
+                total += block.block_size;
+            }
+
+            ASSERT_EQ(total, space_size);
+        }
+    }
+
+    for (void *block : blocks)
+    {
+        alloc->deallocate(block, 1);
+    }
+
+    auto blocks_state = utils->get_blocks_info();
+
+    ASSERT_EQ(blocks_state.size(), 1);
+    ASSERT_EQ(blocks_state[0], (allocator_test_utils::block_info{ .block_size = space_size, .is_block_occupied = false }));
+}
+
+TEST(positiveTests, test5)
+{
+    struct index_root
+    {
+        size_t count;
+        size_t values[16];
+    };
+
+    std::string path = "allocator_boundary_tags_tests_heap_5.bin";
+    std::remove(path.c_str());
+    std::vector<allocator_test_utils::block_info> blocks_before;
+    size_t garbage_offset;
+
+    {
+        allocator_boundary_tags heap(path, 1 << 16);
+
+        ASSERT_TRUE(heap.is_persistent());
+        ASSERT_EQ(heap.get_root(), nullptr);
+
+        auto *root = reinterpret_cast<index_root *>(heap.allocate(sizeof(index_root)));
+        void *garbage = heap.allocate(1000);
+
+        root->count = 16;
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            root->values[i] = i * i;
+        }
+
+        heap.set_root(root);
+        garbage_offset = heap.to_offset(garbage);
+        blocks_before = heap.get_blocks_info();
+    }
+
+    {
+        allocator_boundary_tags heap(path, 0);
+        auto *root = reinterpret_cast<index_root *>(heap.get_root());
+
+        ASSERT_NE(root, nullptr);
+        ASSERT_EQ(root->count, 16);
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            ASSERT_EQ(root->values[i], i * i);
+        }
+
+        auto blocks_after = heap.get_blocks_info();
+
+        ASSERT_EQ(blocks_after.size(), blocks_before.size());
+
+        for (size_t i = 0; i < blocks_after.size(); ++i)
+        {
+            ASSERT_EQ(blocks_after[i].block_size, blocks_before[i].block_size);
+            ASSERT_EQ(blocks_after[i].is_block_occupied, blocks_before[i].is_block_occupied);
+        }
+
+        auto statistics = heap.get_statistics();
+
+        ASSERT_EQ(statistics.allocations, 2);
+        ASSERT_EQ(statistics.free_bytes + statistics.bytes_in_use, 1 << 16);
+
+        heap.deallocate(heap.from_offset(garbage_offset), 1000);
+        heap.deallocate(root, sizeof(index_root));
+
+        ASSERT_EQ(heap.get_blocks_info().size(), 1);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(positiveTests, test6)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "test damages block headers right before payload, allocator guards put a red zone there";
+    }
+
+    std::string path = "allocator_boundary_tags_tests_heap_6.bin";
+    std::remove(path.c_str());
+
+    // child dies without detaching while the middle block is being freed: its offset word is cleared first
+    pid_t child = fork();
+
+    ASSERT_NE(child, -1);
+
+    if (child == 0)
+    {
+        allocator_boundary_tags heap(path, 1 << 16);
+        auto *root = reinterpret_cast<size_t *>(heap.allocate(sizeof(size_t)));
+        auto *torn = reinterpret_cast<size_t *>(heap.allocate(100));
+
+        static_cast<void>(heap.allocate(200));
+        *root = 42;
+        heap.set_root(root);
+        torn[-1] = 0;
+
+        _exit(0);
+    }
+
+    int status = 0;
+
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_THROW(allocator_boundary_tags(path, 0), std::runtime_error);
+
+    {
+        allocator_boundary_tags heap(path, 0, nullptr, allocator_with_fit_mode::fit_mode::first_fit, true);
+        auto *root = reinterpret_cast<size_t *>(heap.get_root());
+        auto blocks = heap.get_blocks_info();
+
+        ASSERT_EQ(*root, 42);
+        ASSERT_EQ(blocks.size(), 4);
+        ASSERT_TRUE(blocks[0].is_block_occupied);
+        ASSERT_FALSE(blocks[1].is_block_occupied);
+        ASSERT_TRUE(blocks[2].is_block_occupied);
+        ASSERT_FALSE(blocks[3].is_block_occupied);
+        ASSERT_EQ(heap.get_statistics().allocations, 2);
+
+        auto *reused = heap.allocate(100);
+
+        ASSERT_TRUE(heap.get_blocks_info()[1].is_block_occupied);
+        heap.deallocate(reused, 100);
+    }
+
+    // clean detach after recovery lets the heap attach without it
+    static_cast<void>(allocator_boundary_tags(path, 0));
+
+    std::remove(path.c_str());
+}
+
+TEST(positiveTests, test7)
+{
+    allocator_boundary_tags heap(1 << 14);
+    std::vector<void *> blocks;
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        blocks.push_back(heap.allocate(100 + 50 * i));
+    }
+
+    for (size_t i = 0; i < blocks.size(); i += 2)
+    {
+        heap.deallocate(blocks[i], 100 + 50 * i);
+    }
+
+    size_t free_bytes = 0;
+    size_t largest = 0;
+
+    for (auto const &block : heap.get_blocks_info())
+    {
+        if (!block.is_block_occupied)
+        {
+            free_bytes += block.block_size;
+            largest = std::max(largest, block.block_size);
+        }
+    }
+
+    auto statistics = heap.get_statistics();
+
+    ASSERT_EQ(statistics.free_bytes, free_bytes);
+    ASSERT_EQ(statistics.largest_free_block, largest);
+    ASSERT_GT(statistics.fragmentation(), 0.0);
+
+    for (size_t i = 1; i < blocks.size(); i += 2)
+    {
+        heap.deallocate(blocks[i], 100 + 50 * i);
+    }
+
+    ASSERT_EQ(heap.get_statistics().largest_free_block, 1 << 14);
+    ASSERT_EQ(heap.get_statistics().fragmentation(), 0.0);
+}
+
 TEST(falsePositiveTests, test1)
 {
     std::unique_ptr<logger> logger_instance(create_logger(std::vector<std::pair<std::string, logger::severity>>
@@ -211,6 +473,55 @@ TEST(own, test1)
 }
 
 
+TEST(falsePositiveTests, test2)
+{
+    std::string path = "allocator_boundary_tags_tests_heap_negative_2.bin";
+    std::remove(path.c_str());
+
+    {
+        allocator_boundary_tags heap(path, 1 << 12);
+
+        ASSERT_THROW(allocator_boundary_tags(path, 1 << 12), std::runtime_error);
+    }
+
+    std::ofstream(path, std::ios::trunc) << "not a heap";
+
+    ASSERT_THROW(allocator_boundary_tags(path, 1 << 12), std::runtime_error);
+
+    std::remove(path.c_str());
+
+    allocator_boundary_tags transient(1 << 12);
+
+    ASSERT_FALSE(transient.is_persistent());
+    ASSERT_THROW(transient.set_root(nullptr), std::logic_error);
+
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "test damages the size tag right before payload, allocator guards put a red zone there";
+    }
+
+    // size tag of the first block is broken, so the heap can't be recovered
+    pid_t child = fork();
+
+    ASSERT_NE(child, -1);
+
+    if (child == 0)
+    {
+        allocator_boundary_tags heap(path, 1 << 12);
+
+        reinterpret_cast<size_t *>(heap.allocate(16))[-4] = 3;
+
+        _exit(0);
+    }
+
+    int status = 0;
+
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_THROW(allocator_boundary_tags(path, 0, nullptr, allocator_with_fit_mode::fit_mode::first_fit, true), std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
 int main(
     int argc,
     char *argv[])
@@ -3,11 +3,14 @@
 
 #include <pp_allocator.h>
 #include <allocator_test_utils.h>
+#include <allocator_with_statistics.h>
 #include <allocator_with_fit_mode.h>
 #include <logger_guardant.h>
 #include <typename_holder.h>
 #include <mutex>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 
 namespace __detail
 {
@@ -35,6 +38,7 @@ class allocator_buddies_system final:
     public smart_mem_resource,
     public allocator_test_utils,
     public allocator_with_fit_mode,
+    public allocator_with_statistics,
     private logger_guardant,
     private typename_holder
 {
@@ -51,17 +55,33 @@ private:
     void *_trusted_memory;
 
     /**
-     * TODO: You must improve it for alignment support
+     * Header is followed by heads of per order free lists for orders [0, space power].
+     * Bit k of free orders bitmap is set iff free list of order k is not empty.
      */
+    static constexpr const size_t allocator_metadata_size = sizeof(logger*) + sizeof(std::pmr::memory_resource*) + sizeof(std::mutex) + sizeof(uint64_t) +
+                                                            sizeof(fit_mode) + sizeof(unsigned char);
 
-    static constexpr const size_t allocator_metadata_size = sizeof(logger*) + sizeof(allocator_dbg_helper*) + sizeof(fit_mode) + sizeof(unsigned char) + sizeof(std::mutex);
+    static constexpr const size_t free_list_heads_offset = (allocator_metadata_size + alignof(uint32_t) - 1) / alignof(uint32_t) * alignof(uint32_t);
 
-    static constexpr const size_t occupied_block_metadata_size = sizeof(block_metadata) + sizeof(void*);
+    /**
+     * Padded up to alignof(std::max_align_t), so payload of every block is aligned for any fundamental type
+     */
+    static constexpr const size_t occupied_block_metadata_size = (sizeof(block_metadata) + sizeof(void*) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
 
-    static constexpr const size_t free_block_metadata_size = sizeof(block_metadata);
+    /**
+     * Free block links neighbours in its order list by offsets from space start in min blocks,
+     * so links fit even into the smallest block
+     */
+    using free_link_t = uint32_t;
+
+    static constexpr const free_link_t null_link = std::numeric_limits<free_link_t>::max();
+
+    static constexpr const size_t free_block_metadata_size = sizeof(block_metadata) + sizeof(free_link_t) * 2;
 
     static constexpr const size_t min_k = __detail::nearest_greater_k_of_2(occupied_block_metadata_size);
 
+    static constexpr const size_t max_k = std::min<size_t>(sizeof(uint64_t) * 8 - 1, min_k + sizeof(free_link_t) * 8 - 1);
+
 public:
 
     explicit allocator_buddies_system(
@@ -71,10 +91,10 @@ public:
             allocator_with_fit_mode::fit_mode allocate_fit_mode = allocator_with_fit_mode::fit_mode::first_fit);
 
     allocator_buddies_system(
-        allocator_buddies_system const &other);
+        allocator_buddies_system const &other) = delete;
     
     allocator_buddies_system &operator=(
-        allocator_buddies_system const &other);
+        allocator_buddies_system const &other) = delete;
     
     allocator_buddies_system(
         allocator_buddies_system &&other) noexcept;
@@ -109,7 +129,49 @@ private:
 
     std::vector<allocator_test_utils::block_info> get_blocks_info_inner() const override;
 
-    /** TODO: Highly recommended for helper functions to return references */
+    void destroy() noexcept;
+
+    static logger *&logger_ref(void *trusted) noexcept;
+
+    static std::pmr::memory_resource *&parent_ref(void *trusted) noexcept;
+
+    static std::mutex &mutex_ref(void *trusted) noexcept;
+
+    static uint64_t &free_orders_ref(void *trusted) noexcept;
+
+    static fit_mode &fit_mode_ref(void *trusted) noexcept;
+
+    static unsigned char &space_power_ref(void *trusted) noexcept;
+
+    static free_link_t &free_list_head_ref(void *trusted, size_t k) noexcept;
+
+    static void *space_begin(void *trusted) noexcept;
+
+    static void *space_end(void *trusted) noexcept;
+
+    static size_t space_offset(size_t space_power) noexcept;
+
+    static size_t trusted_size(size_t space_power) noexcept;
+
+    static block_metadata &block_metadata_ref(void *block) noexcept;
+
+    static free_link_t &block_prev_link_ref(void *block) noexcept;
+
+    static free_link_t &block_next_link_ref(void *block) noexcept;
+
+    static void *&block_owner_ref(void *block) noexcept;
+
+    void *link_to_block(free_link_t link) const noexcept;
+
+    free_link_t block_to_link(void *block) const noexcept;
+
+    void push_free(void *block, size_t k) noexcept;
+
+    void *pop_free(size_t k) noexcept;
+
+    void erase_free(void *block, size_t k) noexcept;
+
+    void publish_free_space() noexcept;
 
     class buddy_iterator
     {
@@ -1,137 +1,414 @@
-#include <not_implemented.h>
-#include <cstddef>
+#include <bit>
 #include "../include/allocator_buddies_system.h"
 
-allocator_buddies_system::~allocator_buddies_system()
+allocator_buddies_system::allocator_buddies_system(
+        size_t space_size,
+        std::pmr::memory_resource *parent_allocator,
+        logger *logger,
+        allocator_with_fit_mode::fit_mode allocate_fit_mode)
 {
-    throw not_implemented("allocator_buddies_system::~allocator_buddies_system()", "your code should be here...");
+    if (space_size < min_k || space_size > max_k)
+    {
+        throw std::logic_error("allocator_buddies_system: space size power must be in [" + std::to_string(min_k) + ", " + std::to_string(max_k) + "]");
+    }
+
+    if (parent_allocator == nullptr)
+    {
+        parent_allocator = std::pmr::get_default_resource();
+    }
+
+    _trusted_memory = parent_allocator->allocate(trusted_size(space_size), alignof(std::max_align_t));
+
+    logger_ref(_trusted_memory) = logger;
+    parent_ref(_trusted_memory) = parent_allocator;
+    new (&mutex_ref(_trusted_memory)) std::mutex();
+    free_orders_ref(_trusted_memory) = 0;
+    fit_mode_ref(_trusted_memory) = allocate_fit_mode;
+    space_power_ref(_trusted_memory) = static_cast<unsigned char>(space_size);
+
+    for (size_t k = 0; k <= space_size; ++k)
+    {
+        free_list_head_ref(_trusted_memory, k) = null_link;
+    }
+
+    push_free(space_begin(_trusted_memory), space_size);
+    publish_free_space();
+
+    debug_with_guard(get_typename() + ": created with 2^" + std::to_string(space_size) + " bytes of space");
 }
 
 allocator_buddies_system::allocator_buddies_system(
-    allocator_buddies_system &&other) noexcept
+    allocator_buddies_system &&other) noexcept:
+    allocator_with_statistics(std::move(other)),
+    _trusted_memory(other._trusted_memory)
 {
-    throw not_implemented("allocator_buddies_system::allocator_buddies_system(allocator_buddies_system &&) noexcept", "your code should be here...");
+    other._trusted_memory = nullptr;
 }
 
 allocator_buddies_system &allocator_buddies_system::operator=(
     allocator_buddies_system &&other) noexcept
 {
-    throw not_implemented("allocator_buddies_system &allocator_buddies_system::operator=(allocator_buddies_system &&) noexcept", "your code should be here...");
+    if (this != &other)
+    {
+        destroy();
+        allocator_with_statistics::operator=(std::move(other));
+        _trusted_memory = other._trusted_memory;
+        other._trusted_memory = nullptr;
+    }
+
+    return *this;
 }
 
-allocator_buddies_system::allocator_buddies_system(
-        size_t space_size,
-        std::pmr::memory_resource *parent_allocator,
-        logger *logger,
-        allocator_with_fit_mode::fit_mode allocate_fit_mode)
+allocator_buddies_system::~allocator_buddies_system()
 {
-    throw not_implemented("allocator_buddies_system::allocator_buddies_system(size_t,std::pmr::memory_resource *,logger *,allocator_with_fit_mode::fit_mode)", "your code should be here...");
+    destroy();
+}
+
+void allocator_buddies_system::destroy() noexcept
+{
+    if (_trusted_memory == nullptr)
+    {
+        return;
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+
+    auto *parent = parent_ref(_trusted_memory);
+    size_t size = trusted_size(space_power_ref(_trusted_memory));
+
+    mutex_ref(_trusted_memory).~mutex();
+    parent->deallocate(_trusted_memory, size, alignof(std::max_align_t));
+    _trusted_memory = nullptr;
 }
 
 [[nodiscard]] void *allocator_buddies_system::do_allocate_sm(
     size_t size)
 {
-    throw not_implemented("[[nodiscard]] void *allocator_buddies_system::do_allocate_sm(size_t)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    size_t k = std::max<size_t>(min_k, __detail::nearest_greater_k_of_2(size + occupied_block_metadata_size));
+    size_t space_power = space_power_ref(_trusted_memory);
+    uint64_t free_orders = k > space_power ? 0 : free_orders_ref(_trusted_memory) & (~uint64_t(0) << k);
+
+    if (free_orders == 0)
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        record_failed_allocation(size);
+        throw std::bad_alloc();
+    }
+
+    size_t order = fit_mode_ref(_trusted_memory) == fit_mode::the_worst_fit
+        ? std::bit_width(free_orders) - 1
+        : std::countr_zero(free_orders);
+
+    auto *block = reinterpret_cast<unsigned char *>(pop_free(order));
+
+    while (order > k)
+    {
+        --order;
+        push_free(block + (size_t(1) << order), order);
+    }
+
+    block_metadata_ref(block) = { .occupied = true, .size = static_cast<unsigned char>(k) };
+    block_owner_ref(block) = _trusted_memory;
+
+    record_allocation(size, size_t(1) << k);
+    publish_free_space();
+
+    return block + occupied_block_metadata_size;
 }
 
 void allocator_buddies_system::do_deallocate_sm(void *at)
 {
-    throw not_implemented("void allocator_buddies_system::do_deallocate_sm(void *)", "your code should be here...");
-}
+    if (at == nullptr)
+    {
+        return;
+    }
 
-allocator_buddies_system::allocator_buddies_system(const allocator_buddies_system &other)
-{
-    throw not_implemented("allocator_buddies_system::allocator_buddies_system(const allocator_buddies_system &other)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    auto *block = reinterpret_cast<unsigned char *>(at) - occupied_block_metadata_size;
+
+    if (block < space_begin(_trusted_memory) || block >= space_end(_trusted_memory)
+        || !block_metadata_ref(block).occupied || block_owner_ref(block) != _trusted_memory)
+    {
+        error_with_guard(get_typename() + ": pointer does not belong to allocated block");
+        throw std::logic_error("allocator_buddies_system: pointer does not belong to allocated block");
+    }
+
+    auto *begin = reinterpret_cast<unsigned char *>(space_begin(_trusted_memory));
+    size_t space_power = space_power_ref(_trusted_memory);
+    size_t k = block_metadata_ref(block).size;
+    size_t offset = block - begin;
+
+    record_deallocation(size_t(1) << k);
+
+    while (k < space_power)
+    {
+        auto *buddy = begin + (offset ^ (size_t(1) << k));
+        auto const &buddy_metadata = block_metadata_ref(buddy);
+
+        if (buddy_metadata.occupied || buddy_metadata.size != k)
+        {
+            break;
+        }
+
+        erase_free(buddy, k);
+        offset &= ~(size_t(1) << k);
+        ++k;
+    }
+
+    push_free(begin + offset, k);
+    publish_free_space();
 }
 
-allocator_buddies_system &allocator_buddies_system::operator=(const allocator_buddies_system &other)
+void allocator_buddies_system::publish_free_space() noexcept
 {
-    throw not_implemented("allocator_buddies_system &allocator_buddies_system::operator=(const allocator_buddies_system &other)", "your code should be here...");
+    uint64_t free_orders = free_orders_ref(_trusted_memory);
+    size_t largest = free_orders == 0 ? 0 : size_t(1) << (std::bit_width(free_orders) - 1);
+
+    record_free_space((size_t(1) << space_power_ref(_trusted_memory)) - bytes_in_use(), largest);
 }
 
 bool allocator_buddies_system::do_is_equal(const std::pmr::memory_resource &other) const noexcept
 {
-    throw not_implemented("bool allocator_buddies_system::do_is_equal(const std::pmr::memory_resource &other) const noexcept", "your code should be here...");
+    auto *other_buddies = dynamic_cast<const allocator_buddies_system *>(&other);
+
+    return other_buddies != nullptr && other_buddies->_trusted_memory == _trusted_memory;
 }
 
 inline void allocator_buddies_system::set_fit_mode(
     allocator_with_fit_mode::fit_mode mode)
 {
-    throw not_implemented("inline void allocator_buddies_system::set_fit_mode(allocator_with_fit_mode::fit_mode)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    fit_mode_ref(_trusted_memory) = mode;
 }
 
 
 std::vector<allocator_test_utils::block_info> allocator_buddies_system::get_blocks_info() const noexcept
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_buddies_system::get_blocks_info() const noexcept", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    return get_blocks_info_inner();
+}
+
+std::vector<allocator_test_utils::block_info> allocator_buddies_system::get_blocks_info_inner() const
+{
+    std::vector<allocator_test_utils::block_info> result;
+
+    for (auto it = begin(), last = end(); it != last; ++it)
+    {
+        result.push_back({ .block_size = it.size(), .is_block_occupied = it.occupied() });
+    }
+
+    return result;
 }
 
 inline logger *allocator_buddies_system::get_logger() const
 {
-    throw not_implemented("inline logger *allocator_buddies_system::get_logger() const", "your code should be here...");
+    return _trusted_memory == nullptr ? nullptr : logger_ref(_trusted_memory);
 }
 
 inline std::string allocator_buddies_system::get_typename() const
 {
-    throw not_implemented("inline std::string allocator_buddies_system::get_typename() const", "your code should be here...");
+    return "allocator_buddies_system";
 }
 
-std::vector<allocator_test_utils::block_info> allocator_buddies_system::get_blocks_info_inner() const
+logger *&allocator_buddies_system::logger_ref(void *trusted) noexcept
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_buddies_system::get_blocks_info_inner() const", "your code should be here...");
+    return *reinterpret_cast<logger **>(trusted);
+}
+
+std::pmr::memory_resource *&allocator_buddies_system::parent_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<std::pmr::memory_resource **>(reinterpret_cast<unsigned char *>(trusted) + sizeof(logger *));
+}
+
+std::mutex &allocator_buddies_system::mutex_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<std::mutex *>(reinterpret_cast<unsigned char *>(&parent_ref(trusted)) + sizeof(std::pmr::memory_resource *));
+}
+
+uint64_t &allocator_buddies_system::free_orders_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<uint64_t *>(reinterpret_cast<unsigned char *>(&mutex_ref(trusted)) + sizeof(std::mutex));
+}
+
+allocator_with_fit_mode::fit_mode &allocator_buddies_system::fit_mode_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<fit_mode *>(&free_orders_ref(trusted) + 1);
+}
+
+unsigned char &allocator_buddies_system::space_power_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<unsigned char *>(&fit_mode_ref(trusted) + 1);
+}
+
+allocator_buddies_system::free_link_t &allocator_buddies_system::free_list_head_ref(void *trusted, size_t k) noexcept
+{
+    return reinterpret_cast<free_link_t *>(reinterpret_cast<unsigned char *>(trusted) + free_list_heads_offset)[k];
+}
+
+void *allocator_buddies_system::space_begin(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(trusted) + space_offset(space_power_ref(trusted));
+}
+
+void *allocator_buddies_system::space_end(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(space_begin(trusted)) + (size_t(1) << space_power_ref(trusted));
+}
+
+size_t allocator_buddies_system::space_offset(size_t space_power) noexcept
+{
+    size_t heads_end = free_list_heads_offset + (space_power + 1) * sizeof(free_link_t);
+
+    return (heads_end + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+}
+
+size_t allocator_buddies_system::trusted_size(size_t space_power) noexcept
+{
+    return space_offset(space_power) + (size_t(1) << space_power);
+}
+
+allocator_buddies_system::block_metadata &allocator_buddies_system::block_metadata_ref(void *block) noexcept
+{
+    return *reinterpret_cast<block_metadata *>(block);
+}
+
+allocator_buddies_system::free_link_t &allocator_buddies_system::block_prev_link_ref(void *block) noexcept
+{
+    return *reinterpret_cast<free_link_t *>(reinterpret_cast<unsigned char *>(block) + alignof(free_link_t));
+}
+
+allocator_buddies_system::free_link_t &allocator_buddies_system::block_next_link_ref(void *block) noexcept
+{
+    return *(&block_prev_link_ref(block) + 1);
+}
+
+void *&allocator_buddies_system::block_owner_ref(void *block) noexcept
+{
+    return *reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(block) + alignof(void *));
+}
+
+void *allocator_buddies_system::link_to_block(free_link_t link) const noexcept
+{
+    return reinterpret_cast<unsigned char *>(space_begin(_trusted_memory)) + (static_cast<size_t>(link) << min_k);
+}
+
+allocator_buddies_system::free_link_t allocator_buddies_system::block_to_link(void *block) const noexcept
+{
+    return static_cast<free_link_t>((reinterpret_cast<unsigned char *>(block) - reinterpret_cast<unsigned char *>(space_begin(_trusted_memory))) >> min_k);
+}
+
+void allocator_buddies_system::push_free(void *block, size_t k) noexcept
+{
+    free_link_t &head = free_list_head_ref(_trusted_memory, k);
+
+    block_metadata_ref(block) = { .occupied = false, .size = static_cast<unsigned char>(k) };
+    block_prev_link_ref(block) = null_link;
+    block_next_link_ref(block) = head;
+
+    if (head != null_link)
+    {
+        block_prev_link_ref(link_to_block(head)) = block_to_link(block);
+    }
+
+    head = block_to_link(block);
+    free_orders_ref(_trusted_memory) |= uint64_t(1) << k;
+}
+
+void *allocator_buddies_system::pop_free(size_t k) noexcept
+{
+    void *block = link_to_block(free_list_head_ref(_trusted_memory, k));
+
+    erase_free(block, k);
+
+    return block;
+}
+
+void allocator_buddies_system::erase_free(void *block, size_t k) noexcept
+{
+    free_link_t prev = block_prev_link_ref(block);
+    free_link_t next = block_next_link_ref(block);
+
+    if (prev != null_link)
+    {
+        block_next_link_ref(link_to_block(prev)) = next;
+    }
+    else
+    {
+        free_list_head_ref(_trusted_memory, k) = next;
+    }
+
+    if (next != null_link)
+    {
+        block_prev_link_ref(link_to_block(next)) = prev;
+    }
+
+    if (free_list_head_ref(_trusted_memory, k) == null_link)
+    {
+        free_orders_ref(_trusted_memory) &= ~(uint64_t(1) << k);
+    }
 }
 
 allocator_buddies_system::buddy_iterator allocator_buddies_system::begin() const noexcept
 {
-    throw not_implemented("allocator_buddies_system::buddy_iterator allocator_buddies_system::begin() const noexcept", "your code should be here...");
+    return buddy_iterator(space_begin(_trusted_memory));
 }
 
 allocator_buddies_system::buddy_iterator allocator_buddies_system::end() const noexcept
 {
-    throw not_implemented("allocator_buddies_system::buddy_iterator allocator_buddies_system::end() const noexcept", "your code should be here...");
+    return buddy_iterator(space_end(_trusted_memory));
 }
 
 bool allocator_buddies_system::buddy_iterator::operator==(const allocator_buddies_system::buddy_iterator &other) const noexcept
 {
-    throw not_implemented("bool allocator_buddies_system::buddy_iterator::operator==(const allocator_buddies_system::buddy_iterator &) const noexcept", "your code should be here...");
+    return _block == other._block;
 }
 
 bool allocator_buddies_system::buddy_iterator::operator!=(const allocator_buddies_system::buddy_iterator &other) const noexcept
 {
-    throw not_implemented("bool allocator_buddies_system::buddy_iterator::operator!=(const allocator_buddies_system::buddy_iterator &) const noexcept", "your code should be here...");
+    return !(*this == other);
 }
 
 allocator_buddies_system::buddy_iterator &allocator_buddies_system::buddy_iterator::operator++() & noexcept
 {
-    throw not_implemented("allocator_buddies_system::buddy_iterator &allocator_buddies_system::buddy_iterator::operator++() & noexcept", "your code should be here...");
+    _block = reinterpret_cast<unsigned char *>(_block) + size();
+
+    return *this;
 }
 
 allocator_buddies_system::buddy_iterator allocator_buddies_system::buddy_iterator::operator++(int n)
 {
-    throw not_implemented("allocator_buddies_system::buddy_iterator allocator_buddies_system::buddy_iterator::operator++(int)", "your code should be here...");
+    auto copy = *this;
+    ++*this;
+
+    return copy;
 }
 
 size_t allocator_buddies_system::buddy_iterator::size() const noexcept
 {
-    throw not_implemented("size_t allocator_buddies_system::buddy_iterator::size() const noexcept", "your code should be here...");
+    return size_t(1) << block_metadata_ref(_block).size;
 }
 
 bool allocator_buddies_system::buddy_iterator::occupied() const noexcept
 {
-    throw not_implemented("bool allocator_buddies_system::buddy_iterator::occupied() const noexcept", "your code should be here...");
+    return block_metadata_ref(_block).occupied;
 }
 
 void *allocator_buddies_system::buddy_iterator::operator*() const noexcept
 {
-    throw not_implemented("void *allocator_buddies_system::buddy_iterator::operator*() const noexcept", "your code should be here...");
+    return _block;
 }
 
-allocator_buddies_system::buddy_iterator::buddy_iterator(void *start)
+allocator_buddies_system::buddy_iterator::buddy_iterator(void *start):
+    _block(start)
 {
-    throw not_implemented("allocator_buddies_system::buddy_iterator::buddy_iterator(void *)", "your code should be here...");
 }
 
-allocator_buddies_system::buddy_iterator::buddy_iterator()
+allocator_buddies_system::buddy_iterator::buddy_iterator():
+    _block(nullptr)
 {
-    throw not_implemented("allocator_buddies_system::buddy_iterator::buddy_iterator()", "your code should be here...");
 }
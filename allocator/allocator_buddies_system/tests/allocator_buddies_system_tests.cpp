@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <allocator_guards.h>
 #include <cmath>
 #include <allocator_dbg_helper.h>
 #include <allocator_buddies_system.h>
@@ -54,6 +55,11 @@ TEST(positiveTests, test1)
 
 TEST(positiveTests, test23)
 {
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "block layout depends on allocator guards overhead";
+    }
+
     std::unique_ptr<logger> logger_instance(create_logger(std::vector<std::pair<std::string, logger::severity>>
         {
             {
@@ -84,6 +90,11 @@ TEST(positiveTests, test23)
 
 TEST(positiveTests, test3)
 {
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "block layout depends on allocator guards overhead";
+    }
+
     std::unique_ptr<smart_mem_resource> allocator_instance(new allocator_buddies_system(8, nullptr, nullptr, allocator_with_fit_mode::fit_mode::first_fit));
     
     void *first_block = allocator_instance->allocate(sizeof(unsigned char) * 0);
@@ -102,6 +113,11 @@ TEST(positiveTests, test3)
 
 TEST(positiveTests, test53)
 {
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "heap is sized for the exact requests, guards overhead does not fit";
+    }
+
     std::unique_ptr<logger> logger_instance(create_logger(std::vector<std::pair<std::string, logger::severity>>
                                                     {
                                                             {
@@ -199,6 +215,108 @@ TEST(positiveTests, test53)
     }
 }
 
+TEST(positiveTests, test6)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "block layout depends on allocator guards overhead";
+    }
+
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_buddies_system(10, nullptr, nullptr,
+                                                               allocator_with_fit_mode::fit_mode::first_fit));
+    auto *the_same_subject = dynamic_cast<allocator_with_fit_mode *>(alloc.get());
+
+    // occupied block metadata is padded to 16 bytes, so a 32-byte block holds at most 16 bytes of payload
+    auto first_block = alloc->allocate(100);
+    auto second_block = alloc->allocate(10);
+
+    std::vector<allocator_test_utils::block_info> expected_blocks_state
+        {
+            { .block_size = 128, .is_block_occupied = true },
+            { .block_size = 32, .is_block_occupied = true },
+            { .block_size = 32, .is_block_occupied = false },
+            { .block_size = 64, .is_block_occupied = false },
+            { .block_size = 256, .is_block_occupied = false },
+            { .block_size = 512, .is_block_occupied = false }
+        };
+
+    ASSERT_EQ(dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info(), expected_blocks_state);
+
+    the_same_subject->set_fit_mode(allocator_with_fit_mode::fit_mode::the_worst_fit);
+    auto third_block = alloc->allocate(10);
+
+    ASSERT_EQ(reinterpret_cast<char *>(third_block) - reinterpret_cast<char *>(first_block), 512);
+
+    the_same_subject->set_fit_mode(allocator_with_fit_mode::fit_mode::the_best_fit);
+    auto fourth_block = alloc->allocate(10);
+
+    ASSERT_EQ(reinterpret_cast<char *>(fourth_block) - reinterpret_cast<char *>(third_block), 32);
+
+    alloc->deallocate(second_block, 1);
+    alloc->deallocate(fourth_block, 1);
+    alloc->deallocate(third_block, 1);
+    alloc->deallocate(first_block, 1);
+
+    expected_blocks_state = { { .block_size = 1024, .is_block_occupied = false } };
+
+    ASSERT_EQ(dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info(), expected_blocks_state);
+}
+
+TEST(positiveTests, test7)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_buddies_system(16));
+
+    std::vector<std::pair<void *, size_t>> allocated_blocks;
+    srand((unsigned) time(nullptr));
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (rand() % 2 == 0)
+        {
+            try
+            {
+                size_t size = rand() % 1000;
+                auto *block = alloc->allocate(size);
+                memset(block, static_cast<int>(size % 256), size);
+                allocated_blocks.emplace_back(block, size);
+            }
+            catch (std::bad_alloc const &)
+            {
+            }
+        }
+        else if (!allocated_blocks.empty())
+        {
+            size_t index = rand() % allocated_blocks.size();
+            auto [block, size] = allocated_blocks[index];
+
+            for (size_t j = 0; j < size; ++j)
+            {
+                ASSERT_EQ(reinterpret_cast<unsigned char *>(block)[j], static_cast<unsigned char>(size % 256));
+            }
+
+            alloc->deallocate(block, 1);
+            allocated_blocks[index] = allocated_blocks.back();
+            allocated_blocks.pop_back();
+        }
+    }
+
+    for (auto [block, size] : allocated_blocks)
+    {
+        alloc->deallocate(block, 1);
+    }
+
+    std::vector<allocator_test_utils::block_info> expected_blocks_state { { .block_size = 1 << 16, .is_block_occupied = false } };
+
+    ASSERT_EQ(dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info(), expected_blocks_state);
+}
+
+TEST(positiveTests, test8)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_buddies_system(16));
+
+    ASSERT_EQ(allocator_test_utils::check_alignments(*alloc), "");
+}
+
 TEST(falsePositiveTests, test1)
 {
     ASSERT_THROW(new allocator_buddies_system(static_cast<int>(std::floor(std::log2(sizeof(allocator_dbg_helper::block_pointer_t) * 2 + 1))) - 1), std::logic_error);
@@ -0,0 +1,150 @@
+#include <allocator_global_heap.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * What allocator_global_heap used to be: every call goes to ::operator new / ::operator delete.
+ */
+class forwarding_mem_resource final : public smart_mem_resource
+{
+    void *do_allocate_sm(size_t size) override
+    {
+        return ::operator new(size);
+    }
+
+    void do_deallocate_sm(void *at) override
+    {
+        ::operator delete(at);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/**
+ * Bounded single producer single consumer queue of allocated blocks.
+ */
+class blocks_channel final
+{
+    static constexpr const size_t capacity = 1024;
+
+    std::array<std::pair<void *, size_t>, capacity> _blocks;
+
+    alignas(64) std::atomic<size_t> _head{0};
+
+    alignas(64) std::atomic<size_t> _tail{0};
+
+public:
+
+    void push(void *block, size_t size)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+
+        while (tail - _head.load(std::memory_order_acquire) == capacity)
+        {
+            std::this_thread::yield();
+        }
+
+        _blocks[tail % capacity] = { block, size };
+        _tail.store(tail + 1, std::memory_order_release);
+    }
+
+    std::pair<void *, size_t> pop()
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+
+        while (_tail.load(std::memory_order_acquire) == head)
+        {
+            std::this_thread::yield();
+        }
+
+        auto result = _blocks[head % capacity];
+        _head.store(head + 1, std::memory_order_release);
+
+        return result;
+    }
+};
+
+/**
+ * Every producer allocates objects and hands them to its consumer, which frees them,
+ * so every deallocation happens on a thread other than the allocating one.
+ */
+double run(std::pmr::memory_resource &resource, size_t pairs_count, size_t objects_per_producer)
+{
+    std::vector<blocks_channel> channels(pairs_count);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t p = 0; p < pairs_count; ++p)
+    {
+        threads.emplace_back([&resource, &channel = channels[p], objects_per_producer, p]()
+        {
+            std::mt19937 generator(p);
+            std::uniform_int_distribution<size_t> size_distribution(16, 512);
+
+            for (size_t i = 0; i < objects_per_producer; ++i)
+            {
+                size_t size = size_distribution(generator);
+                auto *block = reinterpret_cast<unsigned char *>(resource.allocate(size));
+                block[0] = static_cast<unsigned char>(i);
+                channel.push(block, size);
+            }
+        });
+
+        threads.emplace_back([&resource, &channel = channels[p], objects_per_producer]()
+        {
+            for (size_t i = 0; i < objects_per_producer; ++i)
+            {
+                auto [block, size] = channel.pop();
+                resource.deallocate(block, size);
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(pairs_count * objects_per_producer) / elapsed.count();
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    size_t max_pairs = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency() / 2);
+    size_t objects_per_producer = argc > 2 ? std::stoul(argv[2]) : 1'000'000;
+
+    std::cout << std::setw(8) << "pairs"
+              << std::setw(22) << "operator new obj/sec"
+              << std::setw(22) << "global heap obj/sec"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t pairs_count = 1; pairs_count <= max_pairs; pairs_count *= 2)
+    {
+        forwarding_mem_resource forwarding;
+        double forwarded = run(forwarding, pairs_count, objects_per_producer);
+
+        allocator_global_heap heap;
+        double heaped = run(heap, pairs_count, objects_per_producer);
+
+        std::cout << std::setw(8) << pairs_count
+                  << std::setw(22) << std::fixed << std::setprecision(0) << forwarded
+                  << std::setw(22) << heaped
+                  << std::setw(10) << std::setprecision(2) << heaped / forwarded << std::endl;
+    }
+
+    return 0;
+}
@@ -5,21 +5,156 @@
 #include <logger.h>
 #include <logger_guardant.h>
 #include <pp_allocator.h>
+#include <allocator_with_statistics.h>
 #include <typename_holder.h>
+#include <array>
+#include <atomic>
 
+/**
+ * Process wide heap shared by all instances: any instance may free block allocated by another one.
+ * Small requests are served from per-thread arenas carved out of chunks taken from ::operator new,
+ * so allocation and local deallocation take no locks at all.
+ * Block freed by thread other than the owner of its arena is pushed onto lock-free remote free stack of that arena,
+ * owner takes the whole stack at once when its local free list runs dry.
+ * Arena of exited thread is adopted by the next new thread together with all its blocks;
+ * blocks freed by the exiting thread after its arena is given away take the remote path,
+ * blocks it allocates then are served like large ones.
+ * Requests bigger than max_size_class go straight to ::operator new.
+ *
+ * Retention: chunk goes back to ::operator delete once every block carved from it is free again, except the chunk
+ * its arena is still carving from and up to max_spare_chunks free chunks kept per arena, so a steady allocate/free
+ * pattern does not return and take chunks all the time. Blocks freed remotely count as free once the owner drains them,
+ * a remote free into an arena nobody owns drains it at once. Exiting thread gives back all chunks without live blocks.
+ * Arena records themselves are kept for reuse, there are never more of them than threads that used the heap at once.
+ *
+ * Statistics are process wide as the heap is, so they do not depend on the instance used. Every thread counts
+ * in its own arena with plain stores and get_statistics sums the arenas up; peak bytes in use is published
+ * once a thread's balance moves by chunk_size, so it may miss shorter peaks by that much per thread.
+ */
 class allocator_global_heap final:
     private allocator_dbg_helper,
     public smart_mem_resource,
+    public allocator_with_statistics,
     private logger_guardant,
     private typename_holder
 {
 
+public:
+
+    static constexpr const size_t min_size_class_power = 4;
+
+    static constexpr const size_t size_classes_count = 9;
+
+    static constexpr const size_t max_size_class = size_t(1) << (min_size_class_power + size_classes_count - 1);
+
+    static constexpr const size_t chunk_size = size_t(1) << 16;
+
 private:
     
     logger *_logger;
 
     static constexpr const size_t size_t_size = sizeof(size_t);
 
+    /**
+     * Owner arena (nullptr for large blocks) and size class index with offset from its chunk start
+     * or requested size for large blocks.
+     * Header is padded so payload stays aligned by alignof(std::max_align_t)
+     */
+    static constexpr const size_t block_metadata_size = (sizeof(void*) + size_t_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    static constexpr const size_t chunk_offset_shift = 8;
+
+    static constexpr const size_t max_spare_chunks = 4;
+
+    /**
+     * Count of blocks carved from chunk and not lying in free lists of its arena, changed by owner only
+     */
+    static constexpr const size_t chunk_metadata_size = (size_t_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    static constexpr const size_t cache_line_size = 64;
+
+    /**
+     * Written only by the thread owning the arena, read by anyone; bytes in use of one arena may wrap below zero
+     * when it frees blocks of other arenas, only their sum makes sense
+     */
+    struct arena_counters
+    {
+        std::atomic<size_t> allocations{0};
+
+        std::atomic<size_t> deallocations{0};
+
+        std::atomic<size_t> failed_allocations{0};
+
+        std::atomic<size_t> bytes_in_use{0};
+
+        std::array<std::atomic<size_t>, request_size_histogram_size> request_size_histogram{};
+
+        /**
+         * Change of bytes in use not yet added to _published_bytes_in_use, unused in orphan counters
+         */
+        size_t unpublished_bytes = 0;
+    };
+
+    struct arena
+    {
+        /**
+         * Pushed by any thread, taken as a whole by owner only, so there is no ABA problem
+         */
+        alignas(cache_line_size) std::atomic<void*> remote_free{nullptr};
+
+        alignas(cache_line_size) std::array<void*, size_classes_count> local_free{};
+
+        unsigned char *chunk_begin = nullptr;
+
+        unsigned char *chunk_top = nullptr;
+
+        unsigned char *chunk_end = nullptr;
+
+        /**
+         * Chunks other than the carving one without live blocks
+         */
+        size_t spare_chunks = 0;
+
+        std::atomic<bool> in_use{true};
+
+        arena *next = nullptr;
+
+        alignas(cache_line_size) arena_counters counters;
+    };
+
+    /**
+     * Gives arena of exiting thread away for adoption
+     */
+    class arena_holder final
+    {
+
+    public:
+
+        ~arena_holder();
+    };
+
+    static std::atomic<arena*> _arenas;
+
+    static std::atomic<size_t> _chunk_bytes;
+
+    static std::atomic<size_t> _published_bytes_in_use;
+
+    static std::atomic<size_t> _peak_bytes_in_use;
+
+    /**
+     * Counted with atomic additions by threads that have already given their arena away
+     */
+    static arena_counters _orphan_counters;
+
+    /**
+     * Trivially destructible, so it stays valid while other thread_local destructors of the thread still free blocks
+     */
+    static thread_local arena *_local_arena;
+
+    static thread_local bool _local_arena_released;
+
+    static thread_local arena_holder _local_arena_holder;
+
 public:
     
     explicit allocator_global_heap(
@@ -47,12 +182,118 @@ public:
     void do_deallocate_sm(
         void *at) override;
 
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size,
+        size_t alignment) override;
+
+    void do_deallocate_sm(
+        void *at,
+        size_t alignment) override;
+
     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
 
+    statistics get_statistics() const noexcept override;
+
+public:
+
+    /**
+     * Bytes of chunks all arenas currently hold
+     */
+    static size_t chunk_bytes() noexcept;
+
 private:
     
     inline logger *get_logger() const override;
 
+    static size_t size_class_index(size_t size) noexcept;
+
+    static size_t size_class_size(size_t index) noexcept;
+
+    static void *&block_owner_ref(void *block) noexcept;
+
+    static size_t &block_size_ref(void *block) noexcept;
+
+    static void *&free_next_ref(void *block) noexcept;
+
+    static size_t block_index(void *block) noexcept;
+
+    static unsigned char *block_chunk(void *block) noexcept;
+
+    static size_t &chunk_live_ref(unsigned char *chunk) noexcept;
+
+    /**
+     * Arena of calling thread, taken or created on first call, nullptr once the thread has given it away
+     */
+    static arena *acquire_local_arena();
+
+    /**
+     * Moves blocks from remote free stack into local free lists
+     */
+    static void drain_remote(arena &a) noexcept;
+
+    static void *pop_local(arena &a, size_t index) noexcept;
+
+    /**
+     * Puts block into local free list, releases its chunk if that was the last live block of it
+     */
+    static void push_local(arena &a, void *block) noexcept;
+
+    /**
+     * Keeps chunk without live blocks as spare or releases it if arena has enough of them
+     */
+    static void retire_chunk(arena &a, unsigned char *chunk) noexcept;
+
+    /**
+     * Takes every block of chunk out of local free lists and returns chunk to ::operator delete
+     */
+    static void release_chunk(arena &a, unsigned char *chunk) noexcept;
+
+    /**
+     * Drains remote frees and releases every chunk without live blocks, called by owner of arena
+     * that is about to stay unused
+     */
+    static void trim(arena &a) noexcept;
+
+    void *carve(arena &a, size_t index);
+
+    void *allocate_large(size_t size);
+
+    /**
+     * Counters of calling thread's arena, orphan counters if the thread has none and can't get one
+     */
+    static arena_counters &local_counters() noexcept;
+
+    /**
+     * Plain store for counters of own arena, atomic addition for orphan ones
+     */
+    static void add(
+        arena_counters &counters,
+        std::atomic<size_t> &counter,
+        size_t value) noexcept;
+
+    static void count_allocation(
+        size_t requested_size,
+        size_t block_size) noexcept;
+
+    static void count_failed_allocation(
+        size_t requested_size) noexcept;
+
+    static void count_deallocation(
+        size_t block_size) noexcept;
+
+    /**
+     * Adds balance kept as size_t modulo arithmetic to _published_bytes_in_use and raises the peak
+     */
+    static void publish_bytes_in_use(
+        size_t balance) noexcept;
+
+    /**
+     * Changes bytes in use by delta, publishing own balance once it moves by chunk_size, orphan one at once
+     */
+    static void count_bytes_in_use(
+        arena_counters &counters,
+        size_t delta) noexcept;
+
 private:
     
     inline std::string get_typename() const override;
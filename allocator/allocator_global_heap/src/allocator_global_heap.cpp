@@ -1,60 +1,651 @@
-#include <not_implemented.h>
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <utility>
 #include "../include/allocator_global_heap.h"
 
 allocator_global_heap::allocator_global_heap(
-    logger *logger)
+    logger *logger):
+    _logger(logger)
 {
-    throw not_implemented("allocator_global_heap::allocator_global_heap(logger *)", "your code should be here...");
+    debug_with_guard(get_typename() + ": created");
 }
 
+std::atomic<allocator_global_heap::arena *> allocator_global_heap::_arenas{nullptr};
+
+std::atomic<size_t> allocator_global_heap::_chunk_bytes{0};
+
+std::atomic<size_t> allocator_global_heap::_published_bytes_in_use{0};
+
+std::atomic<size_t> allocator_global_heap::_peak_bytes_in_use{0};
+
+allocator_global_heap::arena_counters allocator_global_heap::_orphan_counters;
+
+thread_local allocator_global_heap::arena *allocator_global_heap::_local_arena = nullptr;
+
+thread_local bool allocator_global_heap::_local_arena_released = false;
+
+thread_local allocator_global_heap::arena_holder allocator_global_heap::_local_arena_holder;
+
 [[nodiscard]] void *allocator_global_heap::do_allocate_sm(
     size_t size)
 {
-    throw not_implemented("[[nodiscard]] void *allocator_global_heap::do_allocate_sm(size_t)", "your code should be here...");
+    size_t index = size_class_index(size);
+
+    arena *local = index == size_classes_count ? nullptr : acquire_local_arena();
+
+    if (local == nullptr)
+    {
+        return allocate_large(size);
+    }
+
+    arena &a = *local;
+    void *block = pop_local(a, index);
+
+    if (block == nullptr)
+    {
+        drain_remote(a);
+        block = pop_local(a, index);
+    }
+
+    if (block == nullptr)
+    {
+        try
+        {
+            block = carve(a, index);
+        }
+        catch (std::bad_alloc const &)
+        {
+            count_failed_allocation(size);
+            throw;
+        }
+    }
+
+    count_allocation(size, block_metadata_size + size_class_size(index));
+
+    return reinterpret_cast<unsigned char *>(block) + block_metadata_size;
 }
 
 void allocator_global_heap::do_deallocate_sm(
     void *at)
 {
-    throw not_implemented("void allocator_global_heap::do_deallocate_sm(void *)", "your code should be here...");
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    void *block = reinterpret_cast<unsigned char *>(at) - block_metadata_size;
+    auto *owner = reinterpret_cast<arena *>(block_owner_ref(block));
+
+    if (owner == nullptr)
+    {
+        debug_with_guard([&] { return get_typename() + ": deallocating " + std::to_string(block_size_ref(block)) + " bytes"; });
+
+        count_deallocation(block_metadata_size + block_size_ref(block));
+        ::operator delete(block);
+        return;
+    }
+
+    count_deallocation(block_metadata_size + size_class_size(block_index(block)));
+
+    if (owner == _local_arena)
+    {
+        push_local(*owner, block);
+        return;
+    }
+
+    void *head = owner->remote_free.load(std::memory_order_relaxed);
+
+    do
+    {
+        free_next_ref(block) = head;
+    }
+    while (!owner->remote_free.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+
+    // nobody would drain arena of exited thread until it is adopted, so its chunks are given back right here
+    bool in_use = false;
+
+    if (!owner->in_use.load(std::memory_order_relaxed) && owner->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+    {
+        trim(*owner);
+        owner->in_use.store(false, std::memory_order_release);
+    }
+}
+
+void *allocator_global_heap::allocate_large(
+    size_t size)
+{
+    debug_with_guard([&] { return get_typename() + ": allocating " + std::to_string(size) + " bytes"; });
+
+    void *block;
+
+    try
+    {
+        block = ::operator new(size + block_metadata_size);
+    }
+    catch (std::bad_alloc const &)
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        count_failed_allocation(size);
+        throw;
+    }
+
+    block_owner_ref(block) = nullptr;
+    block_size_ref(block) = size;
+    count_allocation(size, block_metadata_size + size);
+
+    return reinterpret_cast<unsigned char *>(block) + block_metadata_size;
+}
+
+void *allocator_global_heap::carve(
+    arena &a,
+    size_t index)
+{
+    size_t stride = block_metadata_size + size_class_size(index);
+
+    if (static_cast<size_t>(a.chunk_end - a.chunk_top) < stride)
+    {
+        unsigned char *chunk;
+
+        try
+        {
+            chunk = reinterpret_cast<unsigned char *>(::operator new(chunk_size));
+        }
+        catch (std::bad_alloc const &)
+        {
+            error_with_guard(get_typename() + ": can't allocate chunk of " + std::to_string(chunk_size) + " bytes");
+            throw;
+        }
+
+        unsigned char *previous = a.chunk_begin;
+
+        _chunk_bytes.fetch_add(chunk_size, std::memory_order_relaxed);
+        chunk_live_ref(chunk) = 0;
+        a.chunk_begin = chunk;
+        a.chunk_top = chunk + chunk_metadata_size;
+        a.chunk_end = chunk + chunk_size;
+
+        if (previous != nullptr && chunk_live_ref(previous) == 0)
+        {
+            retire_chunk(a, previous);
+        }
+
+        debug_with_guard(get_typename() + ": arena got new chunk of " + std::to_string(chunk_size) + " bytes");
+    }
+
+    void *block = a.chunk_top;
+    a.chunk_top += stride;
+
+    block_owner_ref(block) = &a;
+    block_size_ref(block) = index | (static_cast<size_t>(reinterpret_cast<unsigned char *>(block) - a.chunk_begin) << chunk_offset_shift);
+    ++chunk_live_ref(a.chunk_begin);
+
+    return block;
+}
+
+void allocator_global_heap::drain_remote(
+    arena &a) noexcept
+{
+    void *block = a.remote_free.exchange(nullptr, std::memory_order_acquire);
+
+    while (block != nullptr)
+    {
+        void *next = free_next_ref(block);
+
+        push_local(a, block);
+        block = next;
+    }
+}
+
+void *allocator_global_heap::pop_local(
+    arena &a,
+    size_t index) noexcept
+{
+    void *block = a.local_free[index];
+
+    if (block != nullptr)
+    {
+        unsigned char *chunk = block_chunk(block);
+
+        a.local_free[index] = free_next_ref(block);
+
+        if (chunk_live_ref(chunk)++ == 0 && chunk != a.chunk_begin)
+        {
+            --a.spare_chunks;
+        }
+    }
+
+    return block;
+}
+
+void allocator_global_heap::push_local(
+    arena &a,
+    void *block) noexcept
+{
+    size_t index = block_index(block);
+    unsigned char *chunk = block_chunk(block);
+
+    free_next_ref(block) = a.local_free[index];
+    a.local_free[index] = block;
+
+    if (--chunk_live_ref(chunk) == 0 && chunk != a.chunk_begin)
+    {
+        retire_chunk(a, chunk);
+    }
+}
+
+void allocator_global_heap::retire_chunk(
+    arena &a,
+    unsigned char *chunk) noexcept
+{
+    if (a.spare_chunks < max_spare_chunks)
+    {
+        ++a.spare_chunks;
+    }
+    else
+    {
+        release_chunk(a, chunk);
+    }
+}
+
+void allocator_global_heap::release_chunk(
+    arena &a,
+    unsigned char *chunk) noexcept
+{
+    for (auto &head : a.local_free)
+    {
+        void **link = &head;
+
+        while (*link != nullptr)
+        {
+            if (block_chunk(*link) == chunk)
+            {
+                *link = free_next_ref(*link);
+            }
+            else
+            {
+                link = &free_next_ref(*link);
+            }
+        }
+    }
+
+    if (chunk == a.chunk_begin)
+    {
+        a.chunk_begin = a.chunk_top = a.chunk_end = nullptr;
+    }
+
+    ::operator delete(chunk);
+    _chunk_bytes.fetch_sub(chunk_size, std::memory_order_relaxed);
+}
+
+void allocator_global_heap::trim(
+    arena &a) noexcept
+{
+    drain_remote(a);
+
+    if (a.chunk_begin != nullptr && chunk_live_ref(a.chunk_begin) == 0)
+    {
+        release_chunk(a, a.chunk_begin);
+    }
+
+    // spare chunks are found through their free blocks, there is at most max_spare_chunks of them
+    for (size_t index = 0; a.spare_chunks != 0 && index < size_classes_count; )
+    {
+        void *block = a.local_free[index];
+
+        while (block != nullptr && chunk_live_ref(block_chunk(block)) != 0)
+        {
+            block = free_next_ref(block);
+        }
+
+        if (block == nullptr)
+        {
+            ++index;
+            continue;
+        }
+
+        release_chunk(a, block_chunk(block));
+        --a.spare_chunks;
+    }
+}
+
+size_t allocator_global_heap::chunk_bytes() noexcept
+{
+    return _chunk_bytes.load(std::memory_order_relaxed);
+}
+
+allocator_global_heap::arena_counters &allocator_global_heap::local_counters() noexcept
+{
+    arena *local = _local_arena;
+
+    if (local == nullptr)
+    {
+        try
+        {
+            local = acquire_local_arena();
+        }
+        catch (std::bad_alloc const &)
+        {
+        }
+    }
+
+    return local == nullptr ? _orphan_counters : local->counters;
+}
+
+void allocator_global_heap::add(
+    arena_counters &counters,
+    std::atomic<size_t> &counter,
+    size_t value) noexcept
+{
+    if (&counters == &_orphan_counters)
+    {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+    else
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+}
+
+void allocator_global_heap::count_allocation(
+    size_t requested_size,
+    size_t block_size) noexcept
+{
+    auto &counters = local_counters();
+
+    add(counters, counters.request_size_histogram[histogram_bucket(requested_size)], 1);
+    add(counters, counters.allocations, 1);
+    count_bytes_in_use(counters, block_size);
+}
+
+void allocator_global_heap::count_failed_allocation(
+    size_t requested_size) noexcept
+{
+    auto &counters = local_counters();
+
+    add(counters, counters.request_size_histogram[histogram_bucket(requested_size)], 1);
+    add(counters, counters.failed_allocations, 1);
+}
+
+void allocator_global_heap::count_deallocation(
+    size_t block_size) noexcept
+{
+    auto &counters = local_counters();
+
+    add(counters, counters.deallocations, 1);
+    count_bytes_in_use(counters, 0 - block_size);
+}
+
+void allocator_global_heap::count_bytes_in_use(
+    arena_counters &counters,
+    size_t delta) noexcept
+{
+    add(counters, counters.bytes_in_use, delta);
+
+    if (&counters == &_orphan_counters)
+    {
+        publish_bytes_in_use(delta);
+
+        return;
+    }
+
+    counters.unpublished_bytes += delta;
+
+    auto balance = static_cast<ptrdiff_t>(counters.unpublished_bytes);
+
+    if (balance >= static_cast<ptrdiff_t>(chunk_size) || balance <= -static_cast<ptrdiff_t>(chunk_size))
+    {
+        publish_bytes_in_use(std::exchange(counters.unpublished_bytes, 0));
+    }
+}
+
+void allocator_global_heap::publish_bytes_in_use(
+    size_t balance) noexcept
+{
+    size_t in_use = _published_bytes_in_use.fetch_add(balance, std::memory_order_relaxed) + balance;
+    size_t peak = _peak_bytes_in_use.load(std::memory_order_relaxed);
+
+    while (static_cast<ptrdiff_t>(in_use) > static_cast<ptrdiff_t>(peak) &&
+           !_peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+    {
+    }
+}
+
+allocator_with_statistics::statistics allocator_global_heap::get_statistics() const noexcept
+{
+    statistics result{};
+
+    auto collect = [&result](arena_counters const &counters)
+    {
+        result.allocations += counters.allocations.load(std::memory_order_relaxed);
+        result.deallocations += counters.deallocations.load(std::memory_order_relaxed);
+        result.failed_allocations += counters.failed_allocations.load(std::memory_order_relaxed);
+        result.bytes_in_use += counters.bytes_in_use.load(std::memory_order_relaxed);
+
+        for (size_t k = 0; k < request_size_histogram_size; ++k)
+        {
+            result.request_size_histogram[k] += counters.request_size_histogram[k].load(std::memory_order_relaxed);
+        }
+    };
+
+    for (arena *a = _arenas.load(std::memory_order_acquire); a != nullptr; a = a->next)
+    {
+        collect(a->counters);
+    }
+
+    collect(_orphan_counters);
+
+    result.peak_bytes_in_use = std::max(_peak_bytes_in_use.load(std::memory_order_relaxed), result.bytes_in_use);
+
+    return result;
+}
+
+size_t allocator_global_heap::size_class_index(
+    size_t size) noexcept
+{
+    if (size > max_size_class)
+    {
+        return size_classes_count;
+    }
+
+    return std::bit_width(std::max(size, size_t(1) << min_size_class_power) - 1) - min_size_class_power;
+}
+
+size_t allocator_global_heap::size_class_size(
+    size_t index) noexcept
+{
+    return size_t(1) << (index + min_size_class_power);
+}
+
+void *&allocator_global_heap::block_owner_ref(
+    void *block) noexcept
+{
+    return *reinterpret_cast<void **>(block);
+}
+
+size_t &allocator_global_heap::block_size_ref(
+    void *block) noexcept
+{
+    return *reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(block) + sizeof(void *));
+}
+
+void *&allocator_global_heap::free_next_ref(
+    void *block) noexcept
+{
+    return *reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(block) + block_metadata_size);
+}
+
+size_t allocator_global_heap::block_index(
+    void *block) noexcept
+{
+    return block_size_ref(block) & ((size_t(1) << chunk_offset_shift) - 1);
+}
+
+unsigned char *allocator_global_heap::block_chunk(
+    void *block) noexcept
+{
+    return reinterpret_cast<unsigned char *>(block) - (block_size_ref(block) >> chunk_offset_shift);
+}
+
+size_t &allocator_global_heap::chunk_live_ref(
+    unsigned char *chunk) noexcept
+{
+    return *reinterpret_cast<size_t *>(chunk);
+}
+
+allocator_global_heap::arena_holder::~arena_holder()
+{
+    arena *a = _local_arena;
+
+    // blocks freed later in thread teardown must not see the arena as local once another thread may adopt it
+    _local_arena = nullptr;
+    _local_arena_released = true;
+
+    if (a != nullptr)
+    {
+        trim(*a);
+        publish_bytes_in_use(std::exchange(a->counters.unpublished_bytes, 0));
+        a->in_use.store(false, std::memory_order_release);
+    }
+}
+
+allocator_global_heap::arena *allocator_global_heap::acquire_local_arena()
+{
+    if (_local_arena != nullptr || _local_arena_released)
+    {
+        return _local_arena;
+    }
+
+    arena *found = nullptr;
+
+    for (arena *a = _arenas.load(std::memory_order_acquire); a != nullptr; a = a->next)
+    {
+        bool in_use = false;
+
+        if (!a->in_use.load(std::memory_order_relaxed) && a->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+        {
+            found = a;
+            break;
+        }
+    }
+
+    if (found == nullptr)
+    {
+        found = new arena();
+        found->next = _arenas.load(std::memory_order_relaxed);
+
+        while (!_arenas.compare_exchange_weak(found->next, found, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // first use of the holder registers its destructor for this thread
+    static_cast<void>(&_local_arena_holder);
+
+    return _local_arena = found;
+}
+
+[[nodiscard]] void *allocator_global_heap::do_allocate_sm(
+    size_t size,
+    size_t alignment)
+{
+    if (!is_extended_alignment(alignment))
+    {
+        return do_allocate_sm(size);
+    }
+
+    debug_with_guard([&] { return get_typename() + ": allocating " + std::to_string(size) + " bytes aligned by " + std::to_string(alignment); });
+
+    unsigned char *block;
+
+    try
+    {
+        block = reinterpret_cast<unsigned char *>(::operator new(size + alignment, std::align_val_t(alignment)));
+    }
+    catch (std::bad_alloc const &)
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes aligned by " + std::to_string(alignment));
+        count_failed_allocation(size);
+        throw;
+    }
+
+    *reinterpret_cast<size_t *>(block + alignment - size_t_size) = size;
+    count_allocation(size, size + alignment);
+
+    return block + alignment;
+}
+
+void allocator_global_heap::do_deallocate_sm(
+    void *at,
+    size_t alignment)
+{
+    if (!is_extended_alignment(alignment))
+    {
+        do_deallocate_sm(at);
+        return;
+    }
+
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    auto *block = reinterpret_cast<unsigned char *>(at) - alignment;
+
+    debug_with_guard([&] { return get_typename() + ": deallocating " + std::to_string(*reinterpret_cast<size_t *>(block + alignment - size_t_size)) + " bytes aligned by " + std::to_string(alignment); });
+
+    count_deallocation(*reinterpret_cast<size_t *>(block + alignment - size_t_size) + alignment);
+
+    ::operator delete(block, std::align_val_t(alignment));
 }
 
 inline logger *allocator_global_heap::get_logger() const
 {
-    throw not_implemented("inline logger *allocator_global_heap::get_logger() const", "your code should be here...");
+    return _logger;
 }
 
 inline std::string allocator_global_heap::get_typename() const
 {
-    throw not_implemented("inline std::string allocator_global_heap::get_typename() const", "your code should be here...");
+    return "allocator_global_heap";
 }
 
 allocator_global_heap::~allocator_global_heap()
 {
-    throw not_implemented("allocator_global_heap::~allocator_global_heap()", "your code should be here...");
+    debug_with_guard(get_typename() + ": destroyed");
 }
 
-allocator_global_heap::allocator_global_heap(const allocator_global_heap &other)
+allocator_global_heap::allocator_global_heap(const allocator_global_heap &other):
+    _logger(other._logger)
 {
-    throw not_implemented("allocator_global_heap::allocator_global_heap(const allocator_global_heap &other)", "your code should be here...");
 }
 
 allocator_global_heap &allocator_global_heap::operator=(const allocator_global_heap &other)
 {
-    throw not_implemented("allocator_global_heap &allocator_global_heap::operator=(const allocator_global_heap &other)", "your code should be here...");
+    _logger = other._logger;
+
+    return *this;
 }
 
 bool allocator_global_heap::do_is_equal(const std::pmr::memory_resource &other) const noexcept
 {
-    throw not_implemented("bool allocator_global_heap::do_is_equal(const std::pmr::memory_resource &other) const noexcept", "your code should be here...");
+    return dynamic_cast<const allocator_global_heap *>(&other) != nullptr;
 }
 
-allocator_global_heap::allocator_global_heap(allocator_global_heap &&other) noexcept
+allocator_global_heap::allocator_global_heap(allocator_global_heap &&other) noexcept:
+    allocator_with_statistics(std::move(other)),
+    _logger(other._logger)
 {
-    throw not_implemented("allocator_global_heap::allocator_global_heap(allocator_global_heap &&) noexcept", "your code should be here...");
+    other._logger = nullptr;
 }
 
 allocator_global_heap &allocator_global_heap::operator=(allocator_global_heap &&other) noexcept
 {
-    throw not_implemented("allocator_global_heap &allocator_global_heap::operator=(allocator_global_heap &&) noexcept", "your code should be here...");
+    if (this != &other)
+    {
+        allocator_with_statistics::operator=(std::move(other));
+        _logger = other._logger;
+        other._logger = nullptr;
+    }
+
+    return *this;
 }
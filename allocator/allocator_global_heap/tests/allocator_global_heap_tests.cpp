@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <thread>
 #include <allocator_global_heap.h>
+#include <allocator_test_utils.h>
 #include <client_logger_builder.h>
 
 TEST(allocatorGlobalHeapTests, test1)
@@ -77,6 +79,156 @@ TEST(allocatorGlobalHeapTests, test4)
     allocator_instance->deallocate(second_block, 1);
 }
 
+TEST(allocatorGlobalHeapTests, test5)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_global_heap);
+
+    ASSERT_EQ(allocator_test_utils::check_alignments(*alloc), "");
+}
+
+TEST(allocatorGlobalHeapTests, test6)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_global_heap);
+
+    std::vector<std::pair<unsigned char *, size_t>> blocks;
+
+    for (size_t round = 0; round < 4; ++round)
+    {
+        std::thread producer([&]()
+        {
+            for (size_t i = 0; i < 5000; ++i)
+            {
+                size_t size = 1 + (i * 37) % 5000;
+                auto *block = reinterpret_cast<unsigned char *>(alloc->allocate(size));
+
+                memset(block, static_cast<int>(i % 256), size);
+                blocks.emplace_back(block, size);
+            }
+        });
+        producer.join();
+
+        std::thread consumer([&]()
+        {
+            for (size_t i = 0; i < blocks.size(); ++i)
+            {
+                auto [block, size] = blocks[i];
+
+                ASSERT_EQ(block[0], static_cast<unsigned char>(i % 256));
+                ASSERT_EQ(block[size - 1], static_cast<unsigned char>(i % 256));
+
+                alloc->deallocate(block, size);
+            }
+        });
+        consumer.join();
+
+        blocks.clear();
+    }
+}
+
+TEST(allocatorGlobalHeapTests, test7)
+{
+    struct deferred_free
+    {
+        std::pmr::memory_resource *resource = nullptr;
+
+        void *block = nullptr;
+
+        ~deferred_free()
+        {
+            if (block != nullptr)
+            {
+                resource->deallocate(block, 24);
+                resource->deallocate(resource->allocate(24), 24);
+            }
+        }
+    };
+
+    allocator_global_heap alloc;
+
+    for (size_t round = 0; round < 4; ++round)
+    {
+        std::thread([&alloc]()
+        {
+            // constructed before the thread gets its arena, so destroyed after the arena is given away
+            thread_local deferred_free pending;
+
+            pending.resource = &alloc;
+            pending.block = alloc.allocate(24);
+        }).join();
+
+        auto *block = reinterpret_cast<unsigned char *>(alloc.allocate(24));
+
+        memset(block, 0xFF, 24);
+        alloc.deallocate(block, 24);
+    }
+}
+
+TEST(allocatorGlobalHeapTests, test8)
+{
+    allocator_global_heap alloc;
+    std::vector<void *> blocks;
+    size_t initial = allocator_global_heap::chunk_bytes();
+
+    std::thread([&]()
+    {
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            blocks.push_back(alloc.allocate(16 + i % 200));
+        }
+    }).join();
+
+    ASSERT_GT(allocator_global_heap::chunk_bytes(), initial);
+
+    std::thread([&]()
+    {
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            alloc.deallocate(blocks[i], 16 + i % 200);
+        }
+    }).join();
+
+    ASSERT_EQ(allocator_global_heap::chunk_bytes(), initial);
+}
+
+TEST(allocatorGlobalHeapTests, test9)
+{
+    allocator_global_heap first;
+    allocator_global_heap second;
+    auto before = first.get_statistics();
+    std::vector<void *> blocks;
+
+    std::thread([&]()
+    {
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            blocks.push_back(first.allocate(16 + i % 300));
+        }
+    }).join();
+
+    auto allocated = second.get_statistics();
+
+    ASSERT_EQ(allocated.allocations - before.allocations, 1000);
+    ASSERT_GT(allocated.bytes_in_use, before.bytes_in_use);
+    ASSERT_GE(allocated.peak_bytes_in_use, allocated.bytes_in_use);
+
+    std::thread([&]()
+    {
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            second.deallocate(blocks[i], 16 + i % 300);
+        }
+    }).join();
+
+    auto after_first = first.get_statistics();
+    auto after_second = second.get_statistics();
+
+    ASSERT_EQ(after_first.deallocations - before.deallocations, 1000);
+    ASSERT_EQ(after_first.bytes_in_use, before.bytes_in_use);
+    ASSERT_EQ(after_second.bytes_in_use, before.bytes_in_use);
+    ASSERT_EQ(after_second.allocations, after_first.allocations);
+    ASSERT_GE(after_second.peak_bytes_in_use, allocated.bytes_in_use);
+}
+
 int main(
     int argc,
     char *argv[])
@@ -0,0 +1,445 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_GROWING_RESOURCE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_GROWING_RESOURCE_H
+
+#include <pp_allocator.h>
+#include <address_ranges.h>
+#include <allocator_test_utils.h>
+#include <allocator_with_fit_mode.h>
+#include <logger_guardant.h>
+#include <typename_holder.h>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+
+/**
+ * Grow-on-demand mode for any fixed-size allocator.
+ * Space is a list of chunks, each one is an allocator instance over its own space of chunk_space_size.
+ * When no chunk can serve a request, a new chunk is requested from parent allocator.
+ * Chunks that became fully free are released back to parent while more than max_free_chunks of them are kept.
+ * The first chunk is never released, so until it is exhausted the resource behaves just like a single allocator.
+ */
+template<typename allocator>
+class growing_resource final:
+    public smart_mem_resource,
+    public allocator_test_utils,
+    public allocator_with_fit_mode,
+    private logger_guardant,
+    private typename_holder
+{
+
+    static_assert(std::is_base_of_v<smart_mem_resource, allocator> && std::is_base_of_v<allocator_test_utils, allocator>);
+
+    static_assert(std::is_constructible_v<allocator, size_t, std::pmr::memory_resource*, logger*>);
+
+private:
+
+    struct chunk
+    {
+        /**
+         * Records the memory chunk got, so every deallocated pointer is mapped to its chunk by address
+         */
+        address_range_parent<chunk*> parent;
+
+        std::optional<allocator> instance;
+
+        size_t occupied_blocks_count = 0;
+
+        /**
+         * Smallest request this chunk failed to serve since its last deallocation,
+         * bigger ones are not tried there, so exhausted chunks do not throw again and again
+         */
+        size_t min_failed_request = std::numeric_limits<size_t>::max();
+
+        explicit chunk(growing_resource *owner);
+    };
+
+    std::pmr::memory_resource *_parent;
+
+    logger *_logger;
+
+    size_t _chunk_space_size;
+
+    size_t _max_free_chunks;
+
+    fit_mode _fit_mode;
+
+    /**
+     * Sealed after the first chunk, which is never released.
+     * Declared before chunks, since chunks remove their ranges when destroyed
+     */
+    address_ranges<chunk*> _ranges;
+
+    std::list<std::unique_ptr<chunk>> _chunks;
+
+    /**
+     * Chunk serving the last successful request is tried first
+     */
+    chunk *_current;
+
+    size_t _free_chunks_count;
+
+    mutable std::mutex _mutex;
+
+public:
+
+    explicit growing_resource(
+        size_t chunk_space_size,
+        std::pmr::memory_resource *parent_allocator = nullptr,
+        logger *logger = nullptr,
+        size_t max_free_chunks = 1,
+        allocator_with_fit_mode::fit_mode allocate_fit_mode = allocator_with_fit_mode::fit_mode::first_fit);
+
+    growing_resource(
+        growing_resource const &other) = delete;
+
+    growing_resource &operator=(
+        growing_resource const &other) = delete;
+
+    growing_resource(
+        growing_resource &&other) = delete;
+
+    growing_resource &operator=(
+        growing_resource &&other) = delete;
+
+    ~growing_resource() override = default;
+
+public:
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size) override;
+
+    void do_deallocate_sm(
+        void *at) override;
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size,
+        size_t alignment) override;
+
+    void do_deallocate_sm(
+        void *at,
+        size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+
+    inline void set_fit_mode(
+        allocator_with_fit_mode::fit_mode mode) override;
+
+    size_t chunks_count() const;
+
+public:
+
+    /**
+     * Blocks of all chunks in chunks order
+     */
+    std::vector<allocator_test_utils::block_info> get_blocks_info() const override;
+
+    std::vector<std::vector<allocator_test_utils::block_info>> get_chunks_blocks_info() const;
+
+private:
+
+    std::vector<allocator_test_utils::block_info> get_blocks_info_inner() const override;
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    chunk &add_chunk();
+
+    void release_chunk(chunk &released) noexcept;
+
+    chunk &chunk_of(void *at);
+
+    static void apply_fit_mode(chunk &target, fit_mode mode);
+};
+
+template<typename allocator>
+growing_resource<allocator>::chunk::chunk(growing_resource *owner):
+    parent(owner->_parent, &owner->_ranges, this)
+{
+}
+
+template<typename allocator>
+growing_resource<allocator>::growing_resource(
+    size_t chunk_space_size,
+    std::pmr::memory_resource *parent_allocator,
+    logger *logger,
+    size_t max_free_chunks,
+    allocator_with_fit_mode::fit_mode allocate_fit_mode):
+    _parent(parent_allocator == nullptr ? std::pmr::get_default_resource() : parent_allocator),
+    _logger(logger),
+    _chunk_space_size(chunk_space_size),
+    _max_free_chunks(max_free_chunks),
+    _fit_mode(allocate_fit_mode),
+    _current(nullptr),
+    _free_chunks_count(0)
+{
+    _current = &add_chunk();
+    _ranges.seal();
+
+    debug_with_guard(get_typename() + ": created with chunks of " + std::to_string(chunk_space_size) + " bytes of space");
+}
+
+template<typename allocator>
+[[nodiscard]] void *growing_resource<allocator>::do_allocate_sm(
+    size_t size)
+{
+    return do_allocate_sm(size, alignof(std::max_align_t));
+}
+
+template<typename allocator>
+void growing_resource<allocator>::do_deallocate_sm(
+    void *at)
+{
+    do_deallocate_sm(at, alignof(std::max_align_t));
+}
+
+template<typename allocator>
+[[nodiscard]] void *growing_resource<allocator>::do_allocate_sm(
+    size_t size,
+    size_t alignment)
+{
+    std::lock_guard lock(_mutex);
+
+    size_t request = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+    auto try_allocate = [this, size, alignment, request](chunk &target) -> void *
+    {
+        if (request >= target.min_failed_request)
+        {
+            return nullptr;
+        }
+
+        try
+        {
+            void *result = static_cast<std::pmr::memory_resource &>(*target.instance).allocate(size, alignment);
+
+            if (target.occupied_blocks_count++ == 0 && &target != _chunks.front().get())
+            {
+                --_free_chunks_count;
+            }
+
+            _current = &target;
+
+            return result;
+        }
+        catch (std::bad_alloc const &)
+        {
+            target.min_failed_request = request;
+
+            return nullptr;
+        }
+    };
+
+    if (void *result = try_allocate(*_current); result != nullptr)
+    {
+        return result;
+    }
+
+    for (auto &candidate : _chunks)
+    {
+        if (candidate.get() == _current)
+        {
+            continue;
+        }
+
+        if (void *result = try_allocate(*candidate); result != nullptr)
+        {
+            return result;
+        }
+    }
+
+    chunk *added;
+
+    try
+    {
+        added = &add_chunk();
+    }
+    catch (std::bad_alloc const &)
+    {
+        error_with_guard(get_typename() + ": can't get new chunk for " + std::to_string(size) + " bytes");
+        throw;
+    }
+
+    if (void *result = try_allocate(*added); result != nullptr)
+    {
+        information_with_guard(get_typename() + ": grew to " + std::to_string(_chunks.size()) + " chunks");
+
+        return result;
+    }
+
+    release_chunk(*added);
+    error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes even in new chunk");
+
+    throw std::bad_alloc();
+}
+
+template<typename allocator>
+void growing_resource<allocator>::do_deallocate_sm(
+    void *at,
+    size_t alignment)
+{
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard lock(_mutex);
+
+    chunk &owner = chunk_of(at);
+
+    static_cast<std::pmr::memory_resource &>(*owner.instance).deallocate(at, 1, alignment);
+    owner.min_failed_request = std::numeric_limits<size_t>::max();
+
+    if (--owner.occupied_blocks_count != 0 || &owner == _chunks.front().get())
+    {
+        return;
+    }
+
+    if (++_free_chunks_count > _max_free_chunks)
+    {
+        release_chunk(owner);
+    }
+}
+
+template<typename allocator>
+bool growing_resource<allocator>::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+template<typename allocator>
+inline void growing_resource<allocator>::set_fit_mode(
+    allocator_with_fit_mode::fit_mode mode)
+{
+    std::lock_guard lock(_mutex);
+
+    _fit_mode = mode;
+
+    for (auto &target : _chunks)
+    {
+        apply_fit_mode(*target, mode);
+    }
+}
+
+template<typename allocator>
+size_t growing_resource<allocator>::chunks_count() const
+{
+    std::lock_guard lock(_mutex);
+
+    return _chunks.size();
+}
+
+template<typename allocator>
+std::vector<allocator_test_utils::block_info> growing_resource<allocator>::get_blocks_info() const
+{
+    std::lock_guard lock(_mutex);
+
+    return get_blocks_info_inner();
+}
+
+template<typename allocator>
+std::vector<std::vector<allocator_test_utils::block_info>> growing_resource<allocator>::get_chunks_blocks_info() const
+{
+    std::lock_guard lock(_mutex);
+
+    std::vector<std::vector<allocator_test_utils::block_info>> result;
+
+    for (auto const &target : _chunks)
+    {
+        result.push_back(static_cast<allocator_test_utils const &>(*target->instance).get_blocks_info());
+    }
+
+    return result;
+}
+
+template<typename allocator>
+std::vector<allocator_test_utils::block_info> growing_resource<allocator>::get_blocks_info_inner() const
+{
+    std::vector<allocator_test_utils::block_info> result;
+
+    for (auto const &target : _chunks)
+    {
+        auto chunk_blocks = static_cast<allocator_test_utils const &>(*target->instance).get_blocks_info();
+
+        result.insert(result.end(), chunk_blocks.begin(), chunk_blocks.end());
+    }
+
+    return result;
+}
+
+template<typename allocator>
+inline logger *growing_resource<allocator>::get_logger() const
+{
+    return _logger;
+}
+
+template<typename allocator>
+inline std::string growing_resource<allocator>::get_typename() const
+{
+    return "growing_resource";
+}
+
+template<typename allocator>
+typename growing_resource<allocator>::chunk &growing_resource<allocator>::add_chunk()
+{
+    auto added = std::make_unique<chunk>(this);
+
+    added->instance.emplace(_chunk_space_size, &added->parent, _logger);
+    apply_fit_mode(*added, _fit_mode);
+
+    if (!_chunks.empty())
+    {
+        ++_free_chunks_count;
+    }
+
+    _chunks.push_back(std::move(added));
+
+    return *_chunks.back();
+}
+
+template<typename allocator>
+void growing_resource<allocator>::release_chunk(chunk &released) noexcept
+{
+    if (_current == &released)
+    {
+        _current = _chunks.front().get();
+    }
+
+    --_free_chunks_count;
+    _chunks.remove_if([&released](std::unique_ptr<chunk> const &target)
+    {
+        return target.get() == &released;
+    });
+
+    debug_with_guard(get_typename() + ": released free chunk, " + std::to_string(_chunks.size()) + " chunks left");
+}
+
+template<typename allocator>
+typename growing_resource<allocator>::chunk &growing_resource<allocator>::chunk_of(void *at)
+{
+    auto owner = _ranges.find(at);
+
+    if (!owner.has_value())
+    {
+        error_with_guard(get_typename() + ": pointer does not belong to any chunk");
+        throw std::logic_error("growing_resource: pointer does not belong to any chunk");
+    }
+
+    return **owner;
+}
+
+template<typename allocator>
+void growing_resource<allocator>::apply_fit_mode(chunk &target, fit_mode mode)
+{
+    if constexpr (std::is_base_of_v<allocator_with_fit_mode, allocator>)
+    {
+        static_cast<allocator_with_fit_mode &>(*target.instance).set_fit_mode(mode);
+    }
+}
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_GROWING_RESOURCE_H
@@ -0,0 +1 @@
+#include "../include/growing_resource.h"
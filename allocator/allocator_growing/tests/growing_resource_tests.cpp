@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <allocator_guards.h>
+#include <client_logger_builder.h>
+#include <growing_resource.h>
+#include <allocator_sorted_list.h>
+#include <allocator_buddies_system.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+class counting_mem_resource final : public smart_mem_resource
+{
+
+public:
+
+    size_t allocations = 0;
+
+    size_t deallocations = 0;
+
+private:
+
+    void *do_allocate_sm(size_t size) override
+    {
+        ++allocations;
+        return ::operator new(size);
+    }
+
+    void do_deallocate_sm(void *at) override
+    {
+        ++deallocations;
+        ::operator delete(at);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(growingResourcePositiveTests, test1)
+{
+    counting_mem_resource parent;
+
+    {
+        growing_resource<allocator_sorted_list> subject(4096, &parent, nullptr, 1);
+        std::vector<void *> blocks;
+
+        for (size_t i = 0; i < 20; ++i)
+        {
+            auto *block = subject.allocate(1000);
+
+            memset(block, static_cast<int>(i), 1000);
+            blocks.push_back(block);
+        }
+
+        ASSERT_GT(subject.chunks_count(), 1);
+        ASSERT_EQ(parent.allocations, subject.chunks_count());
+
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            ASSERT_EQ(reinterpret_cast<unsigned char *>(blocks[i])[999], static_cast<unsigned char>(i));
+
+            subject.deallocate(blocks[i], 1000);
+        }
+
+        ASSERT_EQ(subject.chunks_count(), 2);
+    }
+
+    ASSERT_EQ(parent.allocations, parent.deallocations);
+}
+
+TEST(growingResourcePositiveTests, test2)
+{
+    counting_mem_resource parent;
+    growing_resource<allocator_sorted_list> subject(4096, &parent, nullptr, 0);
+
+    auto *first_block = subject.allocate(3000);
+    auto *second_block = subject.allocate(3000);
+    auto *third_block = subject.allocate(3000);
+
+    ASSERT_EQ(subject.chunks_count(), 3);
+
+    auto chunks_blocks = subject.get_chunks_blocks_info();
+
+    ASSERT_EQ(chunks_blocks.size(), 3);
+
+    size_t total_blocks = 0;
+
+    for (auto const &chunk_blocks : chunks_blocks)
+    {
+        ASSERT_TRUE(chunk_blocks.front().is_block_occupied);
+        total_blocks += chunk_blocks.size();
+    }
+
+    ASSERT_EQ(subject.get_blocks_info().size(), total_blocks);
+
+    subject.deallocate(second_block, 1);
+
+    ASSERT_EQ(subject.chunks_count(), 2);
+
+    subject.deallocate(first_block, 1);
+    subject.deallocate(third_block, 1);
+
+    ASSERT_EQ(subject.chunks_count(), 1);
+    ASSERT_EQ(parent.allocations, parent.deallocations + 1);
+}
+
+TEST(growingResourcePositiveTests, test3)
+{
+    growing_resource<allocator_buddies_system> subject(12, nullptr, nullptr, 2, allocator_with_fit_mode::fit_mode::the_best_fit);
+    std::mt19937 generator(42);
+    std::vector<std::pair<void *, size_t>> blocks;
+
+    for (size_t i = 0; i < 5000; ++i)
+    {
+        if (blocks.empty() || generator() % 3 != 0)
+        {
+            size_t alignment = size_t(1) << (3 + generator() % 5);
+            auto *block = reinterpret_cast<unsigned char *>(subject.allocate(generator() % 500, alignment));
+
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0);
+            blocks.emplace_back(block, alignment);
+        }
+        else
+        {
+            std::swap(blocks[generator() % blocks.size()], blocks.back());
+            subject.deallocate(blocks.back().first, 1, blocks.back().second);
+            blocks.pop_back();
+        }
+    }
+
+    for (auto [block, alignment] : blocks)
+    {
+        subject.deallocate(block, 1, alignment);
+    }
+
+    ASSERT_LE(subject.chunks_count(), 3);
+
+    for (auto const &block : subject.get_blocks_info())
+    {
+        ASSERT_FALSE(block.is_block_occupied);
+    }
+}
+
+TEST(growingResourceFalsePositiveTests, test1)
+{
+    growing_resource<allocator_sorted_list> subject(4096);
+
+    ASSERT_THROW(static_cast<void>(subject.allocate(5000)), std::bad_alloc);
+    ASSERT_EQ(subject.chunks_count(), 1);
+
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "allocator guards abort on a foreign pointer before the allocator can reject it";
+    }
+
+    int foreign;
+
+    ASSERT_THROW(subject.deallocate(&foreign, 1), std::logic_error);
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+#include <handle_heap.h>
+#include <allocator_sorted_list.h>
+#include <allocator_boundary_tags.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct recovery_result
+{
+    size_t live_blocks;
+
+    size_t free_bytes;
+
+    size_t largest_free_before;
+
+    size_t largest_free_after;
+
+    size_t moved_blocks;
+
+    double compaction_seconds;
+
+    bool large_request_fits_before;
+
+    bool large_request_fits_after;
+};
+
+/**
+ * Long-running process imitation: space is filled with blocks of random sizes, then random half of them is freed,
+ * so free bytes are plenty but scattered. Compaction must make the large request fit again
+ */
+template<typename allocator>
+recovery_result run(size_t space_size, size_t large_request)
+{
+    using handle = typename handle_heap<allocator>::handle;
+
+    handle_heap<allocator> heap(space_size, nullptr, nullptr, false);
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<size_t> size_distribution(16, 1024);
+    std::vector<handle> handles;
+    recovery_result result{};
+
+    try
+    {
+        while (true)
+        {
+            handles.push_back(heap.allocate(size_distribution(generator)));
+        }
+    }
+    catch (std::bad_alloc const &)
+    {
+    }
+
+    std::shuffle(handles.begin(), handles.end(), generator);
+
+    for (size_t i = 0; i < handles.size() / 2; ++i)
+    {
+        heap.deallocate(handles[i]);
+    }
+
+    handles.erase(handles.begin(), handles.begin() + handles.size() / 2);
+
+    auto try_large = [&heap, large_request]()
+    {
+        try
+        {
+            heap.deallocate(heap.allocate(large_request));
+
+            return true;
+        }
+        catch (std::bad_alloc const &)
+        {
+            return false;
+        }
+    };
+
+    auto statistics = heap.underlying().get_statistics();
+
+    result.live_blocks = handles.size();
+    result.free_bytes = statistics.free_bytes;
+    result.largest_free_before = statistics.largest_free_block;
+    result.large_request_fits_before = try_large();
+
+    auto start = std::chrono::steady_clock::now();
+
+    result.moved_blocks = heap.compact();
+    result.compaction_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.largest_free_after = heap.underlying().get_statistics().largest_free_block;
+    result.large_request_fits_after = try_large();
+
+    return result;
+}
+
+void print(std::string const &name, recovery_result const &result)
+{
+    std::cout << std::setw(26) << name
+              << std::setw(10) << result.live_blocks
+              << std::setw(12) << result.free_bytes
+              << std::setw(14) << result.largest_free_before
+              << std::setw(14) << result.largest_free_after
+              << std::setw(10) << result.moved_blocks
+              << std::setw(12) << std::fixed << std::setprecision(2) << result.compaction_seconds * 1000
+              << std::setw(10) << (result.large_request_fits_before ? "yes" : "no")
+              << std::setw(10) << (result.large_request_fits_after ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Usage: mp_os_allctr_allctr_hndl_hp_bnchmrk [space size] [large request size]
+ */
+int main(
+    int argc,
+    char *argv[])
+{
+    size_t space_size = argc > 1 ? std::stoul(argv[1]) : size_t(1) << 26;
+    size_t large_request = argc > 2 ? std::stoul(argv[2]) : space_size / 8;
+
+    std::cout << "space of " << space_size << " bytes, large request of " << large_request << " bytes" << std::endl
+              << std::setw(26) << "allocator"
+              << std::setw(10) << "blocks"
+              << std::setw(12) << "free"
+              << std::setw(14) << "largest free"
+              << std::setw(14) << "compacted"
+              << std::setw(10) << "moved"
+              << std::setw(12) << "ms"
+              << std::setw(10) << "fits"
+              << std::setw(10) << "fits now" << std::endl;
+
+    print("allocator_sorted_list", run<allocator_sorted_list>(space_size, large_request));
+    print("allocator_boundary_tags", run<allocator_boundary_tags>(space_size, large_request));
+
+    return 0;
+}
@@ -0,0 +1,354 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_HANDLE_HEAP_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_HANDLE_HEAP_H
+
+#include <pp_allocator.h>
+#include <allocator_with_compaction.h>
+#include <logger_guardant.h>
+#include <typename_holder.h>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Relocatable blocks over an allocator able to compact its space.
+ * Blocks are reached through handles: pin gives the current address of a block and keeps it in place until
+ * the matching unpin, compact slides all unpinned blocks together and updates the handle table,
+ * so free space scattered between them becomes one large block again.
+ */
+template<typename allocator>
+class handle_heap final:
+    private allocator_with_compaction::relocation_listener,
+    private logger_guardant,
+    private typename_holder
+{
+
+    static_assert(std::is_base_of_v<smart_mem_resource, allocator> && std::is_base_of_v<allocator_with_compaction, allocator>);
+
+    static_assert(std::is_constructible_v<allocator, size_t, std::pmr::memory_resource*, logger*>);
+
+public:
+
+    /**
+     * Slot in handle table and generation of the slot, so handles of deallocated blocks are told apart
+     * from handles of blocks that reused their slot
+     */
+    struct handle
+    {
+        uint32_t slot;
+
+        uint32_t generation;
+
+        bool operator==(handle const &other) const noexcept = default;
+    };
+
+private:
+
+    struct entry
+    {
+        void *block;
+
+        size_t size;
+
+        size_t pins_count;
+
+        uint32_t generation;
+    };
+
+    logger *_logger;
+
+    allocator _allocator;
+
+    std::vector<entry> _entries;
+
+    std::vector<uint32_t> _free_slots;
+
+    /**
+     * Slot of every live block by its current address, asked by compaction for each occupied block
+     */
+    std::unordered_map<void *, uint32_t> _slots;
+
+    bool _compact_on_failure;
+
+    mutable std::mutex _mutex;
+
+public:
+
+    /**
+     * When compact_on_failure is set, allocation that does not fit compacts the space and tries again
+     */
+    explicit handle_heap(
+        size_t space_size,
+        std::pmr::memory_resource *parent_allocator = nullptr,
+        logger *logger = nullptr,
+        bool compact_on_failure = true);
+
+    handle_heap(
+        handle_heap const &other) = delete;
+
+    handle_heap &operator=(
+        handle_heap const &other) = delete;
+
+    handle_heap(
+        handle_heap &&other) = delete;
+
+    handle_heap &operator=(
+        handle_heap &&other) = delete;
+
+    ~handle_heap() override;
+
+public:
+
+    [[nodiscard]] handle allocate(
+        size_t size);
+
+    /**
+     * Throws std::logic_error for stale and pinned handles
+     */
+    void deallocate(
+        handle target);
+
+    /**
+     * Current address of the block, it does not move until every pin is matched by unpin
+     */
+    [[nodiscard]] void *pin(
+        handle target);
+
+    void unpin(
+        handle target);
+
+    size_t size(
+        handle target) const;
+
+    /**
+     * Returns count of moved blocks
+     */
+    size_t compact();
+
+    /**
+     * Allocator serving the blocks, for its statistics and blocks info. Allocating from it directly makes
+     * unmovable blocks
+     */
+    allocator &underlying() noexcept;
+
+private:
+
+    bool is_movable(
+        void *at) const noexcept override;
+
+    void on_moved(
+        void *from,
+        void *to) noexcept override;
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    /**
+     * Throws std::logic_error for handles of deallocated blocks
+     */
+    uint32_t slot_of(
+        handle target) const;
+};
+
+template<typename allocator>
+handle_heap<allocator>::handle_heap(
+    size_t space_size,
+    std::pmr::memory_resource *parent_allocator,
+    logger *logger,
+    bool compact_on_failure):
+    _logger(logger),
+    _allocator(space_size, parent_allocator, logger),
+    _compact_on_failure(compact_on_failure)
+{
+}
+
+template<typename allocator>
+handle_heap<allocator>::~handle_heap()
+{
+    for (auto const &[block, slot] : _slots)
+    {
+        _allocator.do_deallocate_sm(block);
+    }
+}
+
+template<typename allocator>
+typename handle_heap<allocator>::handle handle_heap<allocator>::allocate(
+    size_t size)
+{
+    std::lock_guard lock(_mutex);
+
+    void *block;
+
+    // blocks are taken past smart_mem_resource::allocate, so compaction is asked about the same addresses they were given at
+    try
+    {
+        block = _allocator.do_allocate_sm(size);
+    }
+    catch (std::bad_alloc const &)
+    {
+        if (!_compact_on_failure || _allocator.compact(*this) == 0)
+        {
+            throw;
+        }
+
+        information_with_guard(get_typename() + ": compacted to allocate " + std::to_string(size) + " bytes");
+        block = _allocator.do_allocate_sm(size);
+    }
+
+    uint32_t slot;
+
+    try
+    {
+        if (_free_slots.empty())
+        {
+            _entries.push_back({ nullptr, 0, 0, 0 });
+            slot = static_cast<uint32_t>(_entries.size() - 1);
+        }
+        else
+        {
+            slot = _free_slots.back();
+            _free_slots.pop_back();
+        }
+
+        _slots.emplace(block, slot);
+    }
+    catch (...)
+    {
+        _allocator.do_deallocate_sm(block);
+        throw;
+    }
+
+    auto &target = _entries[slot];
+
+    target.block = block;
+    target.size = size;
+    target.pins_count = 0;
+
+    return { slot, target.generation };
+}
+
+template<typename allocator>
+void handle_heap<allocator>::deallocate(
+    handle target)
+{
+    std::lock_guard lock(_mutex);
+
+    auto &deallocated = _entries[slot_of(target)];
+
+    if (deallocated.pins_count != 0)
+    {
+        error_with_guard(get_typename() + ": pinned block can't be deallocated");
+        throw std::logic_error("handle_heap: pinned block can't be deallocated");
+    }
+
+    _allocator.do_deallocate_sm(deallocated.block);
+    _slots.erase(deallocated.block);
+
+    deallocated.block = nullptr;
+    ++deallocated.generation;
+    _free_slots.push_back(target.slot);
+}
+
+template<typename allocator>
+void *handle_heap<allocator>::pin(
+    handle target)
+{
+    std::lock_guard lock(_mutex);
+
+    auto &pinned = _entries[slot_of(target)];
+
+    ++pinned.pins_count;
+
+    return pinned.block;
+}
+
+template<typename allocator>
+void handle_heap<allocator>::unpin(
+    handle target)
+{
+    std::lock_guard lock(_mutex);
+
+    auto &unpinned = _entries[slot_of(target)];
+
+    if (unpinned.pins_count == 0)
+    {
+        throw std::logic_error("handle_heap: block is not pinned");
+    }
+
+    --unpinned.pins_count;
+}
+
+template<typename allocator>
+size_t handle_heap<allocator>::size(
+    handle target) const
+{
+    std::lock_guard lock(_mutex);
+
+    return _entries[slot_of(target)].size;
+}
+
+template<typename allocator>
+size_t handle_heap<allocator>::compact()
+{
+    std::lock_guard lock(_mutex);
+
+    return _allocator.compact(*this);
+}
+
+template<typename allocator>
+allocator &handle_heap<allocator>::underlying() noexcept
+{
+    return _allocator;
+}
+
+template<typename allocator>
+bool handle_heap<allocator>::is_movable(
+    void *at) const noexcept
+{
+    auto slot = _slots.find(at);
+
+    return slot != _slots.end() && _entries[slot->second].pins_count == 0;
+}
+
+template<typename allocator>
+void handle_heap<allocator>::on_moved(
+    void *from,
+    void *to) noexcept
+{
+    // blocks move towards lower addresses in address order, so "to" never holds a live block when it is moved
+    auto moved = _slots.extract(from);
+
+    _entries[moved.mapped()].block = to;
+    moved.key() = to;
+    _slots.insert(std::move(moved));
+}
+
+template<typename allocator>
+inline logger *handle_heap<allocator>::get_logger() const
+{
+    return _logger;
+}
+
+template<typename allocator>
+inline std::string handle_heap<allocator>::get_typename() const
+{
+    return "handle_heap";
+}
+
+template<typename allocator>
+uint32_t handle_heap<allocator>::slot_of(
+    handle target) const
+{
+    if (target.slot >= _entries.size() || _entries[target.slot].generation != target.generation || _entries[target.slot].block == nullptr)
+    {
+        throw std::logic_error("handle_heap: handle does not refer to allocated block");
+    }
+
+    return target.slot;
+}
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_HANDLE_HEAP_H
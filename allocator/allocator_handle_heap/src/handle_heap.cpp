@@ -0,0 +1 @@
+#include "../include/handle_heap.h"
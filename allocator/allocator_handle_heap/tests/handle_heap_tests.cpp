@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <client_logger_builder.h>
+#include <handle_heap.h>
+#include <allocator_sorted_list.h>
+#include <allocator_boundary_tags.h>
+#include <cstring>
+#include <vector>
+
+template<typename allocator>
+using handle_t = typename handle_heap<allocator>::handle;
+
+/**
+ * Fills the space with blocks, frees every other one and checks that only compaction makes a large block fit
+ */
+template<typename allocator>
+void check_fragmentation_recovery()
+{
+    handle_heap<allocator> subject(1 << 14, nullptr, nullptr, false);
+    std::vector<handle_t<allocator>> handles;
+
+    try
+    {
+        while (true)
+        {
+            auto target = subject.allocate(200);
+
+            std::memset(subject.pin(target), static_cast<int>(handles.size()), 200);
+            subject.unpin(target);
+            handles.push_back(target);
+        }
+    }
+    catch (std::bad_alloc const &)
+    {
+    }
+
+    ASSERT_GT(handles.size(), 40);
+
+    std::vector<std::pair<handle_t<allocator>, unsigned char>> survivors;
+
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        if (i % 2 == 0)
+        {
+            subject.deallocate(handles[i]);
+        }
+        else
+        {
+            survivors.emplace_back(handles[i], static_cast<unsigned char>(i));
+        }
+    }
+
+    // a block in the middle keeps its place while pinned
+    auto pinned = survivors[survivors.size() / 2].first;
+    void *pinned_address = subject.pin(pinned);
+
+    ASSERT_THROW(static_cast<void>(subject.allocate(2000)), std::bad_alloc);
+    ASSERT_GT(subject.compact(), 0);
+    ASSERT_EQ(subject.pin(pinned), pinned_address);
+
+    subject.unpin(pinned);
+    subject.unpin(pinned);
+
+    for (auto [target, pattern] : survivors)
+    {
+        auto *block = reinterpret_cast<unsigned char *>(subject.pin(target));
+
+        ASSERT_EQ(subject.size(target), 200);
+        ASSERT_EQ(block[0], pattern);
+        ASSERT_EQ(block[199], pattern);
+
+        subject.unpin(target);
+    }
+
+    // once unpinned, the block and blocks after it slide into the free space left before it
+    ASSERT_GT(subject.compact(), 0);
+    ASSERT_EQ(subject.compact(), 0);
+
+    subject.deallocate(subject.allocate(2000));
+
+    for (auto [target, pattern] : survivors)
+    {
+        subject.deallocate(target);
+    }
+
+    auto blocks = subject.underlying().get_blocks_info();
+
+    ASSERT_EQ(blocks.size(), 1);
+    ASSERT_FALSE(blocks.front().is_block_occupied);
+}
+
+TEST(handleHeapPositiveTests, test1)
+{
+    check_fragmentation_recovery<allocator_sorted_list>();
+}
+
+TEST(handleHeapPositiveTests, test2)
+{
+    check_fragmentation_recovery<allocator_boundary_tags>();
+}
+
+TEST(handleHeapPositiveTests, test3)
+{
+    handle_heap<allocator_boundary_tags> subject(1 << 12);
+    std::vector<handle_t<allocator_boundary_tags>> handles;
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        handles.push_back(subject.allocate(300));
+    }
+
+    // block allocated past handles is never moved, free space before it stays apart from free space after it
+    auto *fixed = reinterpret_cast<unsigned char *>(subject.underlying().allocate(64));
+
+    std::memset(fixed, 0x5A, 64);
+
+    for (size_t i = 0; i < handles.size(); i += 2)
+    {
+        subject.deallocate(handles[i]);
+    }
+
+    auto large = subject.allocate(1500);
+
+    ASSERT_EQ(fixed[0], 0x5A);
+    ASSERT_EQ(fixed[63], 0x5A);
+
+    auto blocks = subject.underlying().get_blocks_info();
+
+    for (size_t i = 1; i < blocks.size(); ++i)
+    {
+        ASSERT_FALSE(!blocks[i - 1].is_block_occupied && !blocks[i].is_block_occupied);
+    }
+
+    subject.deallocate(large);
+    subject.underlying().deallocate(fixed, 64);
+}
+
+TEST(handleHeapFalsePositiveTests, test1)
+{
+    handle_heap<allocator_sorted_list> subject(1 << 12);
+
+    auto target = subject.allocate(100);
+
+    ASSERT_THROW(subject.unpin(target), std::logic_error);
+
+    static_cast<void>(subject.pin(target));
+
+    ASSERT_THROW(subject.deallocate(target), std::logic_error);
+
+    subject.unpin(target);
+    subject.deallocate(target);
+
+    auto reused = subject.allocate(100);
+
+    ASSERT_EQ(reused.slot, target.slot);
+    ASSERT_THROW(static_cast<void>(subject.pin(target)), std::logic_error);
+    ASSERT_THROW(subject.deallocate(target), std::logic_error);
+    ASSERT_THROW(static_cast<void>(subject.allocate(1 << 13)), std::bad_alloc);
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
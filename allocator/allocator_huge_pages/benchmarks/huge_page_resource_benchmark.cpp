@@ -0,0 +1,201 @@
+#include <allocator_boundary_tags.h>
+#include <huge_page_resource.h>
+#include <linux/perf_event.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Counts data TLB load misses of the calling thread. Not available in most containers and virtual machines,
+ * then only time is reported
+ */
+class dtlb_miss_counter final
+{
+    int _descriptor;
+
+public:
+
+    dtlb_miss_counter()
+    {
+        perf_event_attr attributes{};
+
+        attributes.type = PERF_TYPE_HW_CACHE;
+        attributes.size = sizeof(attributes);
+        attributes.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+
+        _descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    dtlb_miss_counter(dtlb_miss_counter const &) = delete;
+
+    dtlb_miss_counter &operator=(dtlb_miss_counter const &) = delete;
+
+    ~dtlb_miss_counter()
+    {
+        if (_descriptor != -1)
+        {
+            close(_descriptor);
+        }
+    }
+
+    void start()
+    {
+        if (_descriptor != -1)
+        {
+            ioctl(_descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(_descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    std::optional<uint64_t> stop()
+    {
+        uint64_t misses;
+
+        if (_descriptor == -1)
+        {
+            return std::nullopt;
+        }
+
+        ioctl(_descriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+        if (read(_descriptor, &misses, sizeof(misses)) != sizeof(misses))
+        {
+            return std::nullopt;
+        }
+
+        return misses;
+    }
+};
+
+struct lookup_result
+{
+    double seconds;
+
+    std::optional<uint64_t> dtlb_misses;
+
+    size_t found;
+};
+
+/**
+ * Keys are inserted in random order, so tree nodes adjacent in key order are scattered over the whole arena
+ * and every random lookup walks through pages far apart
+ */
+lookup_result run(std::pmr::memory_resource &parent, size_t nodes_count, size_t lookups_count)
+{
+    using tree = std::set<uint64_t, std::less<uint64_t>, pp_allocator<uint64_t>>;
+
+    allocator_boundary_tags allocator(nodes_count * 96, &parent);
+    tree keys{ pp_allocator<uint64_t>(&allocator) };
+    std::vector<uint64_t> order(nodes_count);
+    std::mt19937_64 generator(31);
+
+    std::iota(order.begin(), order.end(), uint64_t(0));
+    std::shuffle(order.begin(), order.end(), generator);
+
+    for (uint64_t key : order)
+    {
+        keys.insert(key * 2);
+    }
+
+    std::uniform_int_distribution<uint64_t> key_distribution(0, nodes_count * 2);
+    std::vector<uint64_t> probes(lookups_count);
+
+    for (auto &probe : probes)
+    {
+        probe = key_distribution(generator);
+    }
+
+    dtlb_miss_counter counter;
+    lookup_result result{ 0, std::nullopt, 0 };
+
+    auto start = std::chrono::steady_clock::now();
+    counter.start();
+
+    for (uint64_t probe : probes)
+    {
+        result.found += keys.count(probe);
+    }
+
+    result.dtlb_misses = counter.stop();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
+/**
+ * Usage: mp_os_allctr_allctr_hg_pgs_bnchmrk [nodes count] [lookups count] [NUMA node]
+ */
+int main(
+    int argc,
+    char *argv[])
+{
+    size_t nodes_count = argc > 1 ? std::stoul(argv[1]) : size_t(1) << 21;
+    size_t lookups_count = argc > 2 ? std::stoul(argv[2]) : size_t(1) << 22;
+    int numa_node = argc > 3 ? std::stoi(argv[3]) : huge_page_resource::no_numa_node;
+
+    huge_page_resource regular_pages(huge_page_resource::page_mode::transparent, huge_page_resource::no_numa_node,
+                                     std::numeric_limits<size_t>::max());
+    huge_page_resource transparent(huge_page_resource::page_mode::transparent, numa_node);
+    huge_page_resource explicit_pages(huge_page_resource::page_mode::explicit_huge_pages, numa_node);
+
+    std::pair<std::string, std::pmr::memory_resource *> const parents[] =
+        {
+            { "regular pages", &regular_pages },
+            { "transparent huge pages", &transparent },
+            { "explicit huge pages", &explicit_pages }
+        };
+
+    std::cout << nodes_count << " tree nodes, " << lookups_count << " random lookups" << std::endl
+              << std::setw(24) << "parent"
+              << std::setw(16) << "lookups/sec"
+              << std::setw(20) << "dTLB misses/lookup" << std::endl;
+
+    for (auto const &[name, parent] : parents)
+    {
+        auto result = run(*parent, nodes_count, lookups_count);
+
+        std::cout << std::setw(24) << name
+                  << std::setw(16) << std::fixed << std::setprecision(0) << lookups_count / result.seconds
+                  << std::setw(20);
+
+        if (result.dtlb_misses.has_value())
+        {
+            std::cout << std::setprecision(3) << static_cast<double>(*result.dtlb_misses) / lookups_count;
+        }
+        else
+        {
+            std::cout << "n/a";
+        }
+
+        std::cout << std::endl;
+    }
+
+    auto explicit_statistics = explicit_pages.get_statistics();
+
+    std::cout << "explicit huge pages mode got " << explicit_statistics.explicit_huge_page_mappings << " explicit and "
+              << explicit_statistics.transparent_huge_page_mappings << " transparent mappings";
+
+    if (numa_node != huge_page_resource::no_numa_node)
+    {
+        std::cout << ", " << explicit_statistics.numa_bound_mappings + transparent.get_statistics().numa_bound_mappings
+                  << " mappings bound to NUMA node " << numa_node;
+    }
+
+    std::cout << std::endl;
+
+    return 0;
+}
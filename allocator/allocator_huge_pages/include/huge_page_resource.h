@@ -0,0 +1,123 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_HUGE_PAGE_RESOURCE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_HUGE_PAGE_RESOURCE_H
+
+#include <logger_guardant.h>
+#include <typename_holder.h>
+#include <atomic>
+#include <memory_resource>
+
+/**
+ * Parent resource for allocators with large arenas. Requests of at least mapping_threshold bytes get their own
+ * anonymous mapping backed by huge pages, so a multi-gigabyte arena needs a few thousand TLB entries instead of
+ * a million, and may be bound to a NUMA node before its pages are touched.
+ * Explicit huge pages (MAP_HUGETLB) are tried first when asked for, then transparent huge pages (MADV_HUGEPAGE),
+ * then regular pages; NUMA binding that fails leaves the mapping with the default policy.
+ * Smaller requests are forwarded to upstream resource.
+ */
+class huge_page_resource final:
+    public std::pmr::memory_resource,
+    private logger_guardant,
+    private typename_holder
+{
+
+public:
+
+    enum class page_mode
+    {
+        transparent,
+        explicit_huge_pages
+    };
+
+    static constexpr const size_t huge_page_size = size_t(1) << 21;
+
+    static constexpr const int no_numa_node = -1;
+
+    struct statistics final
+    {
+
+        size_t explicit_huge_page_mappings;
+
+        size_t transparent_huge_page_mappings;
+
+        size_t regular_page_mappings;
+
+        size_t numa_bound_mappings;
+
+        size_t mapped_bytes;
+
+    };
+
+private:
+
+    page_mode _mode;
+
+    int _numa_node;
+
+    size_t _mapping_threshold;
+
+    std::pmr::memory_resource *_upstream;
+
+    logger *_logger;
+
+    std::atomic<size_t> _explicit_huge_page_mappings = 0;
+
+    std::atomic<size_t> _transparent_huge_page_mappings = 0;
+
+    std::atomic<size_t> _regular_page_mappings = 0;
+
+    std::atomic<size_t> _numa_bound_mappings = 0;
+
+    std::atomic<size_t> _mapped_bytes = 0;
+
+public:
+
+    explicit huge_page_resource(
+        page_mode mode = page_mode::transparent,
+        int numa_node = no_numa_node,
+        size_t mapping_threshold = huge_page_size / 2,
+        std::pmr::memory_resource *upstream = nullptr,
+        logger *logger = nullptr);
+
+    huge_page_resource(
+        huge_page_resource const &other) = delete;
+
+    huge_page_resource &operator=(
+        huge_page_resource const &other) = delete;
+
+    ~huge_page_resource() override;
+
+public:
+
+    statistics get_statistics() const noexcept;
+
+private:
+
+    void *do_allocate(
+        size_t bytes,
+        size_t alignment) override;
+
+    void do_deallocate(
+        void *p,
+        size_t bytes,
+        size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    /**
+     * Mapping is rounded up to whole huge pages and starts at huge page boundary,
+     * as transparent huge pages are used only for aligned ranges
+     */
+    static size_t mapping_size(size_t bytes) noexcept;
+
+    void *map_explicit(size_t size) noexcept;
+
+    void *map_aligned(size_t size) noexcept;
+
+    void bind(void *mapping, size_t size) noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_HUGE_PAGE_RESOURCE_H
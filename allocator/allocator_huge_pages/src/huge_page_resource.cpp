@@ -0,0 +1,202 @@
+#include <cstdint>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "../include/huge_page_resource.h"
+
+huge_page_resource::huge_page_resource(
+    page_mode mode,
+    int numa_node,
+    size_t mapping_threshold,
+    std::pmr::memory_resource *upstream,
+    logger *logger):
+    _mode(mode),
+    _numa_node(numa_node),
+    _mapping_threshold(mapping_threshold),
+    _upstream(upstream == nullptr ? std::pmr::new_delete_resource() : upstream),
+    _logger(logger)
+{
+    debug_with_guard(get_typename() + ": created");
+}
+
+huge_page_resource::~huge_page_resource()
+{
+    if (_mapped_bytes.load(std::memory_order_relaxed) != 0)
+    {
+        warning_with_guard(get_typename() + ": destroyed with " + std::to_string(_mapped_bytes.load(std::memory_order_relaxed)) + " bytes still mapped");
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+}
+
+huge_page_resource::statistics huge_page_resource::get_statistics() const noexcept
+{
+    return
+        {
+            .explicit_huge_page_mappings = _explicit_huge_page_mappings.load(std::memory_order_relaxed),
+            .transparent_huge_page_mappings = _transparent_huge_page_mappings.load(std::memory_order_relaxed),
+            .regular_page_mappings = _regular_page_mappings.load(std::memory_order_relaxed),
+            .numa_bound_mappings = _numa_bound_mappings.load(std::memory_order_relaxed),
+            .mapped_bytes = _mapped_bytes.load(std::memory_order_relaxed)
+        };
+}
+
+void *huge_page_resource::do_allocate(
+    size_t bytes,
+    size_t alignment)
+{
+    if (bytes < _mapping_threshold)
+    {
+        return _upstream->allocate(bytes, alignment);
+    }
+
+    if (alignment > huge_page_size || bytes > std::numeric_limits<size_t>::max() - 2 * huge_page_size)
+    {
+        error_with_guard(get_typename() + ": can't map " + std::to_string(bytes) + " bytes aligned by " + std::to_string(alignment));
+        throw std::bad_alloc();
+    }
+
+    size_t size = mapping_size(bytes);
+    void *mapping = _mode == page_mode::explicit_huge_pages ? map_explicit(size) : nullptr;
+
+    if (mapping != nullptr)
+    {
+        ++_explicit_huge_page_mappings;
+    }
+    else
+    {
+        mapping = map_aligned(size);
+
+        if (mapping == nullptr)
+        {
+            error_with_guard(get_typename() + ": can't map " + std::to_string(size) + " bytes");
+            throw std::bad_alloc();
+        }
+    }
+
+    if (_numa_node != no_numa_node)
+    {
+        bind(mapping, size);
+    }
+
+    _mapped_bytes += size;
+
+    trace_with_guard([&] { return get_typename() + ": mapped " + std::to_string(size) + " bytes"; });
+
+    return mapping;
+}
+
+void huge_page_resource::do_deallocate(
+    void *p,
+    size_t bytes,
+    size_t alignment)
+{
+    if (bytes < _mapping_threshold)
+    {
+        _upstream->deallocate(p, bytes, alignment);
+        return;
+    }
+
+    size_t size = mapping_size(bytes);
+
+    munmap(p, size);
+    _mapped_bytes -= size;
+}
+
+bool huge_page_resource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+size_t huge_page_resource::mapping_size(size_t bytes) noexcept
+{
+    return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+void *huge_page_resource::map_explicit(size_t size) noexcept
+{
+#ifdef MAP_HUGETLB
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (mapping != MAP_FAILED)
+    {
+        return mapping;
+    }
+#endif
+
+    warning_with_guard(get_typename() + ": no explicit huge pages for " + std::to_string(size) + " bytes, falling back to transparent huge pages");
+
+    return nullptr;
+}
+
+void *huge_page_resource::map_aligned(size_t size) noexcept
+{
+    // over-map by one huge page and trim both ends, so the mapping starts at huge page boundary
+    size_t reserved = size + huge_page_size;
+    auto *reservation = reinterpret_cast<unsigned char *>(mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+    if (reservation == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    auto address = reinterpret_cast<uintptr_t>(reservation);
+    auto *mapping = reinterpret_cast<unsigned char *>((address + huge_page_size - 1) & ~(uintptr_t(huge_page_size) - 1));
+    size_t head = mapping - reservation;
+
+    if (head != 0)
+    {
+        munmap(reservation, head);
+    }
+
+    if (reserved - head - size != 0)
+    {
+        munmap(mapping + size, reserved - head - size);
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (madvise(mapping, size, MADV_HUGEPAGE) == 0)
+    {
+        ++_transparent_huge_page_mappings;
+
+        return mapping;
+    }
+#endif
+
+    ++_regular_page_mappings;
+
+    return mapping;
+}
+
+void huge_page_resource::bind(void *mapping, size_t size) noexcept
+{
+#ifdef SYS_mbind
+    constexpr const int bind_policy = 2;
+    constexpr const size_t mask_bits = sizeof(unsigned long) * 8;
+
+    if (_numa_node >= 0 && static_cast<size_t>(_numa_node) < mask_bits)
+    {
+        unsigned long node_mask = 1UL << _numa_node;
+
+        if (syscall(SYS_mbind, mapping, size, bind_policy, &node_mask, mask_bits + 1, 0) == 0)
+        {
+            ++_numa_bound_mappings;
+
+            return;
+        }
+    }
+#endif
+
+    warning_with_guard(get_typename() + ": can't bind mapping to NUMA node " + std::to_string(_numa_node) + ", default policy is kept");
+}
+
+inline logger *huge_page_resource::get_logger() const
+{
+    return _logger;
+}
+
+inline std::string huge_page_resource::get_typename() const
+{
+    return "huge_page_resource";
+}
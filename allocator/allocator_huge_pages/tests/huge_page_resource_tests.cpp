@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <allocator_boundary_tags.h>
+#include <huge_page_resource.h>
+#include <cstring>
+#include <set>
+
+class counting_mem_resource final : public std::pmr::memory_resource
+{
+
+public:
+
+    size_t allocations = 0;
+
+    size_t deallocations = 0;
+
+private:
+
+    void *do_allocate(size_t size, size_t alignment) override
+    {
+        ++allocations;
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void do_deallocate(void *at, size_t, size_t alignment) override
+    {
+        ++deallocations;
+        ::operator delete(at, std::align_val_t(alignment));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(hugePageResourcePositiveTests, test1)
+{
+    counting_mem_resource upstream;
+    huge_page_resource resource(huge_page_resource::page_mode::transparent, huge_page_resource::no_numa_node, 1 << 20, &upstream);
+
+    size_t size = 3 * huge_page_resource::huge_page_size + 100;
+    auto *mapping = reinterpret_cast<unsigned char *>(resource.allocate(size));
+
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(mapping) % huge_page_resource::huge_page_size, 0);
+
+    memset(mapping, 0xAB, size);
+
+    ASSERT_EQ(mapping[size - 1], 0xAB);
+
+    auto statistics = resource.get_statistics();
+
+    ASSERT_EQ(statistics.mapped_bytes, 4 * huge_page_resource::huge_page_size);
+    ASSERT_EQ(statistics.transparent_huge_page_mappings + statistics.regular_page_mappings, 1);
+
+    void *small = resource.allocate(1000);
+
+    ASSERT_EQ(upstream.allocations, 1);
+
+    resource.deallocate(small, 1000);
+    resource.deallocate(mapping, size);
+
+    ASSERT_EQ(upstream.deallocations, 1);
+    ASSERT_EQ(resource.get_statistics().mapped_bytes, 0);
+}
+
+TEST(hugePageResourcePositiveTests, test2)
+{
+    huge_page_resource resource(huge_page_resource::page_mode::explicit_huge_pages, 0);
+
+    void *mapping = resource.allocate(huge_page_resource::huge_page_size);
+    memset(mapping, 1, huge_page_resource::huge_page_size);
+
+    auto statistics = resource.get_statistics();
+
+    ASSERT_EQ(statistics.explicit_huge_page_mappings + statistics.transparent_huge_page_mappings + statistics.regular_page_mappings, 1);
+    ASSERT_LE(statistics.numa_bound_mappings, 1);
+
+    resource.deallocate(mapping, huge_page_resource::huge_page_size);
+}
+
+TEST(hugePageResourcePositiveTests, test3)
+{
+    huge_page_resource parent;
+
+    {
+        allocator_boundary_tags allocator(size_t(1) << 24, &parent);
+        std::set<int, std::less<int>, pp_allocator<int>> values{ pp_allocator<int>(&allocator) };
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            values.insert(i * 7919 % 10007);
+        }
+
+        ASSERT_EQ(values.size(), 10000);
+        ASSERT_GT(parent.get_statistics().mapped_bytes, size_t(1) << 24);
+    }
+
+    ASSERT_EQ(parent.get_statistics().mapped_bytes, 0);
+}
+
+TEST(hugePageResourceNegativeTests, test1)
+{
+    huge_page_resource resource;
+
+    ASSERT_THROW(static_cast<void>(resource.allocate(huge_page_resource::huge_page_size, huge_page_resource::huge_page_size * 2)), std::bad_alloc);
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,241 @@
+#include <allocator_red_black_tree.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Previous allocator_red_black_tree behaviour: free blocks in a tree ordered by (size, address),
+ * so best and worst fit are tree lookups while first fit walks all blocks in address order.
+ * Blocks live outside of the managed space, only the search and coalescing costs are modelled.
+ */
+class size_ordered_reference final : public smart_mem_resource, public allocator_with_fit_mode
+{
+    struct block
+    {
+        size_t size;
+        bool occupied;
+    };
+
+    std::map<size_t, block> _blocks;
+
+    std::set<std::pair<size_t, size_t>> _free;
+
+    fit_mode _mode;
+
+    std::vector<unsigned char> _space;
+
+public:
+
+    size_ordered_reference(size_t space_size, fit_mode mode):
+        _mode(mode),
+        _space(space_size)
+    {
+        _blocks[0] = { space_size, false };
+        _free.emplace(space_size, 0);
+    }
+
+    void set_fit_mode(fit_mode mode) override
+    {
+        _mode = mode;
+    }
+
+private:
+
+    void *do_allocate_sm(size_t size) override
+    {
+        size_t need = std::max<size_t>((size + 15) / 16 * 16 + 32, 64);
+        size_t offset = 0;
+        bool found = false;
+
+        switch (_mode)
+        {
+            case fit_mode::first_fit:
+                for (auto const &[block_offset, b] : _blocks)
+                {
+                    if (!b.occupied && b.size >= need)
+                    {
+                        offset = block_offset;
+                        found = true;
+                        break;
+                    }
+                }
+                break;
+            case fit_mode::the_best_fit:
+                if (auto it = _free.lower_bound({ need, 0 }); it != _free.end())
+                {
+                    offset = it->second;
+                    found = true;
+                }
+                break;
+            case fit_mode::the_worst_fit:
+                if (!_free.empty() && _free.rbegin()->first >= need)
+                {
+                    offset = _free.rbegin()->second;
+                    found = true;
+                }
+                break;
+        }
+
+        if (!found)
+        {
+            throw std::bad_alloc();
+        }
+
+        auto &b = _blocks[offset];
+        _free.erase({ b.size, offset });
+
+        if (b.size - need >= 64)
+        {
+            _blocks[offset + need] = { b.size - need, false };
+            _free.emplace(b.size - need, offset + need);
+            b.size = need;
+        }
+
+        b.occupied = true;
+
+        return _space.data() + offset + 32;
+    }
+
+    void do_deallocate_sm(void *at) override
+    {
+        size_t offset = reinterpret_cast<unsigned char *>(at) - _space.data() - 32;
+        auto it = _blocks.find(offset);
+        it->second.occupied = false;
+
+        if (auto next = std::next(it); next != _blocks.end() && !next->second.occupied)
+        {
+            _free.erase({ next->second.size, next->first });
+            it->second.size += next->second.size;
+            _blocks.erase(next);
+        }
+
+        if (it != _blocks.begin())
+        {
+            if (auto prev = std::prev(it); !prev->second.occupied)
+            {
+                _free.erase({ prev->second.size, prev->first });
+                prev->second.size += it->second.size;
+                _blocks.erase(it);
+                it = prev;
+            }
+        }
+
+        _free.emplace(it->second.size, it->first);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/**
+ * Mix of short lived small blocks and long lived large ones keeps many free blocks of different sizes in the heap
+ */
+double run(smart_mem_resource &subject, size_t space_size, size_t operations_count)
+{
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<size_t> small_distribution(8, 128);
+    std::uniform_int_distribution<size_t> large_distribution(512, 8192);
+    std::vector<void *> small_blocks;
+    std::vector<std::pair<void *, size_t>> large_blocks;
+    size_t large_live = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < operations_count; ++i)
+    {
+        try
+        {
+            if (generator() % 16 == 0)
+            {
+                if (large_live > space_size / 2 && !large_blocks.empty())
+                {
+                    size_t index = generator() % large_blocks.size();
+
+                    std::swap(large_blocks[index], large_blocks.back());
+                    subject.deallocate(large_blocks.back().first, 1);
+                    large_live -= large_blocks.back().second;
+                    large_blocks.pop_back();
+                }
+                else
+                {
+                    size_t size = large_distribution(generator);
+
+                    large_blocks.emplace_back(subject.allocate(size), size);
+                    large_live += size;
+                }
+            }
+            else if (small_blocks.size() < 4096 && generator() % 2 == 0)
+            {
+                small_blocks.push_back(subject.allocate(small_distribution(generator)));
+            }
+            else if (!small_blocks.empty())
+            {
+                size_t index = generator() % small_blocks.size();
+
+                std::swap(small_blocks[index], small_blocks.back());
+                subject.deallocate(small_blocks.back(), 1);
+                small_blocks.pop_back();
+            }
+        }
+        catch (std::bad_alloc const &)
+        {
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (void *block : small_blocks)
+    {
+        subject.deallocate(block, 1);
+    }
+
+    for (auto [block, size] : large_blocks)
+    {
+        subject.deallocate(block, 1);
+    }
+
+    return static_cast<double>(operations_count) / elapsed.count();
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    size_t space_size = argc > 1 ? std::stoul(argv[1]) : size_t(1) << 24;
+    size_t operations_count = argc > 2 ? std::stoul(argv[2]) : 500'000;
+
+    std::cout << std::setw(12) << "fit mode"
+              << std::setw(22) << "previous ops/sec"
+              << std::setw(22) << "augmented ops/sec"
+              << std::setw(10) << "speedup" << std::endl;
+
+    std::pair<allocator_with_fit_mode::fit_mode, std::string> const modes[] =
+        {
+            { allocator_with_fit_mode::fit_mode::first_fit, "first" },
+            { allocator_with_fit_mode::fit_mode::the_best_fit, "best" },
+            { allocator_with_fit_mode::fit_mode::the_worst_fit, "worst" }
+        };
+
+    for (auto const &[mode, mode_name] : modes)
+    {
+        size_ordered_reference previous(space_size, mode);
+        double previous_ops = run(previous, space_size, operations_count);
+
+        allocator_red_black_tree augmented(space_size, nullptr, nullptr, mode);
+        double augmented_ops = run(augmented, space_size, operations_count);
+
+        std::cout << std::setw(12) << mode_name
+                  << std::setw(22) << std::fixed << std::setprecision(0) << previous_ops
+                  << std::setw(22) << augmented_ops
+                  << std::setw(10) << std::setprecision(2) << augmented_ops / previous_ops << std::endl;
+    }
+
+    return 0;
+}
@@ -3,6 +3,7 @@
 
 #include <pp_allocator.h>
 #include <allocator_test_utils.h>
+#include <allocator_with_statistics.h>
 #include <allocator_with_fit_mode.h>
 #include <logger_guardant.h>
 #include <typename_holder.h>
@@ -12,6 +13,7 @@ class allocator_red_black_tree final:
     public smart_mem_resource,
     public allocator_test_utils,
     public allocator_with_fit_mode,
+    public allocator_with_statistics,
     private logger_guardant,
     private typename_holder
 {
@@ -21,27 +23,50 @@ private:
     enum class block_color : unsigned char
     { RED, BLACK };
 
+    /**
+     * Every free block is a node of two trees: one ordered by address, one ordered by size and then address
+     */
+    enum class free_tree : unsigned char
+    { by_address, by_size };
+
     struct block_data
     {
-        bool occupied : 4;
-        block_color color : 4;
+        bool occupied;
+        block_color address_color;
+        block_color size_color;
     };
 
     void *_trusted_memory;
 
-    static constexpr const size_t allocator_metadata_size = sizeof(logger*) + sizeof(allocator_dbg_helper*) + sizeof(fit_mode) + sizeof(size_t) + sizeof(std::mutex) + sizeof(void*);
-    static constexpr const size_t occupied_block_metadata_size = sizeof(block_data) + 3 * sizeof(void*);
-    static constexpr const size_t free_block_metadata_size = sizeof(block_data) + 5 * sizeof(void*);
+    /**
+     * Header and block metadata sizes are rounded up to alignof(std::max_align_t) together with block sizes,
+     * so every payload is aligned for any fundamental type
+     */
+    static constexpr const size_t allocator_metadata_size = (sizeof(logger*) + sizeof(std::pmr::memory_resource*) + sizeof(size_t) + sizeof(std::mutex) + 2 * sizeof(void*) + sizeof(fit_mode) +
+                                                             alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    /**
+     * Block data, previous and next blocks in address order, trusted memory
+     */
+    static constexpr const size_t occupied_block_metadata_size = ((alignof(void*) + 3 * sizeof(void*)) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    /**
+     * Block data, previous and next blocks in address order, parent, left and right nodes of address tree,
+     * max free block size in address subtree, parent, left and right nodes of size tree.
+     * Subtree max lets first and worst fit descend the address tree straight to their block,
+     * best fit is a lower bound search in the size tree
+     */
+    static constexpr const size_t free_block_metadata_size = ((alignof(void*) + 8 * sizeof(void*) + sizeof(size_t)) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
 
 public:
     
     ~allocator_red_black_tree() override;
     
     allocator_red_black_tree(
-        allocator_red_black_tree const &other);
+        allocator_red_black_tree const &other) = delete;
     
     allocator_red_black_tree &operator=(
-        allocator_red_black_tree const &other);
+        allocator_red_black_tree const &other) = delete;
     
     allocator_red_black_tree(
         allocator_red_black_tree &&other) noexcept;
@@ -79,6 +104,81 @@ private:
 
     inline std::string get_typename() const noexcept override;
 
+    void destroy() noexcept;
+
+    static logger *&logger_ref(void *trusted) noexcept;
+
+    static std::pmr::memory_resource *&parent_ref(void *trusted) noexcept;
+
+    static size_t &space_size_ref(void *trusted) noexcept;
+
+    static std::mutex &mutex_ref(void *trusted) noexcept;
+
+    static void *&root_ref(void *trusted, free_tree tree = free_tree::by_address) noexcept;
+
+    static fit_mode &fit_mode_ref(void *trusted) noexcept;
+
+    static void *space_begin(void *trusted) noexcept;
+
+    static void *space_end(void *trusted) noexcept;
+
+    static block_data &block_data_ref(void *block) noexcept;
+
+    static void *&block_prev_ref(void *block) noexcept;
+
+    static void *&block_next_ref(void *block) noexcept;
+
+    static void *&block_trusted_ref(void *block) noexcept;
+
+    static void *&node_parent_ref(void *block, free_tree tree = free_tree::by_address) noexcept;
+
+    static void *&node_left_ref(void *block, free_tree tree = free_tree::by_address) noexcept;
+
+    static void *&node_right_ref(void *block, free_tree tree = free_tree::by_address) noexcept;
+
+    static block_color &node_color_ref(void *block, free_tree tree) noexcept;
+
+    static size_t &node_max_ref(void *block) noexcept;
+
+    static size_t subtree_max(void *node) noexcept;
+
+    static size_t block_size(void *trusted, void *block) noexcept;
+
+    static size_t round_up(size_t size) noexcept;
+
+    static bool is_red(void *node, free_tree tree) noexcept;
+
+    bool node_less(void *node, void *other, free_tree tree) const noexcept;
+
+    void update_max(void *node) const noexcept;
+
+    void update_max_upwards(void *node) const noexcept;
+
+    void publish_free_space() noexcept;
+
+    void *find_first_fit(size_t size) const noexcept;
+
+    void *find_best_fit(size_t size) const noexcept;
+
+    void *find_worst_fit(size_t size) const noexcept;
+
+    void rotate_left(void *node, free_tree tree) noexcept;
+
+    void rotate_right(void *node, free_tree tree) noexcept;
+
+    void tree_insert(void *node, free_tree tree) noexcept;
+
+    void tree_erase(void *node, free_tree tree) noexcept;
+
+    /**
+     * Puts replacement in place of address tree node, no other free block may lie between them
+     */
+    void tree_replace(void *node, void *replacement) noexcept;
+
+    void free_block_insert(void *block) noexcept;
+
+    void free_block_erase(void *block) noexcept;
+
     class rb_iterator
     {
         void* _block_ptr;
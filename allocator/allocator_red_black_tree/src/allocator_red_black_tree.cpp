@@ -1,22 +1,31 @@
-#include <not_implemented.h>
-
+#include <algorithm>
 #include "../include/allocator_red_black_tree.h"
 
 allocator_red_black_tree::~allocator_red_black_tree()
 {
-    throw not_implemented("allocator_red_black_tree::~allocator_red_black_tree()", "your code should be here...");
+    destroy();
 }
 
 allocator_red_black_tree::allocator_red_black_tree(
-    allocator_red_black_tree &&other) noexcept
+    allocator_red_black_tree &&other) noexcept:
+    allocator_with_statistics(std::move(other)),
+    _trusted_memory(other._trusted_memory)
 {
-    throw not_implemented("allocator_red_black_tree::allocator_red_black_tree(allocator_red_black_tree &&) noexcept", "your code should be here...");
+    other._trusted_memory = nullptr;
 }
 
 allocator_red_black_tree &allocator_red_black_tree::operator=(
     allocator_red_black_tree &&other) noexcept
 {
-    throw not_implemented("allocator_red_black_tree &allocator_red_black_tree::operator=(allocator_red_black_tree &&) noexcept", "your code should be here...");
+    if (this != &other)
+    {
+        destroy();
+        allocator_with_statistics::operator=(std::move(other));
+        _trusted_memory = other._trusted_memory;
+        other._trusted_memory = nullptr;
+    }
+
+    return *this;
 }
 
 allocator_red_black_tree::allocator_red_black_tree(
@@ -25,116 +34,856 @@ allocator_red_black_tree::allocator_red_black_tree(
         logger *logger,
         allocator_with_fit_mode::fit_mode allocate_fit_mode)
 {
-    throw not_implemented("allocator_red_black_tree::allocator_red_black_tree(size_t ,std::pmr::memory_resource *,logger *,allocator_with_fit_mode::fit_mode)", "your code should be here...");
-}
+    if (space_size < free_block_metadata_size)
+    {
+        throw std::logic_error("allocator_red_black_tree: space size must hold at least one free block metadata");
+    }
 
-allocator_red_black_tree::allocator_red_black_tree(const allocator_red_black_tree &other)
-{
-    throw not_implemented("allocator_red_black_tree::allocator_red_black_tree(const allocator_red_black_tree &other)", "your code should be here...");
-}
+    if (parent_allocator == nullptr)
+    {
+        parent_allocator = std::pmr::get_default_resource();
+    }
 
-allocator_red_black_tree &allocator_red_black_tree::operator=(const allocator_red_black_tree &other)
-{
-    throw not_implemented("allocator_red_black_tree &allocator_red_black_tree::operator=(const allocator_red_black_tree &other)", "your code should be here...");
+    _trusted_memory = parent_allocator->allocate(allocator_metadata_size + space_size, alignof(std::max_align_t));
+
+    logger_ref(_trusted_memory) = logger;
+    parent_ref(_trusted_memory) = parent_allocator;
+    space_size_ref(_trusted_memory) = space_size;
+    new (&mutex_ref(_trusted_memory)) std::mutex();
+    fit_mode_ref(_trusted_memory) = allocate_fit_mode;
+    root_ref(_trusted_memory, free_tree::by_address) = nullptr;
+    root_ref(_trusted_memory, free_tree::by_size) = nullptr;
+
+    void *block = space_begin(_trusted_memory);
+    block_data_ref(block).occupied = false;
+    block_prev_ref(block) = nullptr;
+    block_next_ref(block) = nullptr;
+    free_block_insert(block);
+    publish_free_space();
+
+    debug_with_guard(get_typename() + ": created with " + std::to_string(space_size) + " bytes of space");
 }
 
-bool allocator_red_black_tree::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+void allocator_red_black_tree::destroy() noexcept
 {
-    throw not_implemented("bool allocator_red_black_tree::do_is_equal(const std::pmr::memory_resource &other) const noexcept", "your code should be here...");
+    if (_trusted_memory == nullptr)
+    {
+        return;
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+
+    auto *parent = parent_ref(_trusted_memory);
+    size_t trusted_size = allocator_metadata_size + space_size_ref(_trusted_memory);
+
+    mutex_ref(_trusted_memory).~mutex();
+    parent->deallocate(_trusted_memory, trusted_size, alignof(std::max_align_t));
+    _trusted_memory = nullptr;
 }
 
 [[nodiscard]] void *allocator_red_black_tree::do_allocate_sm(
     size_t size)
 {
-    throw not_implemented("[[nodiscard]] void *allocator_red_black_tree::do_allocate_sm(size_t)", "your code should be here...");
-}
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    if (size > space_size_ref(_trusted_memory))
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        record_failed_allocation(size);
+        throw std::bad_alloc();
+    }
+
+    size_t need = std::max(round_up(size) + occupied_block_metadata_size, free_block_metadata_size);
+    void *block;
+
+    switch (fit_mode_ref(_trusted_memory))
+    {
+        case fit_mode::first_fit:
+            block = find_first_fit(need);
+            break;
+        case fit_mode::the_best_fit:
+            block = find_best_fit(need);
+            break;
+        case fit_mode::the_worst_fit:
+            block = find_worst_fit(need);
+            break;
+    }
+
+    if (block == nullptr)
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        record_failed_allocation(size);
+        throw std::bad_alloc();
+    }
+
+    if (block_size(_trusted_memory, block) - need >= free_block_metadata_size)
+    {
+        void *rest = reinterpret_cast<unsigned char *>(block) + need;
+        void *next = block_next_ref(block);
+
+        block_data_ref(rest).occupied = false;
+        block_prev_ref(rest) = block;
+        block_next_ref(rest) = next;
+        block_next_ref(block) = rest;
 
+        if (next != nullptr)
+        {
+            block_prev_ref(next) = rest;
+        }
+
+        tree_replace(block, rest);
+        tree_erase(block, free_tree::by_size);
+        tree_insert(rest, free_tree::by_size);
+    }
+    else
+    {
+        free_block_erase(block);
+    }
+
+    block_data_ref(block).occupied = true;
+    block_trusted_ref(block) = _trusted_memory;
+
+    record_allocation(size, block_size(_trusted_memory, block));
+    publish_free_space();
+
+    return reinterpret_cast<unsigned char *>(block) + occupied_block_metadata_size;
+}
 
 void allocator_red_black_tree::do_deallocate_sm(
     void *at)
 {
-    throw not_implemented("void allocator_red_black_tree::do_deallocate_sm(void *)", "your code should be here...");
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    void *block = reinterpret_cast<unsigned char *>(at) - occupied_block_metadata_size;
+
+    if (block < space_begin(_trusted_memory) || block >= space_end(_trusted_memory)
+        || !block_data_ref(block).occupied || block_trusted_ref(block) != _trusted_memory)
+    {
+        error_with_guard(get_typename() + ": pointer does not belong to allocated block");
+        throw std::logic_error("allocator_red_black_tree: pointer does not belong to allocated block");
+    }
+
+    record_deallocation(block_size(_trusted_memory, block));
+    block_data_ref(block).occupied = false;
+
+    void *next = block_next_ref(block);
+
+    if (next != nullptr && !block_data_ref(next).occupied)
+    {
+        free_block_erase(next);
+        next = block_next_ref(block) = block_next_ref(next);
+
+        if (next != nullptr)
+        {
+            block_prev_ref(next) = block;
+        }
+    }
+
+    void *prev = block_prev_ref(block);
+
+    if (prev != nullptr && !block_data_ref(prev).occupied)
+    {
+        tree_erase(prev, free_tree::by_size);
+        block_next_ref(prev) = next;
+
+        if (next != nullptr)
+        {
+            block_prev_ref(next) = prev;
+        }
+
+        update_max_upwards(prev);
+        tree_insert(prev, free_tree::by_size);
+        publish_free_space();
+        return;
+    }
+
+    free_block_insert(block);
+    publish_free_space();
+}
+
+void allocator_red_black_tree::publish_free_space() noexcept
+{
+    record_free_space(space_size_ref(_trusted_memory) - bytes_in_use(), subtree_max(root_ref(_trusted_memory)));
 }
 
 void allocator_red_black_tree::set_fit_mode(allocator_with_fit_mode::fit_mode mode)
 {
-    throw not_implemented("void allocator_red_black_tree::set_fit_mode(allocator_with_fit_mode::fit_mode)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    fit_mode_ref(_trusted_memory) = mode;
 }
 
 
 std::vector<allocator_test_utils::block_info> allocator_red_black_tree::get_blocks_info() const
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_red_black_tree::get_blocks_info() const", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    return get_blocks_info_inner();
 }
 
-inline logger *allocator_red_black_tree::get_logger() const
+std::vector<allocator_test_utils::block_info> allocator_red_black_tree::get_blocks_info_inner() const
 {
-    throw not_implemented("inline logger *allocator_red_black_tree::get_logger() const", "your code should be here...");
+    std::vector<allocator_test_utils::block_info> result;
+
+    for (auto it = begin(), last = end(); it != last; ++it)
+    {
+        result.push_back({ .block_size = it.size(), .is_block_occupied = it.occupied() });
+    }
+
+    return result;
 }
 
-std::vector<allocator_test_utils::block_info> allocator_red_black_tree::get_blocks_info_inner() const
+inline logger *allocator_red_black_tree::get_logger() const
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_red_black_tree::get_blocks_info_inner() const", "your code should be here...");
+    return _trusted_memory == nullptr ? nullptr : logger_ref(_trusted_memory);
 }
 
 inline std::string allocator_red_black_tree::get_typename() const noexcept
 {
-    throw not_implemented("inline std::string allocator_red_black_tree::get_typename() const noexcept", "your code should be here...");
+    return "allocator_red_black_tree";
 }
 
+bool allocator_red_black_tree::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    auto *other_red_black_tree = dynamic_cast<const allocator_red_black_tree *>(&other);
+
+    return other_red_black_tree != nullptr && other_red_black_tree->_trusted_memory == _trusted_memory;
+}
+
+logger *&allocator_red_black_tree::logger_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<logger **>(trusted);
+}
+
+std::pmr::memory_resource *&allocator_red_black_tree::parent_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<std::pmr::memory_resource **>(reinterpret_cast<unsigned char *>(trusted) + sizeof(logger *));
+}
+
+size_t &allocator_red_black_tree::space_size_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(&parent_ref(trusted)) + sizeof(std::pmr::memory_resource *));
+}
+
+std::mutex &allocator_red_black_tree::mutex_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<std::mutex *>(&space_size_ref(trusted) + 1);
+}
+
+void *&allocator_red_black_tree::root_ref(void *trusted, free_tree tree) noexcept
+{
+    return *(reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(&mutex_ref(trusted)) + sizeof(std::mutex)) + static_cast<size_t>(tree));
+}
+
+allocator_with_fit_mode::fit_mode &allocator_red_black_tree::fit_mode_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<fit_mode *>(&root_ref(trusted, free_tree::by_size) + 1);
+}
+
+void *allocator_red_black_tree::space_begin(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(trusted) + allocator_metadata_size;
+}
+
+void *allocator_red_black_tree::space_end(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(space_begin(trusted)) + space_size_ref(trusted);
+}
+
+allocator_red_black_tree::block_data &allocator_red_black_tree::block_data_ref(void *block) noexcept
+{
+    return *reinterpret_cast<block_data *>(block);
+}
+
+void *&allocator_red_black_tree::block_prev_ref(void *block) noexcept
+{
+    return *reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(block) + alignof(void *));
+}
+
+void *&allocator_red_black_tree::block_next_ref(void *block) noexcept
+{
+    return *(&block_prev_ref(block) + 1);
+}
+
+void *&allocator_red_black_tree::block_trusted_ref(void *block) noexcept
+{
+    return *(&block_prev_ref(block) + 2);
+}
+
+void *&allocator_red_black_tree::node_parent_ref(void *block, free_tree tree) noexcept
+{
+    return *(&block_prev_ref(block) + (tree == free_tree::by_address ? 2 : 6));
+}
+
+void *&allocator_red_black_tree::node_left_ref(void *block, free_tree tree) noexcept
+{
+    return *(&node_parent_ref(block, tree) + 1);
+}
+
+void *&allocator_red_black_tree::node_right_ref(void *block, free_tree tree) noexcept
+{
+    return *(&node_parent_ref(block, tree) + 2);
+}
+
+allocator_red_black_tree::block_color &allocator_red_black_tree::node_color_ref(void *block, free_tree tree) noexcept
+{
+    return tree == free_tree::by_address ? block_data_ref(block).address_color : block_data_ref(block).size_color;
+}
+
+size_t &allocator_red_black_tree::node_max_ref(void *block) noexcept
+{
+    return *reinterpret_cast<size_t *>(&block_prev_ref(block) + 5);
+}
+
+size_t allocator_red_black_tree::subtree_max(void *node) noexcept
+{
+    return node == nullptr ? 0 : node_max_ref(node);
+}
+
+size_t allocator_red_black_tree::block_size(void *trusted, void *block) noexcept
+{
+    void *next = block_next_ref(block);
+
+    return reinterpret_cast<unsigned char *>(next == nullptr ? space_end(trusted) : next) - reinterpret_cast<unsigned char *>(block);
+}
+
+size_t allocator_red_black_tree::round_up(size_t size) noexcept
+{
+    return (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+}
+
+bool allocator_red_black_tree::is_red(void *node, free_tree tree) noexcept
+{
+    return node != nullptr && node_color_ref(node, tree) == block_color::RED;
+}
+
+bool allocator_red_black_tree::node_less(void *node, void *other, free_tree tree) const noexcept
+{
+    if (tree == free_tree::by_size)
+    {
+        size_t node_size = block_size(_trusted_memory, node);
+        size_t other_size = block_size(_trusted_memory, other);
+
+        if (node_size != other_size)
+        {
+            return node_size < other_size;
+        }
+    }
+
+    return node < other;
+}
+
+void allocator_red_black_tree::update_max(void *node) const noexcept
+{
+    node_max_ref(node) = std::max({ block_size(_trusted_memory, node), subtree_max(node_left_ref(node)), subtree_max(node_right_ref(node)) });
+}
+
+void allocator_red_black_tree::update_max_upwards(void *node) const noexcept
+{
+    for (; node != nullptr; node = node_parent_ref(node))
+    {
+        update_max(node);
+    }
+}
+
+void *allocator_red_black_tree::find_first_fit(size_t size) const noexcept
+{
+    void *node = root_ref(_trusted_memory);
+
+    if (subtree_max(node) < size)
+    {
+        return nullptr;
+    }
+
+    while (true)
+    {
+        if (subtree_max(node_left_ref(node)) >= size)
+        {
+            node = node_left_ref(node);
+        }
+        else if (block_size(_trusted_memory, node) >= size)
+        {
+            return node;
+        }
+        else
+        {
+            node = node_right_ref(node);
+        }
+    }
+}
+
+/**
+ * Lower bound in the size tree: the smallest fitting block, the lowest addressed one among equal sizes
+ */
+void *allocator_red_black_tree::find_best_fit(size_t size) const noexcept
+{
+    void *result = nullptr;
+
+    for (void *node = root_ref(_trusted_memory, free_tree::by_size); node != nullptr;)
+    {
+        if (block_size(_trusted_memory, node) >= size)
+        {
+            result = node;
+            node = node_left_ref(node, free_tree::by_size);
+        }
+        else
+        {
+            node = node_right_ref(node, free_tree::by_size);
+        }
+    }
+
+    return result;
+}
+
+void *allocator_red_black_tree::find_worst_fit(size_t size) const noexcept
+{
+    void *node = root_ref(_trusted_memory);
+    size_t max = subtree_max(node);
+
+    if (max < size)
+    {
+        return nullptr;
+    }
+
+    while (true)
+    {
+        if (subtree_max(node_left_ref(node)) == max)
+        {
+            node = node_left_ref(node);
+        }
+        else if (block_size(_trusted_memory, node) == max)
+        {
+            return node;
+        }
+        else
+        {
+            node = node_right_ref(node);
+        }
+    }
+}
+
+void allocator_red_black_tree::rotate_left(void *node, free_tree tree) noexcept
+{
+    void *pivot = node_right_ref(node, tree);
+    void *parent = node_parent_ref(node, tree);
+
+    node_right_ref(node, tree) = node_left_ref(pivot, tree);
+
+    if (node_left_ref(pivot, tree) != nullptr)
+    {
+        node_parent_ref(node_left_ref(pivot, tree), tree) = node;
+    }
+
+    node_parent_ref(pivot, tree) = parent;
+
+    if (parent == nullptr)
+    {
+        root_ref(_trusted_memory, tree) = pivot;
+    }
+    else if (node_left_ref(parent, tree) == node)
+    {
+        node_left_ref(parent, tree) = pivot;
+    }
+    else
+    {
+        node_right_ref(parent, tree) = pivot;
+    }
+
+    node_left_ref(pivot, tree) = node;
+    node_parent_ref(node, tree) = pivot;
+
+    if (tree == free_tree::by_address)
+    {
+        update_max(node);
+        update_max(pivot);
+    }
+}
+
+void allocator_red_black_tree::rotate_right(void *node, free_tree tree) noexcept
+{
+    void *pivot = node_left_ref(node, tree);
+    void *parent = node_parent_ref(node, tree);
+
+    node_left_ref(node, tree) = node_right_ref(pivot, tree);
+
+    if (node_right_ref(pivot, tree) != nullptr)
+    {
+        node_parent_ref(node_right_ref(pivot, tree), tree) = node;
+    }
+
+    node_parent_ref(pivot, tree) = parent;
+
+    if (parent == nullptr)
+    {
+        root_ref(_trusted_memory, tree) = pivot;
+    }
+    else if (node_right_ref(parent, tree) == node)
+    {
+        node_right_ref(parent, tree) = pivot;
+    }
+    else
+    {
+        node_left_ref(parent, tree) = pivot;
+    }
+
+    node_right_ref(pivot, tree) = node;
+    node_parent_ref(node, tree) = pivot;
+
+    if (tree == free_tree::by_address)
+    {
+        update_max(node);
+        update_max(pivot);
+    }
+}
+
+void allocator_red_black_tree::tree_insert(void *node, free_tree tree) noexcept
+{
+    void *parent = nullptr;
+    void **link = &root_ref(_trusted_memory, tree);
+
+    while (*link != nullptr)
+    {
+        parent = *link;
+        link = node_less(node, parent, tree) ? &node_left_ref(parent, tree) : &node_right_ref(parent, tree);
+    }
+
+    *link = node;
+    node_parent_ref(node, tree) = parent;
+    node_left_ref(node, tree) = nullptr;
+    node_right_ref(node, tree) = nullptr;
+    node_color_ref(node, tree) = block_color::RED;
+
+    if (tree == free_tree::by_address)
+    {
+        update_max_upwards(node);
+    }
+
+    while (is_red(parent = node_parent_ref(node, tree), tree))
+    {
+        void *grandparent = node_parent_ref(parent, tree);
+
+        if (parent == node_left_ref(grandparent, tree))
+        {
+            void *uncle = node_right_ref(grandparent, tree);
+
+            if (is_red(uncle, tree))
+            {
+                node_color_ref(parent, tree) = block_color::BLACK;
+                node_color_ref(uncle, tree) = block_color::BLACK;
+                node_color_ref(grandparent, tree) = block_color::RED;
+                node = grandparent;
+                continue;
+            }
+
+            if (node == node_right_ref(parent, tree))
+            {
+                rotate_left(parent, tree);
+                std::swap(node, parent);
+            }
+
+            node_color_ref(parent, tree) = block_color::BLACK;
+            node_color_ref(grandparent, tree) = block_color::RED;
+            rotate_right(grandparent, tree);
+        }
+        else
+        {
+            void *uncle = node_left_ref(grandparent, tree);
+
+            if (is_red(uncle, tree))
+            {
+                node_color_ref(parent, tree) = block_color::BLACK;
+                node_color_ref(uncle, tree) = block_color::BLACK;
+                node_color_ref(grandparent, tree) = block_color::RED;
+                node = grandparent;
+                continue;
+            }
+
+            if (node == node_left_ref(parent, tree))
+            {
+                rotate_right(parent, tree);
+                std::swap(node, parent);
+            }
+
+            node_color_ref(parent, tree) = block_color::BLACK;
+            node_color_ref(grandparent, tree) = block_color::RED;
+            rotate_left(grandparent, tree);
+        }
+    }
+
+    node_color_ref(root_ref(_trusted_memory, tree), tree) = block_color::BLACK;
+}
+
+void allocator_red_black_tree::tree_erase(void *node, free_tree tree) noexcept
+{
+    auto transplant = [this, tree](void *from, void *to)
+    {
+        void *parent = node_parent_ref(from, tree);
+
+        if (parent == nullptr)
+        {
+            root_ref(_trusted_memory, tree) = to;
+        }
+        else if (node_left_ref(parent, tree) == from)
+        {
+            node_left_ref(parent, tree) = to;
+        }
+        else
+        {
+            node_right_ref(parent, tree) = to;
+        }
+
+        if (to != nullptr)
+        {
+            node_parent_ref(to, tree) = parent;
+        }
+    };
+
+    void *child;
+    void *child_parent;
+    block_color removed_color = node_color_ref(node, tree);
+
+    if (node_left_ref(node, tree) == nullptr)
+    {
+        child = node_right_ref(node, tree);
+        child_parent = node_parent_ref(node, tree);
+        transplant(node, child);
+    }
+    else if (node_right_ref(node, tree) == nullptr)
+    {
+        child = node_left_ref(node, tree);
+        child_parent = node_parent_ref(node, tree);
+        transplant(node, child);
+    }
+    else
+    {
+        void *successor = node_right_ref(node, tree);
+
+        while (node_left_ref(successor, tree) != nullptr)
+        {
+            successor = node_left_ref(successor, tree);
+        }
+
+        removed_color = node_color_ref(successor, tree);
+        child = node_right_ref(successor, tree);
+
+        if (node_parent_ref(successor, tree) == node)
+        {
+            child_parent = successor;
+        }
+        else
+        {
+            child_parent = node_parent_ref(successor, tree);
+            transplant(successor, child);
+            node_right_ref(successor, tree) = node_right_ref(node, tree);
+            node_parent_ref(node_right_ref(successor, tree), tree) = successor;
+        }
+
+        transplant(node, successor);
+        node_left_ref(successor, tree) = node_left_ref(node, tree);
+        node_parent_ref(node_left_ref(successor, tree), tree) = successor;
+        node_color_ref(successor, tree) = node_color_ref(node, tree);
+    }
+
+    if (tree == free_tree::by_address)
+    {
+        update_max_upwards(child_parent);
+    }
+
+    if (removed_color == block_color::RED)
+    {
+        return;
+    }
+
+    while (child != root_ref(_trusted_memory, tree) && !is_red(child, tree))
+    {
+        if (child == node_left_ref(child_parent, tree))
+        {
+            void *sibling = node_right_ref(child_parent, tree);
+
+            if (is_red(sibling, tree))
+            {
+                node_color_ref(sibling, tree) = block_color::BLACK;
+                node_color_ref(child_parent, tree) = block_color::RED;
+                rotate_left(child_parent, tree);
+                sibling = node_right_ref(child_parent, tree);
+            }
+
+            if (!is_red(node_left_ref(sibling, tree), tree) && !is_red(node_right_ref(sibling, tree), tree))
+            {
+                node_color_ref(sibling, tree) = block_color::RED;
+                child = child_parent;
+                child_parent = node_parent_ref(child, tree);
+                continue;
+            }
+
+            if (!is_red(node_right_ref(sibling, tree), tree))
+            {
+                node_color_ref(node_left_ref(sibling, tree), tree) = block_color::BLACK;
+                node_color_ref(sibling, tree) = block_color::RED;
+                rotate_right(sibling, tree);
+                sibling = node_right_ref(child_parent, tree);
+            }
+
+            node_color_ref(sibling, tree) = node_color_ref(child_parent, tree);
+            node_color_ref(child_parent, tree) = block_color::BLACK;
+            node_color_ref(node_right_ref(sibling, tree), tree) = block_color::BLACK;
+            rotate_left(child_parent, tree);
+        }
+        else
+        {
+            void *sibling = node_left_ref(child_parent, tree);
+
+            if (is_red(sibling, tree))
+            {
+                node_color_ref(sibling, tree) = block_color::BLACK;
+                node_color_ref(child_parent, tree) = block_color::RED;
+                rotate_right(child_parent, tree);
+                sibling = node_left_ref(child_parent, tree);
+            }
+
+            if (!is_red(node_left_ref(sibling, tree), tree) && !is_red(node_right_ref(sibling, tree), tree))
+            {
+                node_color_ref(sibling, tree) = block_color::RED;
+                child = child_parent;
+                child_parent = node_parent_ref(child, tree);
+                continue;
+            }
+
+            if (!is_red(node_left_ref(sibling, tree), tree))
+            {
+                node_color_ref(node_right_ref(sibling, tree), tree) = block_color::BLACK;
+                node_color_ref(sibling, tree) = block_color::RED;
+                rotate_left(sibling, tree);
+                sibling = node_left_ref(child_parent, tree);
+            }
+
+            node_color_ref(sibling, tree) = node_color_ref(child_parent, tree);
+            node_color_ref(child_parent, tree) = block_color::BLACK;
+            node_color_ref(node_left_ref(sibling, tree), tree) = block_color::BLACK;
+            rotate_right(child_parent, tree);
+        }
+
+        child = root_ref(_trusted_memory, tree);
+    }
+
+    if (child != nullptr)
+    {
+        node_color_ref(child, tree) = block_color::BLACK;
+    }
+}
+
+void allocator_red_black_tree::tree_replace(void *node, void *replacement) noexcept
+{
+    void *parent = node_parent_ref(node);
+    void *left = node_left_ref(node);
+    void *right = node_right_ref(node);
+
+    if (parent == nullptr)
+    {
+        root_ref(_trusted_memory) = replacement;
+    }
+    else if (node_left_ref(parent) == node)
+    {
+        node_left_ref(parent) = replacement;
+    }
+    else
+    {
+        node_right_ref(parent) = replacement;
+    }
+
+    if (left != nullptr)
+    {
+        node_parent_ref(left) = replacement;
+    }
+
+    if (right != nullptr)
+    {
+        node_parent_ref(right) = replacement;
+    }
+
+    node_parent_ref(replacement) = parent;
+    node_left_ref(replacement) = left;
+    node_right_ref(replacement) = right;
+    block_data_ref(replacement).address_color = block_data_ref(node).address_color;
+
+    update_max_upwards(replacement);
+}
+
+void allocator_red_black_tree::free_block_insert(void *block) noexcept
+{
+    tree_insert(block, free_tree::by_address);
+    tree_insert(block, free_tree::by_size);
+}
+
+void allocator_red_black_tree::free_block_erase(void *block) noexcept
+{
+    tree_erase(block, free_tree::by_address);
+    tree_erase(block, free_tree::by_size);
+}
 
 allocator_red_black_tree::rb_iterator allocator_red_black_tree::begin() const noexcept
 {
-    throw not_implemented("allocator_red_black_tree::rb_iterator allocator_red_black_tree::begin() const noexcept", "your code should be here...");
+    return rb_iterator(_trusted_memory);
 }
 
 allocator_red_black_tree::rb_iterator allocator_red_black_tree::end() const noexcept
 {
-    throw not_implemented("allocator_red_black_tree::rb_iterator allocator_red_black_tree::end() const noexcept", "your code should be here...");
+    return rb_iterator();
 }
 
-
 bool allocator_red_black_tree::rb_iterator::operator==(const allocator_red_black_tree::rb_iterator &other) const noexcept
 {
-    throw not_implemented("bool allocator_red_black_tree::rb_iterator::operator==(const allocator_red_black_tree::rb_iterator &) const noexcept", "your code should be here...");
+    return _block_ptr == other._block_ptr;
 }
 
 bool allocator_red_black_tree::rb_iterator::operator!=(const allocator_red_black_tree::rb_iterator &other) const noexcept
 {
-    throw not_implemented("bool allocator_red_black_tree::rb_iterator::operator!=(const allocator_red_black_tree::rb_iterator &) const noexcept", "your code should be here...");
+    return !(*this == other);
 }
 
 allocator_red_black_tree::rb_iterator &allocator_red_black_tree::rb_iterator::operator++() & noexcept
 {
-    throw not_implemented("allocator_red_black_tree::rb_iterator &allocator_red_black_tree::rb_iterator::operator++() & noexcept", "your code should be here...");
+    _block_ptr = block_next_ref(_block_ptr);
+
+    return *this;
 }
 
 allocator_red_black_tree::rb_iterator allocator_red_black_tree::rb_iterator::operator++(int n)
 {
-    throw not_implemented("allocator_red_black_tree::rb_iterator allocator_red_black_tree::rb_iterator::operator++(int)", "your code should be here...");
+    auto copy = *this;
+    ++*this;
+
+    return copy;
 }
 
 size_t allocator_red_black_tree::rb_iterator::size() const noexcept
 {
-    throw not_implemented("size_t allocator_red_black_tree::rb_iterator::size() const noexcept", "your code should be here...");
+    return block_size(_trusted, _block_ptr);
 }
 
 void *allocator_red_black_tree::rb_iterator::operator*() const noexcept
 {
-    throw not_implemented("void *allocator_red_black_tree::rb_iterator::operator*() const noexcept", "your code should be here...");
+    return _block_ptr;
 }
 
-allocator_red_black_tree::rb_iterator::rb_iterator()
+allocator_red_black_tree::rb_iterator::rb_iterator():
+    _block_ptr(nullptr),
+    _trusted(nullptr)
 {
-    throw not_implemented("allocator_red_black_tree::rb_iterator::rb_iterator()", "your code should be here...");
 }
 
-allocator_red_black_tree::rb_iterator::rb_iterator(void *trusted)
+allocator_red_black_tree::rb_iterator::rb_iterator(void *trusted):
+    _block_ptr(space_begin(trusted)),
+    _trusted(trusted)
 {
-    throw not_implemented("allocator_red_black_tree::rb_iterator::rb_iterator(void *)", "your code should be here...");
 }
 
 bool allocator_red_black_tree::rb_iterator::occupied() const noexcept
 {
-    throw not_implemented("bool allocator_red_black_tree::rb_iterator::occupied() const noexcept", "your code should be here...");
+    return block_data_ref(_block_ptr).occupied;
 }
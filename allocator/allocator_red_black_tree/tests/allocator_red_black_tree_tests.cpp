@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
+#include <allocator_guards.h>
 #include <logger.h>
 #include <logger_builder.h>
 #include <client_logger_builder.h>
 #include <list>
+#include <random>
 #include <allocator_red_black_tree.h>
 
 logger *create_logger(
@@ -55,21 +57,31 @@ TEST(allocatorRBTPositiveTests, test1)
 													}
 												}));
 
-	std::unique_ptr<smart_mem_resource> alloc(new allocator_red_black_tree(3000, nullptr, logger_instance.get(), allocator_with_fit_mode::fit_mode::first_fit));
+	// 3000 bytes can't hold three 1000-byte blocks with any block metadata, so space leaves room for the third one
+	std::unique_ptr<smart_mem_resource> alloc(new allocator_red_black_tree(4000, nullptr, logger_instance.get(), allocator_with_fit_mode::fit_mode::first_fit));
 
 	auto first_block = reinterpret_cast<int *>(alloc->allocate(sizeof(int) * 250));
+	auto *freed_block = first_block;
 
 	auto second_block = reinterpret_cast<char *>(alloc->allocate(sizeof(int) * 250));
 	alloc->deallocate(first_block, 1);
 
 	first_block = reinterpret_cast<int *>(alloc->allocate(sizeof(int) * 229));
 
+	ASSERT_EQ(first_block, freed_block);
+
 	auto third_block = reinterpret_cast<int *>(alloc->allocate(sizeof(int) * 250));
 
 	alloc->deallocate(second_block, 1);
 	alloc->deallocate(first_block, 1);
 	alloc->deallocate(third_block, 1);
 
+	std::vector<allocator_test_utils::block_info> expected_blocks_state
+		{
+			{ .block_size = 4000, .is_block_occupied = false }
+		};
+
+	ASSERT_EQ(dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info(), expected_blocks_state);
 }
 
 TEST(allocatorRBTPositiveTests, test5)
@@ -220,6 +232,83 @@ TEST(allocatorRBTPositiveTests, test7)
 }
 
 
+TEST(allocatorRBTPositiveTests, test8)
+{
+	std::unique_ptr<smart_mem_resource> alloc(new allocator_red_black_tree(1 << 16));
+
+	ASSERT_EQ(allocator_test_utils::check_alignments(*alloc), "");
+}
+
+TEST(allocatorRBTPositiveTests, test9)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "heap is sized for the exact requests, guards overhead does not fit";
+    }
+
+	constexpr size_t space_size = 1 << 16;
+	std::unique_ptr<smart_mem_resource> alloc(new allocator_red_black_tree(space_size));
+	auto *the_same_subject = dynamic_cast<allocator_with_fit_mode *>(alloc.get());
+	auto *utils = dynamic_cast<allocator_test_utils *>(alloc.get());
+
+	std::mt19937 generator(42);
+	std::vector<void *> blocks;
+
+	for (size_t i = 0; i < 20000; ++i)
+	{
+		if (!blocks.empty() && generator() % 3 == 0)
+		{
+			std::swap(blocks[generator() % blocks.size()], blocks.back());
+			alloc->deallocate(blocks.back(), 1);
+			blocks.pop_back();
+			continue;
+		}
+
+		auto mode = static_cast<allocator_with_fit_mode::fit_mode>(generator() % 3);
+		size_t size = generator() % 1000;
+		size_t need = std::max<size_t>((size + 15) / 16 * 16 + 32, 80);
+		auto blocks_state = utils->get_blocks_info();
+		size_t expected = blocks_state.size();
+
+		for (size_t j = 0; j < blocks_state.size(); ++j)
+		{
+			if (blocks_state[j].is_block_occupied || blocks_state[j].block_size < need)
+			{
+				continue;
+			}
+
+			if (expected == blocks_state.size()
+				|| (mode == allocator_with_fit_mode::fit_mode::the_best_fit && blocks_state[j].block_size < blocks_state[expected].block_size)
+				|| (mode == allocator_with_fit_mode::fit_mode::the_worst_fit && blocks_state[j].block_size > blocks_state[expected].block_size))
+			{
+				expected = j;
+			}
+		}
+
+		the_same_subject->set_fit_mode(mode);
+
+		if (expected == blocks_state.size())
+		{
+			ASSERT_THROW(static_cast<void>(alloc->allocate(size)), std::bad_alloc);
+			continue;
+		}
+
+		blocks.push_back(alloc->allocate(size));
+
+		ASSERT_TRUE(utils->get_blocks_info()[expected].is_block_occupied);
+	}
+
+	for (void *block : blocks)
+	{
+		alloc->deallocate(block, 1);
+	}
+
+	auto blocks_state = utils->get_blocks_info();
+
+	ASSERT_EQ(blocks_state.size(), 1);
+	ASSERT_EQ(blocks_state[0].block_size, space_size);
+}
+
 int main(
     int argc,
     char *argv[])
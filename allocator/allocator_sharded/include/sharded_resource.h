@@ -0,0 +1,480 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_SHARDED_RESOURCE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_SHARDED_RESOURCE_H
+
+#include <pp_allocator.h>
+#include <address_ranges.h>
+#include <allocator_test_utils.h>
+#include <allocator_with_fit_mode.h>
+#include <logger_guardant.h>
+#include <typename_holder.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Several instances of a fixed-size allocator behind one resource, so threads stop contending for a single allocator mutex.
+ * Requests are routed to a shard by calling thread or by size class, a shard that can't serve a request
+ * is skipped and the request is stolen by the next shards. Deallocated pointers are routed back to the shard
+ * owning them by address through address_ranges: ranges shards got from parent while being constructed are kept in a sorted vector
+ * that is searched without locks, ranges got later are kept in a map guarded by a shared mutex.
+ */
+template<typename allocator>
+class sharded_resource final:
+    public smart_mem_resource,
+    public allocator_test_utils,
+    public allocator_with_fit_mode,
+    private logger_guardant,
+    private typename_holder
+{
+
+    static_assert(std::is_base_of_v<smart_mem_resource, allocator> && std::is_base_of_v<allocator_test_utils, allocator>);
+
+    static_assert(std::is_constructible_v<allocator, size_t, std::pmr::memory_resource*, logger*>);
+
+public:
+
+    enum class routing_mode
+    {
+        /**
+         * Each thread gets its own shard while there are enough of them
+         */
+        by_thread,
+
+        /**
+         * Requests of power of two size class k go to shard k modulo shards count, so blocks of one shard are alike
+         */
+        by_size
+    };
+
+private:
+
+    /**
+     * Shards are written by different threads, so each one takes its own cache lines
+     */
+    struct alignas(64) shard
+    {
+        address_range_parent<size_t> parent;
+
+        std::optional<allocator> instance;
+
+        /**
+         * Smallest request this shard failed to serve since its last deallocation in low bits,
+         * count of deallocations in high bits, so failure seen before a deallocation is never recorded after it.
+         * Bigger requests are stolen by other shards right away
+         */
+        std::atomic<size_t> failure_hint = hint_request_mask;
+
+        shard(sharded_resource *owner, size_t index);
+    };
+
+    static constexpr const size_t hint_generation_shift = sizeof(size_t) * 8 - 16;
+
+    static constexpr const size_t hint_request_mask = (size_t(1) << hint_generation_shift) - 1;
+
+    std::pmr::memory_resource *_parent;
+
+    logger *_logger;
+
+    routing_mode _routing_mode;
+
+    /**
+     * Shard indices by address, sealed once all shards are constructed.
+     * Declared before shards, since shards return their space through shard parents when destroyed
+     */
+    address_ranges<size_t> _ranges;
+
+    std::vector<std::unique_ptr<shard>> _shards;
+
+public:
+
+    explicit sharded_resource(
+        size_t shards_count,
+        size_t shard_space_size,
+        std::pmr::memory_resource *parent_allocator = nullptr,
+        logger *logger = nullptr,
+        routing_mode mode = routing_mode::by_thread,
+        allocator_with_fit_mode::fit_mode allocate_fit_mode = allocator_with_fit_mode::fit_mode::first_fit);
+
+    sharded_resource(
+        sharded_resource const &other) = delete;
+
+    sharded_resource &operator=(
+        sharded_resource const &other) = delete;
+
+    sharded_resource(
+        sharded_resource &&other) = delete;
+
+    sharded_resource &operator=(
+        sharded_resource &&other) = delete;
+
+    ~sharded_resource() override;
+
+public:
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size) override;
+
+    void do_deallocate_sm(
+        void *at) override;
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size,
+        size_t alignment) override;
+
+    void do_deallocate_sm(
+        void *at,
+        size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+
+    inline void set_fit_mode(
+        allocator_with_fit_mode::fit_mode mode) override;
+
+    size_t shards_count() const noexcept;
+
+    /**
+     * Index of shard owning the block, throws std::logic_error for pointers of no shard
+     */
+    size_t shard_of(
+        void const *at) const;
+
+public:
+
+    /**
+     * Blocks of all shards in shards order
+     */
+    std::vector<allocator_test_utils::block_info> get_blocks_info() const override;
+
+    std::vector<std::vector<allocator_test_utils::block_info>> get_shards_blocks_info() const;
+
+private:
+
+    std::vector<allocator_test_utils::block_info> get_blocks_info_inner() const override;
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    size_t route(
+        size_t size) const noexcept;
+
+    /**
+     * Shards count for pointers of no shard
+     */
+    size_t find_shard(
+        void const *at) const noexcept;
+
+    static size_t thread_number() noexcept;
+
+    /**
+     * Allocates from shard, on failure records request in its hint unless shard got a deallocation since hint was read
+     */
+    void *try_allocate(
+        shard &target,
+        size_t hint,
+        size_t size,
+        size_t alignment,
+        size_t request);
+
+    static void apply_fit_mode(shard &target, fit_mode mode);
+};
+
+template<typename allocator>
+sharded_resource<allocator>::shard::shard(sharded_resource *owner, size_t index):
+    parent(owner->_parent, &owner->_ranges, index)
+{
+}
+
+template<typename allocator>
+sharded_resource<allocator>::sharded_resource(
+    size_t shards_count,
+    size_t shard_space_size,
+    std::pmr::memory_resource *parent_allocator,
+    logger *logger,
+    routing_mode mode,
+    allocator_with_fit_mode::fit_mode allocate_fit_mode):
+    _parent(parent_allocator == nullptr ? std::pmr::get_default_resource() : parent_allocator),
+    _logger(logger),
+    _routing_mode(mode)
+{
+    if (shards_count == 0)
+    {
+        throw std::logic_error("sharded_resource: at least one shard is needed");
+    }
+
+    _shards.reserve(shards_count);
+
+    for (size_t i = 0; i < shards_count; ++i)
+    {
+        _shards.push_back(std::make_unique<shard>(this, i));
+        _shards.back()->instance.emplace(shard_space_size, &_shards.back()->parent, logger);
+        apply_fit_mode(*_shards.back(), allocate_fit_mode);
+    }
+
+    _ranges.seal();
+
+    debug_with_guard(get_typename() + ": created " + std::to_string(shards_count) + " shards of " + std::to_string(shard_space_size) + " bytes of space");
+}
+
+template<typename allocator>
+sharded_resource<allocator>::~sharded_resource()
+{
+    _shards.clear();
+}
+
+template<typename allocator>
+[[nodiscard]] void *sharded_resource<allocator>::do_allocate_sm(
+    size_t size)
+{
+    return do_allocate_sm(size, alignof(std::max_align_t));
+}
+
+template<typename allocator>
+void sharded_resource<allocator>::do_deallocate_sm(
+    void *at)
+{
+    do_deallocate_sm(at, alignof(std::max_align_t));
+}
+
+template<typename allocator>
+[[nodiscard]] void *sharded_resource<allocator>::do_allocate_sm(
+    size_t size,
+    size_t alignment)
+{
+    size_t request = std::min(size + (alignment > alignof(std::max_align_t) ? alignment : 0), hint_request_mask - 1);
+    size_t home = route(size);
+
+    // shards skipped by hint, those beyond the mask width are taken as skipped
+    uint64_t skipped = 0;
+
+    for (size_t step = 0; step < _shards.size(); ++step)
+    {
+        shard &target = *_shards[(home + step) % _shards.size()];
+        size_t hint = target.failure_hint.load(std::memory_order_acquire);
+
+        if (request >= (hint & hint_request_mask))
+        {
+            skipped |= step < 64 ? uint64_t(1) << step : 0;
+            continue;
+        }
+
+        if (void *result = try_allocate(target, hint, size, alignment, request); result != nullptr)
+        {
+            if (step != 0)
+            {
+                trace_with_guard([&] { return get_typename() + ": request of " + std::to_string(size) + " bytes is stolen from shard " +
+                    std::to_string(home) + " by shard " + std::to_string((home + step) % _shards.size()); });
+            }
+
+            return result;
+        }
+    }
+
+    // hint is only a guess, so shards it made to skip get one try before giving up
+    for (size_t step = 0; step < _shards.size(); ++step)
+    {
+        if (step < 64 && (skipped & uint64_t(1) << step) == 0)
+        {
+            continue;
+        }
+
+        shard &target = *_shards[(home + step) % _shards.size()];
+
+        if (void *result = try_allocate(target, target.failure_hint.load(std::memory_order_acquire), size, alignment, request); result != nullptr)
+        {
+            return result;
+        }
+    }
+
+    error_with_guard(get_typename() + ": no shard can allocate " + std::to_string(size) + " bytes");
+
+    throw std::bad_alloc();
+}
+
+template<typename allocator>
+void *sharded_resource<allocator>::try_allocate(
+    shard &target,
+    size_t hint,
+    size_t size,
+    size_t alignment,
+    size_t request)
+{
+    try
+    {
+        return static_cast<std::pmr::memory_resource &>(*target.instance).allocate(size, alignment);
+    }
+    catch (std::bad_alloc const &)
+    {
+        size_t generation = hint & ~hint_request_mask;
+
+        while ((hint & ~hint_request_mask) == generation && request < (hint & hint_request_mask) &&
+               !target.failure_hint.compare_exchange_weak(hint, generation | request, std::memory_order_acq_rel))
+        {
+        }
+
+        return nullptr;
+    }
+}
+
+template<typename allocator>
+void sharded_resource<allocator>::do_deallocate_sm(
+    void *at,
+    size_t alignment)
+{
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    size_t index = find_shard(at);
+
+    if (index == _shards.size())
+    {
+        error_with_guard(get_typename() + ": pointer does not belong to any shard");
+        throw std::logic_error("sharded_resource: pointer does not belong to any shard");
+    }
+
+    shard &owner = *_shards[index];
+
+    static_cast<std::pmr::memory_resource &>(*owner.instance).deallocate(at, 1, alignment);
+
+    size_t hint = owner.failure_hint.load(std::memory_order_relaxed);
+
+    // generation wraps silently, a failure would have to stay in flight for 2^16 deallocations to be mistaken
+    while (!owner.failure_hint.compare_exchange_weak(hint, ((hint & ~hint_request_mask) + (size_t(1) << hint_generation_shift)) | hint_request_mask,
+                                                     std::memory_order_acq_rel))
+    {
+    }
+}
+
+template<typename allocator>
+bool sharded_resource<allocator>::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+template<typename allocator>
+inline void sharded_resource<allocator>::set_fit_mode(
+    allocator_with_fit_mode::fit_mode mode)
+{
+    for (auto &target : _shards)
+    {
+        apply_fit_mode(*target, mode);
+    }
+}
+
+template<typename allocator>
+size_t sharded_resource<allocator>::shards_count() const noexcept
+{
+    return _shards.size();
+}
+
+template<typename allocator>
+size_t sharded_resource<allocator>::shard_of(
+    void const *at) const
+{
+    size_t index = find_shard(at);
+
+    if (index == _shards.size())
+    {
+        throw std::logic_error("sharded_resource: pointer does not belong to any shard");
+    }
+
+    return index;
+}
+
+template<typename allocator>
+size_t sharded_resource<allocator>::find_shard(
+    void const *at) const noexcept
+{
+    return _ranges.find(at).value_or(_shards.size());
+}
+
+template<typename allocator>
+std::vector<allocator_test_utils::block_info> sharded_resource<allocator>::get_blocks_info() const
+{
+    return get_blocks_info_inner();
+}
+
+template<typename allocator>
+std::vector<std::vector<allocator_test_utils::block_info>> sharded_resource<allocator>::get_shards_blocks_info() const
+{
+    std::vector<std::vector<allocator_test_utils::block_info>> result;
+
+    for (auto const &target : _shards)
+    {
+        result.push_back(static_cast<allocator_test_utils const &>(*target->instance).get_blocks_info());
+    }
+
+    return result;
+}
+
+template<typename allocator>
+std::vector<allocator_test_utils::block_info> sharded_resource<allocator>::get_blocks_info_inner() const
+{
+    std::vector<allocator_test_utils::block_info> result;
+
+    for (auto const &target : _shards)
+    {
+        auto shard_blocks = static_cast<allocator_test_utils const &>(*target->instance).get_blocks_info();
+
+        result.insert(result.end(), shard_blocks.begin(), shard_blocks.end());
+    }
+
+    return result;
+}
+
+template<typename allocator>
+inline logger *sharded_resource<allocator>::get_logger() const
+{
+    return _logger;
+}
+
+template<typename allocator>
+inline std::string sharded_resource<allocator>::get_typename() const
+{
+    return "sharded_resource";
+}
+
+template<typename allocator>
+size_t sharded_resource<allocator>::route(
+    size_t size) const noexcept
+{
+    if (_routing_mode == routing_mode::by_size)
+    {
+        return std::bit_width(size == 0 ? size_t(0) : size - 1) % _shards.size();
+    }
+
+    return thread_number() % _shards.size();
+}
+
+template<typename allocator>
+size_t sharded_resource<allocator>::thread_number() noexcept
+{
+    static std::atomic<size_t> threads_count = 0;
+    thread_local size_t const number = threads_count.fetch_add(1, std::memory_order_relaxed);
+
+    return number;
+}
+
+template<typename allocator>
+void sharded_resource<allocator>::apply_fit_mode(shard &target, fit_mode mode)
+{
+    if constexpr (std::is_base_of_v<allocator_with_fit_mode, allocator>)
+    {
+        static_cast<allocator_with_fit_mode &>(*target.instance).set_fit_mode(mode);
+    }
+}
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_SHARDED_RESOURCE_H
@@ -0,0 +1 @@
+#include "../include/sharded_resource.h"
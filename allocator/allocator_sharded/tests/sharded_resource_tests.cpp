@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <allocator_guards.h>
+#include <client_logger_builder.h>
+#include <sharded_resource.h>
+#include <allocator_sorted_list.h>
+#include <allocator_boundary_tags.h>
+#include <allocator_slab.h>
+#include <cstring>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(shardedResourcePositiveTests, test1)
+{
+    constexpr size_t shards_count = 4;
+
+    sharded_resource<allocator_boundary_tags> subject(shards_count, 1 << 16);
+    std::vector<size_t> shards(shards_count);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < shards_count; ++t)
+    {
+        threads.emplace_back([&subject, &shards, t]
+        {
+            void *block = subject.allocate(100);
+
+            shards[t] = subject.shard_of(block);
+            subject.deallocate(block, 100);
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(std::set<size_t>(shards.begin(), shards.end()).size(), shards_count);
+}
+
+TEST(shardedResourcePositiveTests, test2)
+{
+    sharded_resource<allocator_sorted_list> subject(2, 4096);
+
+    auto *first_block = subject.allocate(3000);
+    auto *second_block = subject.allocate(3000);
+
+    ASSERT_NE(subject.shard_of(first_block), subject.shard_of(second_block));
+    ASSERT_THROW(static_cast<void>(subject.allocate(3000)), std::bad_alloc);
+
+    subject.deallocate(first_block, 3000);
+
+    auto *third_block = subject.allocate(3000);
+
+    ASSERT_EQ(subject.shard_of(third_block), subject.shard_of(first_block));
+
+    auto shards_blocks = subject.get_shards_blocks_info();
+
+    ASSERT_EQ(shards_blocks.size(), 2);
+    ASSERT_TRUE(shards_blocks[0].front().is_block_occupied);
+    ASSERT_TRUE(shards_blocks[1].front().is_block_occupied);
+
+    subject.deallocate(second_block, 3000);
+    subject.deallocate(third_block, 3000);
+
+    for (auto const &block : subject.get_blocks_info())
+    {
+        ASSERT_FALSE(block.is_block_occupied);
+    }
+}
+
+TEST(shardedResourcePositiveTests, test3)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "routing by size sees requests grown by allocator guards overhead";
+    }
+
+    using routing_mode = sharded_resource<allocator_slab>::routing_mode;
+
+    sharded_resource<allocator_slab> subject(4, 1 << 16, nullptr, nullptr, routing_mode::by_size);
+
+    auto *small_block = subject.allocate(16);
+    auto *medium_block = subject.allocate(32);
+    auto *large_block = reinterpret_cast<unsigned char *>(subject.allocate(100000));
+
+    ASSERT_EQ(subject.shard_of(small_block), 0);
+    ASSERT_EQ(subject.shard_of(medium_block), 1);
+    ASSERT_EQ(subject.shard_of(large_block), subject.shard_of(large_block + 99999));
+
+    std::memset(large_block, 0, 100000);
+
+    subject.deallocate(large_block, 100000);
+    subject.deallocate(medium_block, 32);
+    subject.deallocate(small_block, 16);
+}
+
+TEST(shardedResourcePositiveTests, test4)
+{
+    constexpr size_t threads_count = 8;
+
+    sharded_resource<allocator_boundary_tags> subject(4, 1 << 20, nullptr, nullptr);
+    std::vector<std::thread> threads;
+    std::vector<char> intact(threads_count, false);
+
+    for (size_t t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&subject, &intact, t]
+        {
+            std::map<int, int, std::less<>, pp_allocator<std::pair<const int, int>>> values{ pp_allocator<std::pair<const int, int>>(&subject) };
+            std::mt19937 generator(static_cast<unsigned>(t));
+
+            for (int i = 0; i < 5000; ++i)
+            {
+                int key = static_cast<int>(generator() % 1000);
+
+                if (generator() % 3 == 0)
+                {
+                    values.erase(key);
+                }
+                else
+                {
+                    values[key] = key * 2;
+                }
+            }
+
+            intact[t] = std::all_of(values.begin(), values.end(), [](auto const &value) { return value.second == value.first * 2; });
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_TRUE(std::all_of(intact.begin(), intact.end(), [](bool value) { return value; }));
+
+    for (auto const &block : subject.get_blocks_info())
+    {
+        ASSERT_FALSE(block.is_block_occupied);
+    }
+}
+
+TEST(shardedResourcePositiveTests, test5)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "heap is sized for the exact requests, guards overhead does not fit";
+    }
+
+    sharded_resource<allocator_slab> subject(1, 2 * allocator_slab::slab_size);
+    std::vector<void *> small_blocks;
+
+    // one slab serves the 32 byte class, the other is filled with 16 byte objects until the shard fails
+    auto *medium_block = subject.allocate(32);
+
+    while (true)
+    {
+        try
+        {
+            small_blocks.push_back(subject.allocate(16));
+        }
+        catch (std::bad_alloc const &)
+        {
+            break;
+        }
+    }
+
+    // shard failed a smaller request, yet its 32 byte slab still has room
+    auto *another_medium_block = subject.allocate(32);
+
+    ASSERT_EQ(subject.shard_of(another_medium_block), 0);
+
+    subject.deallocate(another_medium_block, 32);
+    subject.deallocate(medium_block, 32);
+
+    for (auto *block : small_blocks)
+    {
+        subject.deallocate(block, 16);
+    }
+
+    for (auto const &block : subject.get_blocks_info())
+    {
+        ASSERT_FALSE(block.is_block_occupied);
+    }
+}
+
+TEST(shardedResourceFalsePositiveTests, test1)
+{
+    ASSERT_THROW(sharded_resource<allocator_sorted_list>(0, 4096), std::logic_error);
+
+    sharded_resource<allocator_sorted_list> subject(2, 4096);
+    int foreign;
+
+    ASSERT_THROW(static_cast<void>(subject.allocate(5000)), std::bad_alloc);
+
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "allocator guards abort on a foreign pointer before the allocator can reject it";
+    }
+
+    ASSERT_THROW(subject.deallocate(&foreign, 1), std::logic_error);
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
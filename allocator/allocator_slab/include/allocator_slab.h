@@ -0,0 +1,157 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATOR_SLAB_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATOR_SLAB_H
+
+#include <pp_allocator.h>
+#include <allocator_test_utils.h>
+#include <allocator_with_statistics.h>
+#include <allocator_dbg_helper.h>
+#include <logger_guardant.h>
+#include <typename_holder.h>
+#include <mutex>
+
+/**
+ * Trusted memory is carved into slabs of slab_size bytes, every slab serves objects of a single size class.
+ * Free objects of a slab are threaded into intrusive free list, so allocate and deallocate are O(1).
+ * Slabs with free objects are kept in per-class doubly linked lists, fully freed slabs return to common pool
+ * and may be reused by any size class.
+ * Requests bigger than max_size_class are forwarded to parent allocator.
+ */
+class allocator_slab final:
+    public smart_mem_resource,
+    public allocator_test_utils,
+    public allocator_with_statistics,
+    private allocator_dbg_helper,
+    private logger_guardant,
+    private typename_holder
+{
+
+public:
+
+    static constexpr const size_t slab_size = 4096;
+
+    static constexpr const size_t min_size_class_power = 3;
+
+    static constexpr const size_t size_classes_count = 8;
+
+    static constexpr const size_t max_size_class = size_t(1) << (min_size_class_power + size_classes_count - 1);
+
+private:
+
+    void *_trusted_memory;
+
+    static constexpr const size_t allocator_metadata_size = sizeof(logger*) + sizeof(std::pmr::memory_resource *) + sizeof(size_t) + sizeof(std::mutex) +
+                                                            sizeof(void*) + sizeof(void*) + size_classes_count * sizeof(void*);
+
+    static constexpr const size_t slabs_offset = (allocator_metadata_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    /**
+     * size class index, free objects count, free list, previous and next slab
+     */
+    static constexpr const size_t slab_metadata_size = sizeof(size_t) + sizeof(size_t) + 3 * sizeof(void*);
+
+    static constexpr const size_t slab_payload_offset = (slab_metadata_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    static constexpr const size_t free_slab_marker = size_classes_count;
+
+    static constexpr const size_t large_block_metadata_size = alignof(std::max_align_t);
+
+public:
+
+    explicit allocator_slab(
+            size_t space_size,
+            std::pmr::memory_resource *parent_allocator = nullptr,
+            logger *logger = nullptr);
+
+    allocator_slab(
+        allocator_slab const &other) = delete;
+
+    allocator_slab &operator=(
+        allocator_slab const &other) = delete;
+
+    allocator_slab(
+        allocator_slab &&other) noexcept;
+
+    allocator_slab &operator=(
+        allocator_slab &&other) noexcept;
+
+    ~allocator_slab() override;
+
+public:
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size) override;
+
+    void do_deallocate_sm(
+        void *at) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size,
+        size_t alignment) override;
+
+    std::vector<allocator_test_utils::block_info> get_blocks_info() const override;
+
+private:
+
+    std::vector<allocator_test_utils::block_info> get_blocks_info_inner() const override;
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    void destroy() noexcept;
+
+    static size_t size_class_index(size_t size) noexcept;
+
+    static size_t size_class_size(size_t index) noexcept;
+
+    static size_t objects_per_slab(size_t index) noexcept;
+
+    logger *&logger_ref() const noexcept;
+
+    std::pmr::memory_resource *&parent_ref() const noexcept;
+
+    size_t &space_size_ref() const noexcept;
+
+    std::mutex &mutex_ref() const noexcept;
+
+    void *&uncarved_ref() const noexcept;
+
+    void *&free_slabs_ref() const noexcept;
+
+    void *&partial_slabs_ref(size_t index) const noexcept;
+
+    void *slabs_begin() const noexcept;
+
+    void *slabs_end() const noexcept;
+
+    static size_t &slab_class_ref(void *slab) noexcept;
+
+    static size_t &slab_free_count_ref(void *slab) noexcept;
+
+    static void *&slab_free_list_ref(void *slab) noexcept;
+
+    static void *&slab_prev_ref(void *slab) noexcept;
+
+    static void *&slab_next_ref(void *slab) noexcept;
+
+    void *slab_of(void *object) const noexcept;
+
+    void *take_slab(size_t index);
+
+    void link_partial(void *slab, size_t index) noexcept;
+
+    void unlink_partial(void *slab, size_t index) noexcept;
+
+    void *allocate_large(size_t size);
+
+    void deallocate_large(void *at);
+
+    /**
+     * Largest free block is the uncarved tail, a whole free slab or an object of the greatest partial class
+     */
+    void publish_free_space() noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATOR_SLAB_H
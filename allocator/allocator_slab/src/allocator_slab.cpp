@@ -0,0 +1,473 @@
+#include <bit>
+#include "../include/allocator_slab.h"
+
+allocator_slab::allocator_slab(
+    size_t space_size,
+    std::pmr::memory_resource *parent_allocator,
+    logger *logger)
+{
+    if (space_size < slab_size)
+    {
+        throw std::logic_error("allocator_slab: space size must hold at least one slab of " + std::to_string(slab_size) + " bytes");
+    }
+
+    if (parent_allocator == nullptr)
+    {
+        parent_allocator = std::pmr::get_default_resource();
+    }
+
+    size_t slabs_count = space_size / slab_size;
+    size_t trusted_size = slabs_offset + slabs_count * slab_size;
+
+    _trusted_memory = parent_allocator->allocate(trusted_size, alignof(std::max_align_t));
+
+    logger_ref() = logger;
+    parent_ref() = parent_allocator;
+    space_size_ref() = slabs_count * slab_size;
+    new (&mutex_ref()) std::mutex();
+    uncarved_ref() = slabs_begin();
+    free_slabs_ref() = nullptr;
+
+    for (size_t index = 0; index < size_classes_count; ++index)
+    {
+        partial_slabs_ref(index) = nullptr;
+    }
+
+    publish_free_space();
+
+    debug_with_guard(get_typename() + ": created with " + std::to_string(slabs_count) + " slabs");
+}
+
+allocator_slab::allocator_slab(
+    allocator_slab &&other) noexcept:
+    allocator_with_statistics(std::move(other)),
+    _trusted_memory(other._trusted_memory)
+{
+    other._trusted_memory = nullptr;
+}
+
+allocator_slab &allocator_slab::operator=(
+    allocator_slab &&other) noexcept
+{
+    if (this != &other)
+    {
+        destroy();
+        allocator_with_statistics::operator=(std::move(other));
+        _trusted_memory = other._trusted_memory;
+        other._trusted_memory = nullptr;
+    }
+
+    return *this;
+}
+
+allocator_slab::~allocator_slab()
+{
+    destroy();
+}
+
+void allocator_slab::destroy() noexcept
+{
+    if (_trusted_memory == nullptr)
+    {
+        return;
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+
+    auto *parent = parent_ref();
+    size_t trusted_size = slabs_offset + space_size_ref();
+
+    mutex_ref().~mutex();
+    parent->deallocate(_trusted_memory, trusted_size, alignof(std::max_align_t));
+    _trusted_memory = nullptr;
+}
+
+[[nodiscard]] void *allocator_slab::do_allocate_sm(
+    size_t size)
+{
+    size_t index = size_class_index(size);
+
+    if (index == size_classes_count)
+    {
+        return allocate_large(size);
+    }
+
+    std::lock_guard lock(mutex_ref());
+
+    void *slab = partial_slabs_ref(index);
+
+    if (slab == nullptr)
+    {
+        try
+        {
+            slab = take_slab(index);
+        }
+        catch (std::bad_alloc const &)
+        {
+            record_failed_allocation(size);
+            throw;
+        }
+
+        link_partial(slab, index);
+    }
+
+    void *object = slab_free_list_ref(slab);
+    slab_free_list_ref(slab) = *reinterpret_cast<void **>(object);
+
+    if (--slab_free_count_ref(slab) == 0)
+    {
+        unlink_partial(slab, index);
+    }
+
+    record_allocation(size, size_class_size(index));
+    publish_free_space();
+
+    return object;
+}
+
+void allocator_slab::do_deallocate_sm(
+    void *at)
+{
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    if (at < slabs_begin() || at >= slabs_end())
+    {
+        deallocate_large(at);
+        return;
+    }
+
+    std::lock_guard lock(mutex_ref());
+
+    void *slab = slab_of(at);
+    size_t index = slab_class_ref(slab);
+    size_t offset = reinterpret_cast<unsigned char *>(at) - reinterpret_cast<unsigned char *>(slab);
+
+    if (index == free_slab_marker || offset < slab_payload_offset
+        || (offset - slab_payload_offset) % size_class_size(index) != 0)
+    {
+        error_with_guard(get_typename() + ": pointer does not belong to any allocated object");
+        throw std::logic_error("allocator_slab: pointer does not belong to any allocated object");
+    }
+
+    record_deallocation(size_class_size(index));
+
+    *reinterpret_cast<void **>(at) = slab_free_list_ref(slab);
+    slab_free_list_ref(slab) = at;
+
+    size_t free_count = ++slab_free_count_ref(slab);
+
+    if (free_count == 1)
+    {
+        link_partial(slab, index);
+    }
+    else if (free_count == objects_per_slab(index))
+    {
+        unlink_partial(slab, index);
+        slab_class_ref(slab) = free_slab_marker;
+        slab_next_ref(slab) = free_slabs_ref();
+        free_slabs_ref() = slab;
+    }
+
+    publish_free_space();
+}
+
+[[nodiscard]] void *allocator_slab::do_allocate_sm(
+    size_t size,
+    size_t alignment)
+{
+    // objects of size class are aligned by min(class size, alignof(std::max_align_t))
+    return smart_mem_resource::do_allocate_sm(std::max(size, alignment), alignment);
+}
+
+bool allocator_slab::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+std::vector<allocator_test_utils::block_info> allocator_slab::get_blocks_info() const
+{
+    std::lock_guard lock(mutex_ref());
+
+    return get_blocks_info_inner();
+}
+
+std::vector<allocator_test_utils::block_info> allocator_slab::get_blocks_info_inner() const
+{
+    std::vector<allocator_test_utils::block_info> result;
+
+    auto *slab = reinterpret_cast<unsigned char *>(slabs_begin());
+    auto *uncarved = reinterpret_cast<unsigned char *>(uncarved_ref());
+
+    for (; slab != uncarved; slab += slab_size)
+    {
+        size_t index = slab_class_ref(slab);
+
+        if (index == free_slab_marker)
+        {
+            result.push_back({ .block_size = slab_size, .is_block_occupied = false });
+            continue;
+        }
+
+        size_t object_size = size_class_size(index);
+        size_t count = objects_per_slab(index);
+        std::vector<bool> occupied(count, true);
+
+        for (void *object = slab_free_list_ref(slab); object != nullptr; object = *reinterpret_cast<void **>(object))
+        {
+            occupied[(reinterpret_cast<unsigned char *>(object) - slab - slab_payload_offset) / object_size] = false;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            result.push_back({ .block_size = object_size, .is_block_occupied = occupied[i] });
+        }
+    }
+
+    if (uncarved != slabs_end())
+    {
+        result.push_back({ .block_size = static_cast<size_t>(reinterpret_cast<unsigned char *>(slabs_end()) - uncarved), .is_block_occupied = false });
+    }
+
+    return result;
+}
+
+inline logger *allocator_slab::get_logger() const
+{
+    return logger_ref();
+}
+
+inline std::string allocator_slab::get_typename() const
+{
+    return "allocator_slab";
+}
+
+size_t allocator_slab::size_class_index(size_t size) noexcept
+{
+    if (size > max_size_class)
+    {
+        return size_classes_count;
+    }
+
+    size_t power = std::bit_width(std::max(size, size_t(1) << min_size_class_power) - 1);
+
+    return power - min_size_class_power;
+}
+
+size_t allocator_slab::size_class_size(size_t index) noexcept
+{
+    return size_t(1) << (index + min_size_class_power);
+}
+
+size_t allocator_slab::objects_per_slab(size_t index) noexcept
+{
+    return (slab_size - slab_payload_offset) / size_class_size(index);
+}
+
+logger *&allocator_slab::logger_ref() const noexcept
+{
+    return *reinterpret_cast<logger **>(_trusted_memory);
+}
+
+std::pmr::memory_resource *&allocator_slab::parent_ref() const noexcept
+{
+    return *reinterpret_cast<std::pmr::memory_resource **>(reinterpret_cast<unsigned char *>(_trusted_memory) + sizeof(logger *));
+}
+
+size_t &allocator_slab::space_size_ref() const noexcept
+{
+    return *reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(_trusted_memory) + sizeof(logger *) + sizeof(std::pmr::memory_resource *));
+}
+
+std::mutex &allocator_slab::mutex_ref() const noexcept
+{
+    return *reinterpret_cast<std::mutex *>(reinterpret_cast<unsigned char *>(_trusted_memory) + sizeof(logger *) + sizeof(std::pmr::memory_resource *) + sizeof(size_t));
+}
+
+void *&allocator_slab::uncarved_ref() const noexcept
+{
+    return *reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(&mutex_ref()) + sizeof(std::mutex));
+}
+
+void *&allocator_slab::free_slabs_ref() const noexcept
+{
+    return *(&uncarved_ref() + 1);
+}
+
+void *&allocator_slab::partial_slabs_ref(size_t index) const noexcept
+{
+    return *(&uncarved_ref() + 2 + index);
+}
+
+void *allocator_slab::slabs_begin() const noexcept
+{
+    return reinterpret_cast<unsigned char *>(_trusted_memory) + slabs_offset;
+}
+
+void *allocator_slab::slabs_end() const noexcept
+{
+    return reinterpret_cast<unsigned char *>(slabs_begin()) + space_size_ref();
+}
+
+size_t &allocator_slab::slab_class_ref(void *slab) noexcept
+{
+    return *reinterpret_cast<size_t *>(slab);
+}
+
+size_t &allocator_slab::slab_free_count_ref(void *slab) noexcept
+{
+    return *(reinterpret_cast<size_t *>(slab) + 1);
+}
+
+void *&allocator_slab::slab_free_list_ref(void *slab) noexcept
+{
+    return *reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(slab) + 2 * sizeof(size_t));
+}
+
+void *&allocator_slab::slab_prev_ref(void *slab) noexcept
+{
+    return *(&slab_free_list_ref(slab) + 1);
+}
+
+void *&allocator_slab::slab_next_ref(void *slab) noexcept
+{
+    return *(&slab_free_list_ref(slab) + 2);
+}
+
+void *allocator_slab::slab_of(void *object) const noexcept
+{
+    auto *begin = reinterpret_cast<unsigned char *>(slabs_begin());
+    size_t offset = reinterpret_cast<unsigned char *>(object) - begin;
+
+    return begin + offset / slab_size * slab_size;
+}
+
+void *allocator_slab::take_slab(size_t index)
+{
+    void *slab = free_slabs_ref();
+
+    if (slab != nullptr)
+    {
+        free_slabs_ref() = slab_next_ref(slab);
+    }
+    else if (uncarved_ref() != slabs_end())
+    {
+        slab = uncarved_ref();
+        uncarved_ref() = reinterpret_cast<unsigned char *>(slab) + slab_size;
+    }
+    else
+    {
+        error_with_guard(get_typename() + ": no free slab for size class " + std::to_string(size_class_size(index)));
+        throw std::bad_alloc();
+    }
+
+    size_t object_size = size_class_size(index);
+    size_t count = objects_per_slab(index);
+    auto *payload = reinterpret_cast<unsigned char *>(slab) + slab_payload_offset;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        *reinterpret_cast<void **>(payload + i * object_size) = i + 1 == count ? nullptr : payload + (i + 1) * object_size;
+    }
+
+    slab_class_ref(slab) = index;
+    slab_free_count_ref(slab) = count;
+    slab_free_list_ref(slab) = payload;
+    slab_prev_ref(slab) = nullptr;
+    slab_next_ref(slab) = nullptr;
+
+    return slab;
+}
+
+void allocator_slab::link_partial(void *slab, size_t index) noexcept
+{
+    void *&head = partial_slabs_ref(index);
+
+    slab_prev_ref(slab) = nullptr;
+    slab_next_ref(slab) = head;
+
+    if (head != nullptr)
+    {
+        slab_prev_ref(head) = slab;
+    }
+
+    head = slab;
+}
+
+void allocator_slab::unlink_partial(void *slab, size_t index) noexcept
+{
+    void *prev = slab_prev_ref(slab);
+    void *next = slab_next_ref(slab);
+
+    if (prev != nullptr)
+    {
+        slab_next_ref(prev) = next;
+    }
+    else
+    {
+        partial_slabs_ref(index) = next;
+    }
+
+    if (next != nullptr)
+    {
+        slab_prev_ref(next) = prev;
+    }
+
+    slab_prev_ref(slab) = nullptr;
+    slab_next_ref(slab) = nullptr;
+}
+
+void *allocator_slab::allocate_large(size_t size)
+{
+    trace_with_guard([&] { return get_typename() + ": request of " + std::to_string(size) + " bytes is forwarded to parent allocator"; });
+
+    unsigned char *block;
+
+    try
+    {
+        block = reinterpret_cast<unsigned char *>(parent_ref()->allocate(size + large_block_metadata_size, alignof(std::max_align_t)));
+    }
+    catch (std::bad_alloc const &)
+    {
+        record_failed_allocation(size);
+        throw;
+    }
+
+    *reinterpret_cast<size_t *>(block) = size;
+
+    // large blocks live in parent allocator, so they do not occupy slabs space
+    record_allocation(size, 0);
+
+    return block + large_block_metadata_size;
+}
+
+void allocator_slab::deallocate_large(void *at)
+{
+    auto *block = reinterpret_cast<unsigned char *>(at) - large_block_metadata_size;
+
+    record_deallocation(0);
+    parent_ref()->deallocate(block, *reinterpret_cast<size_t *>(block) + large_block_metadata_size, alignof(std::max_align_t));
+}
+
+void allocator_slab::publish_free_space() noexcept
+{
+    size_t largest = static_cast<size_t>(reinterpret_cast<unsigned char *>(slabs_end()) - reinterpret_cast<unsigned char *>(uncarved_ref()));
+
+    if (free_slabs_ref() != nullptr)
+    {
+        largest = std::max(largest, slab_size);
+    }
+
+    for (size_t index = size_classes_count; index-- > 0 && size_class_size(index) > largest; )
+    {
+        if (partial_slabs_ref(index) != nullptr)
+        {
+            largest = size_class_size(index);
+            break;
+        }
+    }
+
+    record_free_space(space_size_ref() - bytes_in_use(), largest);
+}
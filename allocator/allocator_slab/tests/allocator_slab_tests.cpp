@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <allocator_guards.h>
+#include <logger.h>
+#include <logger_builder.h>
+#include <client_logger_builder.h>
+#include <list>
+#include <map>
+#include <set>
+
+#include "../include/allocator_slab.h"
+
+logger *create_logger(
+    std::vector<std::pair<std::string, logger::severity>> const &output_file_streams_setup,
+    bool use_console_stream = true,
+    logger::severity console_stream_severity = logger::severity::debug)
+{
+    std::unique_ptr<logger_builder> builder(new client_logger_builder());
+
+    if (use_console_stream)
+    {
+        builder->add_console_stream(console_stream_severity);
+    }
+
+    for (auto &output_file_stream_setup: output_file_streams_setup)
+    {
+        builder->add_file_stream(output_file_stream_setup.first, output_file_stream_setup.second);
+    }
+
+    logger *built_logger = builder->build();
+
+    return built_logger;
+}
+
+TEST(allocatorSlabPositiveTests, test1)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "block layout depends on allocator guards overhead";
+    }
+
+    std::unique_ptr<logger> logger_instance(create_logger(std::vector<std::pair<std::string, logger::severity>>
+                                                    {
+                                                            {
+                                                                    "allocator_slab_tests_logs_positive_test_1.txt",
+                                                                    logger::severity::information
+                                                            },
+                                                    }));
+
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_slab(allocator_slab::slab_size * 2, nullptr, logger_instance.get()));
+
+    auto first_block = reinterpret_cast<int *>(alloc->allocate(sizeof(int) * 5));
+    auto second_block = reinterpret_cast<int *>(alloc->allocate(sizeof(int) * 6));
+
+    ASSERT_EQ(reinterpret_cast<char *>(second_block) - reinterpret_cast<char *>(first_block), 32);
+
+    auto actual_blocks_state = dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info();
+
+    size_t objects_count = 0;
+    for (auto const &block : actual_blocks_state)
+    {
+        objects_count += block.block_size == 32;
+    }
+
+    ASSERT_EQ(actual_blocks_state[0], (allocator_test_utils::block_info{ .block_size = 32, .is_block_occupied = true }));
+    ASSERT_EQ(actual_blocks_state[1], (allocator_test_utils::block_info{ .block_size = 32, .is_block_occupied = true }));
+    ASSERT_EQ(actual_blocks_state[2], (allocator_test_utils::block_info{ .block_size = 32, .is_block_occupied = false }));
+    ASSERT_EQ(actual_blocks_state.back(), (allocator_test_utils::block_info{ .block_size = allocator_slab::slab_size, .is_block_occupied = false }));
+    ASSERT_EQ(objects_count, allocator_slab::slab_size / 32 - 2);
+
+    alloc->deallocate(first_block, 1);
+
+    ASSERT_EQ(alloc->allocate(sizeof(int) * 7), first_block);
+
+    alloc->deallocate(first_block, 1);
+    alloc->deallocate(second_block, 1);
+
+    actual_blocks_state = dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info();
+    std::vector<allocator_test_utils::block_info> expected_blocks_state
+        {
+            { .block_size = allocator_slab::slab_size, .is_block_occupied = false },
+            { .block_size = allocator_slab::slab_size, .is_block_occupied = false }
+        };
+
+    ASSERT_EQ(actual_blocks_state, expected_blocks_state);
+}
+
+TEST(allocatorSlabPositiveTests, test2)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "block layout depends on allocator guards overhead";
+    }
+
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_slab(allocator_slab::slab_size * 2));
+
+    // default alignment is alignof(std::max_align_t), which would put 3 bytes into the 16-byte class
+    auto small_block = alloc->allocate(sizeof(char) * 3, alignof(char));
+    auto large_block = alloc->allocate(allocator_slab::max_size_class + 1);
+
+    memset(large_block, 0xFF, allocator_slab::max_size_class + 1);
+
+    auto actual_blocks_state = dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info();
+
+    ASSERT_EQ(actual_blocks_state[0], (allocator_test_utils::block_info{ .block_size = 8, .is_block_occupied = true }));
+    ASSERT_EQ(actual_blocks_state.back(), (allocator_test_utils::block_info{ .block_size = allocator_slab::slab_size, .is_block_occupied = false }));
+
+    alloc->deallocate(large_block, 1);
+    alloc->deallocate(small_block, 1, alignof(char));
+}
+
+TEST(allocatorSlabPositiveTests, test3)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "heap is sized for the exact requests, guards overhead does not fit";
+    }
+
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_slab(allocator_slab::slab_size * 16));
+
+    {
+        std::list<int, pp_allocator<int>> list(pp_allocator<int>(alloc.get()));
+        std::map<int, double, std::less<int>, pp_allocator<std::pair<const int, double>>> map(pp_allocator<std::pair<const int, double>>(alloc.get()));
+
+        for (int i = 0; i < 500; ++i)
+        {
+            list.push_back(i);
+            map.emplace(i, i / 2.0);
+        }
+
+        for (int i = 0; i < 500; i += 2)
+        {
+            map.erase(i);
+        }
+
+        ASSERT_EQ(list.size(), 500);
+        ASSERT_EQ(map.size(), 250);
+        ASSERT_EQ(map.begin()->second, 0.5);
+    }
+
+    for (auto const &block : dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info())
+    {
+        ASSERT_FALSE(block.is_block_occupied);
+    }
+}
+
+TEST(allocatorSlabPositiveTests, test4)
+{
+    std::unique_ptr<smart_mem_resource> allocator(new allocator_slab(allocator_slab::slab_size * 8));
+
+    int iterations_count = 10000;
+
+    std::list<std::pair<void *, size_t>> allocated_blocks;
+    srand((unsigned)time(nullptr));
+
+    for (auto i = 0; i < iterations_count; i++)
+    {
+        switch (rand() % 2)
+        {
+            case 0:
+                try
+                {
+                    size_t size = rand() % 600 + 1;
+                    auto block = reinterpret_cast<unsigned char *>(allocator->allocate(size));
+                    memset(block, static_cast<int>(size % 256), size);
+                    allocated_blocks.emplace_front(block, size);
+                }
+                catch (std::bad_alloc const &)
+                {
+                }
+                break;
+            case 1:
+                if (allocated_blocks.empty())
+                {
+                    break;
+                }
+
+                auto it = allocated_blocks.begin();
+                std::advance(it, rand() % allocated_blocks.size());
+
+                auto block = reinterpret_cast<unsigned char *>(it->first);
+                for (size_t j = 0; j < it->second; ++j)
+                {
+                    ASSERT_EQ(block[j], static_cast<unsigned char>(it->second % 256));
+                }
+
+                allocator->deallocate(it->first, 1);
+                allocated_blocks.erase(it);
+                break;
+        }
+    }
+
+    while (!allocated_blocks.empty())
+    {
+        allocator->deallocate(allocated_blocks.front().first, 1);
+        allocated_blocks.pop_front();
+    }
+
+    for (auto const &block : dynamic_cast<allocator_test_utils *>(allocator.get())->get_blocks_info())
+    {
+        ASSERT_FALSE(block.is_block_occupied);
+        ASSERT_EQ(block.block_size, allocator_slab::slab_size);
+    }
+}
+
+TEST(allocatorSlabPositiveTests, test5)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_slab(allocator_slab::slab_size * 16));
+
+    ASSERT_EQ(allocator_test_utils::check_alignments(*alloc), "");
+}
+
+TEST(allocatorSlabNegativeTests, test1)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_slab(allocator_slab::slab_size));
+
+    std::set<void *> blocks;
+
+    ASSERT_THROW(
+        while (true)
+        {
+            blocks.insert(alloc->allocate(sizeof(char) * 200));
+        }, std::bad_alloc);
+
+    ASSERT_THROW(static_cast<void>(alloc->allocate(sizeof(char) * 10)), std::bad_alloc);
+
+    for (auto block : blocks)
+    {
+        alloc->deallocate(block, 1);
+    }
+
+    ASSERT_NO_THROW(alloc->deallocate(alloc->allocate(sizeof(char) * 10), 1));
+}
+
+TEST(allocatorSlabNegativeTests, test2)
+{
+    ASSERT_THROW(allocator_slab(allocator_slab::slab_size - 1), std::logic_error);
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -3,7 +3,9 @@
 
 #include <pp_allocator.h>
 #include <allocator_test_utils.h>
+#include <allocator_with_statistics.h>
 #include <allocator_with_fit_mode.h>
+#include <allocator_with_compaction.h>
 #include <logger_guardant.h>
 #include <typename_holder.h>
 #include <iterator>
@@ -13,6 +15,8 @@ class allocator_sorted_list final:
     public smart_mem_resource,
     public allocator_test_utils,
     public allocator_with_fit_mode,
+    public allocator_with_statistics,
+    public allocator_with_compaction,
     private logger_guardant,
     private typename_holder
 {
@@ -21,10 +25,22 @@ private:
     
     void *_trusted_memory;
 
-    static constexpr const size_t allocator_metadata_size = sizeof(logger*) + sizeof(std::pmr::memory_resource *) + sizeof(fit_mode) + sizeof(size_t) + sizeof(std::mutex) + sizeof(void*);
+    /**
+     * Besides address sorted free list, trusted memory holds root of size index:
+     * treap over free blocks keyed by (size, address), which makes best and worst fit O(log n).
+     * Rounded up to alignof(std::max_align_t), so first block of space starts aligned
+     */
+    static constexpr const size_t allocator_metadata_size = (sizeof(logger*) + sizeof(std::pmr::memory_resource *) + sizeof(size_t) + sizeof(std::mutex) + sizeof(void*) +
+                                                             sizeof(void*) + sizeof(fit_mode) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
 
     static constexpr const size_t block_metadata_size = sizeof(void*) + sizeof(size_t);
 
+    /**
+     * Free block keeps previous free block and treap children in its payload,
+     * so payload of any block is never smaller than this
+     */
+    static constexpr const size_t free_block_payload_size = 3 * sizeof(void*);
+
 public:
 
     explicit allocator_sorted_list(
@@ -32,12 +48,16 @@ public:
             std::pmr::memory_resource *parent_allocator = nullptr,
             logger *logger = nullptr,
             allocator_with_fit_mode::fit_mode allocate_fit_mode = allocator_with_fit_mode::fit_mode::first_fit);
-    
+
+    /**
+     * Not copyable: free list, size index and occupied blocks link by absolute pointers into trusted memory,
+     * and blocks handed out belong to their owners, so a copy could neither reuse nor free them. Move instead
+     */
     allocator_sorted_list(
-        allocator_sorted_list const &other);
+        allocator_sorted_list const &other) = delete;
     
     allocator_sorted_list &operator=(
-        allocator_sorted_list const &other);
+        allocator_sorted_list const &other) = delete;
 
     allocator_sorted_list(
         allocator_sorted_list &&other) noexcept;
@@ -60,6 +80,12 @@ public:
 
     std::vector<allocator_test_utils::block_info> get_blocks_info() const noexcept override;
 
+    /**
+     * Free list and size index are rebuilt from the free blocks left between unmovable blocks
+     */
+    size_t compact(
+        relocation_listener &listener) override;
+
 private:
 
     std::vector<allocator_test_utils::block_info> get_blocks_info_inner() const override;
@@ -68,6 +94,66 @@ private:
     
     inline std::string get_typename() const override;
 
+    void destroy() noexcept;
+
+    static logger *&logger_ref(void *trusted) noexcept;
+
+    static std::pmr::memory_resource *&parent_ref(void *trusted) noexcept;
+
+    static size_t &space_size_ref(void *trusted) noexcept;
+
+    static std::mutex &mutex_ref(void *trusted) noexcept;
+
+    static void *&first_free_ref(void *trusted) noexcept;
+
+    static void *&size_index_root_ref(void *trusted) noexcept;
+
+    static fit_mode &fit_mode_ref(void *trusted) noexcept;
+
+    static void *blocks_begin(void *trusted) noexcept;
+
+    static void *blocks_end(void *trusted) noexcept;
+
+    static void *&block_next_ref(void *block) noexcept;
+
+    static size_t &block_size_ref(void *block) noexcept;
+
+    static void *&block_prev_free_ref(void *block) noexcept;
+
+    static void *&block_left_ref(void *block) noexcept;
+
+    static void *&block_right_ref(void *block) noexcept;
+
+    static void *next_block(void *block) noexcept;
+
+    static bool size_index_less(void *left, void *right) noexcept;
+
+    static size_t size_index_priority(void *block) noexcept;
+
+    void size_index_insert(void *block) noexcept;
+
+    void size_index_erase(void *block) noexcept;
+
+    void *size_index_lower_bound(size_t size) const noexcept;
+
+    void *size_index_max() const noexcept;
+
+    /**
+     * Called under the lock after every change of free blocks
+     */
+    void publish_free_space() noexcept;
+
+    void *find_first_fit(size_t size) const noexcept;
+
+    void free_list_replace(void *block, void *replacement) noexcept;
+
+    void free_list_erase(void *block) noexcept;
+
+    /**
+     * Makes [at, at + size) a free block and links it after last_free, which is the last free block in address order
+     */
+    void *append_free(void *at, size_t size, void *last_free) noexcept;
+
     class sorted_free_iterator
     {
         void* _free_ptr;
@@ -1,21 +1,32 @@
-#include <not_implemented.h>
+#include <cstdint>
+#include <cstring>
 #include "../include/allocator_sorted_list.h"
 
 allocator_sorted_list::~allocator_sorted_list()
 {
-    throw not_implemented("allocator_sorted_list::~allocator_sorted_list()", "your code should be here...");
+    destroy();
 }
 
 allocator_sorted_list::allocator_sorted_list(
-    allocator_sorted_list &&other) noexcept
+    allocator_sorted_list &&other) noexcept:
+    allocator_with_statistics(std::move(other)),
+    _trusted_memory(other._trusted_memory)
 {
-    throw not_implemented("allocator_sorted_list::allocator_sorted_list(allocator_sorted_list &&) noexcept", "your code should be here...");
+    other._trusted_memory = nullptr;
 }
 
 allocator_sorted_list &allocator_sorted_list::operator=(
     allocator_sorted_list &&other) noexcept
 {
-    throw not_implemented("allocator_sorted_list &allocator_sorted_list::operator=(allocator_sorted_list &&) noexcept", "your code should be here...");
+    if (this != &other)
+    {
+        destroy();
+        allocator_with_statistics::operator=(std::move(other));
+        _trusted_memory = other._trusted_memory;
+        other._trusted_memory = nullptr;
+    }
+
+    return *this;
 }
 
 allocator_sorted_list::allocator_sorted_list(
@@ -24,167 +35,702 @@ allocator_sorted_list::allocator_sorted_list(
         logger *logger,
         allocator_with_fit_mode::fit_mode allocate_fit_mode)
 {
-    throw not_implemented("allocator_sorted_list::allocator_sorted_list(size_t, std::pmr::memory_resource *,logger *,allocator_with_fit_mode::fit_mode)", "your code should be here...");
-}
+    if (space_size < block_metadata_size + free_block_payload_size)
+    {
+        throw std::logic_error("allocator_sorted_list: space size is too small to hold a single block");
+    }
 
-[[nodiscard]] void *allocator_sorted_list::do_allocate_sm(
-    size_t size)
-{
-    throw not_implemented("[[nodiscard]] void *allocator_sorted_list::do_allocate_sm(size_t)", "your code should be here...");
+    if (parent_allocator == nullptr)
+    {
+        parent_allocator = std::pmr::get_default_resource();
+    }
+
+    _trusted_memory = parent_allocator->allocate(allocator_metadata_size + space_size, alignof(std::max_align_t));
+
+    logger_ref(_trusted_memory) = logger;
+    parent_ref(_trusted_memory) = parent_allocator;
+    space_size_ref(_trusted_memory) = space_size;
+    new (&mutex_ref(_trusted_memory)) std::mutex();
+    fit_mode_ref(_trusted_memory) = allocate_fit_mode;
+
+    void *block = blocks_begin(_trusted_memory);
+    block_next_ref(block) = nullptr;
+    block_size_ref(block) = space_size - block_metadata_size;
+    block_prev_free_ref(block) = nullptr;
+
+    first_free_ref(_trusted_memory) = block;
+    size_index_root_ref(_trusted_memory) = nullptr;
+    size_index_insert(block);
+    publish_free_space();
+
+    debug_with_guard(get_typename() + ": created with " + std::to_string(space_size) + " bytes of space");
 }
 
-allocator_sorted_list::allocator_sorted_list(const allocator_sorted_list &other)
+void allocator_sorted_list::destroy() noexcept
 {
-    throw not_implemented("allocator_sorted_list::allocator_sorted_list(const allocator_sorted_list &other)", "your code should be here...");
+    if (_trusted_memory == nullptr)
+    {
+        return;
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+
+    auto *parent = parent_ref(_trusted_memory);
+    size_t trusted_size = allocator_metadata_size + space_size_ref(_trusted_memory);
+
+    mutex_ref(_trusted_memory).~mutex();
+    parent->deallocate(_trusted_memory, trusted_size, alignof(std::max_align_t));
+    _trusted_memory = nullptr;
 }
 
-allocator_sorted_list &allocator_sorted_list::operator=(const allocator_sorted_list &other)
+[[nodiscard]] void *allocator_sorted_list::do_allocate_sm(
+    size_t size)
 {
-    throw not_implemented("allocator_sorted_list &allocator_sorted_list::operator=(const allocator_sorted_list &other)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    if (size > space_size_ref(_trusted_memory))
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        record_failed_allocation(size);
+        throw std::bad_alloc();
+    }
+
+    size_t requested_size = size;
+
+    // rounding keeps every block start (and so every payload) aligned by alignof(std::max_align_t)
+    size = (std::max(size, free_block_payload_size) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    void *block = nullptr;
+
+    switch (fit_mode_ref(_trusted_memory))
+    {
+        case fit_mode::first_fit:
+            block = find_first_fit(size);
+            break;
+        case fit_mode::the_best_fit:
+            block = size_index_lower_bound(size);
+            break;
+        case fit_mode::the_worst_fit:
+            block = size_index_max();
+            block = block != nullptr && block_size_ref(block) >= size ? block : nullptr;
+            break;
+    }
+
+    if (block == nullptr)
+    {
+        error_with_guard(get_typename() + ": can't allocate " + std::to_string(size) + " bytes");
+        record_failed_allocation(requested_size);
+        throw std::bad_alloc();
+    }
+
+    size_index_erase(block);
+
+    if (block_size_ref(block) >= size + block_metadata_size + free_block_payload_size)
+    {
+        auto *remainder = reinterpret_cast<unsigned char *>(block) + block_metadata_size + size;
+
+        block_size_ref(remainder) = block_size_ref(block) - size - block_metadata_size;
+        block_size_ref(block) = size;
+
+        free_list_replace(block, remainder);
+        size_index_insert(remainder);
+    }
+    else
+    {
+        free_list_erase(block);
+    }
+
+    block_next_ref(block) = _trusted_memory;
+    record_allocation(requested_size, block_metadata_size + block_size_ref(block));
+    publish_free_space();
+
+    return reinterpret_cast<unsigned char *>(block) + block_metadata_size;
 }
 
 bool allocator_sorted_list::do_is_equal(const std::pmr::memory_resource &other) const noexcept
 {
-    throw not_implemented("bool allocator_sorted_list::do_is_equal(const std::pmr::memory_resource &other) const noexcept", "your code should be here...");
+    auto *other_list = dynamic_cast<const allocator_sorted_list *>(&other);
+
+    return other_list != nullptr && other_list->_trusted_memory == _trusted_memory;
 }
 
 void allocator_sorted_list::do_deallocate_sm(
     void *at)
 {
-    throw not_implemented("void allocator_sorted_list::do_deallocate_sm(void *)", "your code should be here...");
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    auto *block = reinterpret_cast<unsigned char *>(at) - block_metadata_size;
+
+    if (block < blocks_begin(_trusted_memory) || block >= blocks_end(_trusted_memory) || block_next_ref(block) != _trusted_memory)
+    {
+        error_with_guard(get_typename() + ": pointer does not belong to allocated block");
+        throw std::logic_error("allocator_sorted_list: pointer does not belong to allocated block");
+    }
+
+    record_deallocation(block_metadata_size + block_size_ref(block));
+
+    void *prev = nullptr;
+    void *next = first_free_ref(_trusted_memory);
+
+    while (next != nullptr && next < block)
+    {
+        prev = next;
+        next = block_next_ref(next);
+    }
+
+    block_prev_free_ref(block) = prev;
+    block_next_ref(block) = next;
+
+    if (next != nullptr && next_block(block) == next)
+    {
+        size_index_erase(next);
+        block_size_ref(block) += block_metadata_size + block_size_ref(next);
+        block_next_ref(block) = block_next_ref(next);
+    }
+
+    if (block_next_ref(block) != nullptr)
+    {
+        block_prev_free_ref(block_next_ref(block)) = block;
+    }
+
+    if (prev != nullptr && next_block(prev) == block)
+    {
+        size_index_erase(prev);
+        block_size_ref(prev) += block_metadata_size + block_size_ref(block);
+        block_next_ref(prev) = block_next_ref(block);
+
+        if (block_next_ref(prev) != nullptr)
+        {
+            block_prev_free_ref(block_next_ref(prev)) = prev;
+        }
+
+        size_index_insert(prev);
+        publish_free_space();
+        return;
+    }
+
+    if (prev != nullptr)
+    {
+        block_next_ref(prev) = block;
+    }
+    else
+    {
+        first_free_ref(_trusted_memory) = block;
+    }
+
+    size_index_insert(block);
+    publish_free_space();
 }
 
 inline void allocator_sorted_list::set_fit_mode(
     allocator_with_fit_mode::fit_mode mode)
 {
-    throw not_implemented("inline void allocator_sorted_list::set_fit_mode(allocator_with_fit_mode::fit_mode)", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    fit_mode_ref(_trusted_memory) = mode;
 }
 
 std::vector<allocator_test_utils::block_info> allocator_sorted_list::get_blocks_info() const noexcept
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_sorted_list::get_blocks_info() const noexcept", "your code should be here...");
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    return get_blocks_info_inner();
+}
+
+size_t allocator_sorted_list::compact(
+    relocation_listener &listener)
+{
+    std::lock_guard lock(mutex_ref(_trusted_memory));
+
+    auto *end = reinterpret_cast<unsigned char *>(blocks_end(_trusted_memory));
+    auto *block = reinterpret_cast<unsigned char *>(blocks_begin(_trusted_memory));
+    auto *cursor = block;
+    void *last_free = nullptr;
+    size_t moved_count = 0;
+
+    first_free_ref(_trusted_memory) = nullptr;
+    size_index_root_ref(_trusted_memory) = nullptr;
+
+    // free space between two unmovable blocks is a sum of whole free blocks, so it is big enough to be a free block again
+    while (block != end)
+    {
+        auto *next = reinterpret_cast<unsigned char *>(next_block(block));
+        size_t size = next - block;
+
+        if (block_next_ref(block) != _trusted_memory)
+        {
+            block = next;
+            continue;
+        }
+
+        if (listener.is_movable(block + block_metadata_size))
+        {
+            if (cursor != block)
+            {
+                std::memmove(cursor, block, size);
+                listener.on_moved(block + block_metadata_size, cursor + block_metadata_size);
+                ++moved_count;
+            }
+
+            cursor += size;
+        }
+        else
+        {
+            if (cursor != block)
+            {
+                last_free = append_free(cursor, block - cursor, last_free);
+            }
+
+            cursor = next;
+        }
+
+        block = next;
+    }
+
+    if (cursor != end)
+    {
+        append_free(cursor, end - cursor, last_free);
+    }
+
+    publish_free_space();
+    debug_with_guard(get_typename() + ": compacted, " + std::to_string(moved_count) + " blocks moved");
+
+    return moved_count;
 }
 
 inline logger *allocator_sorted_list::get_logger() const
 {
-    throw not_implemented("inline logger *allocator_sorted_list::get_logger() const", "your code should be here...");
+    return _trusted_memory == nullptr ? nullptr : logger_ref(_trusted_memory);
 }
 
 inline std::string allocator_sorted_list::get_typename() const
 {
-    throw not_implemented("inline std::string allocator_sorted_list::get_typename() const", "your code should be here...");
+    return "allocator_sorted_list";
 }
 
 
 std::vector<allocator_test_utils::block_info> allocator_sorted_list::get_blocks_info_inner() const
 {
-    throw not_implemented("std::vector<allocator_test_utils::block_info> allocator_sorted_list::get_blocks_info_inner() const", "your code should be here...");
+    std::vector<allocator_test_utils::block_info> result;
+
+    for (auto it = begin(), last = end(); it != last; ++it)
+    {
+        result.push_back({ .block_size = it.size() + block_metadata_size, .is_block_occupied = it.occupied() });
+    }
+
+    return result;
+}
+
+logger *&allocator_sorted_list::logger_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<logger **>(trusted);
+}
+
+std::pmr::memory_resource *&allocator_sorted_list::parent_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<std::pmr::memory_resource **>(reinterpret_cast<unsigned char *>(trusted) + sizeof(logger *));
+}
+
+size_t &allocator_sorted_list::space_size_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(&parent_ref(trusted)) + sizeof(std::pmr::memory_resource *));
+}
+
+std::mutex &allocator_sorted_list::mutex_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<std::mutex *>(reinterpret_cast<unsigned char *>(&space_size_ref(trusted)) + sizeof(size_t));
+}
+
+void *&allocator_sorted_list::first_free_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(&mutex_ref(trusted)) + sizeof(std::mutex));
+}
+
+void *&allocator_sorted_list::size_index_root_ref(void *trusted) noexcept
+{
+    return *(&first_free_ref(trusted) + 1);
+}
+
+allocator_with_fit_mode::fit_mode &allocator_sorted_list::fit_mode_ref(void *trusted) noexcept
+{
+    return *reinterpret_cast<fit_mode *>(&size_index_root_ref(trusted) + 1);
+}
+
+void *allocator_sorted_list::blocks_begin(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(trusted) + allocator_metadata_size;
+}
+
+void *allocator_sorted_list::blocks_end(void *trusted) noexcept
+{
+    return reinterpret_cast<unsigned char *>(blocks_begin(trusted)) + space_size_ref(trusted);
+}
+
+void *&allocator_sorted_list::block_next_ref(void *block) noexcept
+{
+    return *reinterpret_cast<void **>(block);
+}
+
+size_t &allocator_sorted_list::block_size_ref(void *block) noexcept
+{
+    return *reinterpret_cast<size_t *>(reinterpret_cast<unsigned char *>(block) + sizeof(void *));
+}
+
+void *&allocator_sorted_list::block_prev_free_ref(void *block) noexcept
+{
+    return *reinterpret_cast<void **>(reinterpret_cast<unsigned char *>(block) + block_metadata_size);
+}
+
+void *&allocator_sorted_list::block_left_ref(void *block) noexcept
+{
+    return *(&block_prev_free_ref(block) + 1);
+}
+
+void *&allocator_sorted_list::block_right_ref(void *block) noexcept
+{
+    return *(&block_prev_free_ref(block) + 2);
+}
+
+void *allocator_sorted_list::next_block(void *block) noexcept
+{
+    return reinterpret_cast<unsigned char *>(block) + block_metadata_size + block_size_ref(block);
+}
+
+bool allocator_sorted_list::size_index_less(void *left, void *right) noexcept
+{
+    size_t left_size = block_size_ref(left);
+    size_t right_size = block_size_ref(right);
+
+    return left_size < right_size || (left_size == right_size && left < right);
+}
+
+size_t allocator_sorted_list::size_index_priority(void *block) noexcept
+{
+    // treap priorities are derived from block address, so nodes don't need to store them
+    auto x = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(block));
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+
+    return static_cast<size_t>(x ^ (x >> 31));
+}
+
+void allocator_sorted_list::size_index_insert(void *block) noexcept
+{
+    size_t priority = size_index_priority(block);
+    void **link = &size_index_root_ref(_trusted_memory);
+
+    while (*link != nullptr && size_index_priority(*link) >= priority)
+    {
+        link = size_index_less(block, *link) ? &block_left_ref(*link) : &block_right_ref(*link);
+    }
+
+    // split subtree under link into keys less and greater than block
+    void *node = *link;
+    void **less = &block_left_ref(block);
+    void **greater = &block_right_ref(block);
+
+    while (node != nullptr)
+    {
+        if (size_index_less(node, block))
+        {
+            *less = node;
+            less = &block_right_ref(node);
+            node = block_right_ref(node);
+        }
+        else
+        {
+            *greater = node;
+            greater = &block_left_ref(node);
+            node = block_left_ref(node);
+        }
+    }
+
+    *less = nullptr;
+    *greater = nullptr;
+    *link = block;
+}
+
+void allocator_sorted_list::size_index_erase(void *block) noexcept
+{
+    void **link = &size_index_root_ref(_trusted_memory);
+
+    while (*link != block)
+    {
+        link = size_index_less(block, *link) ? &block_left_ref(*link) : &block_right_ref(*link);
+    }
+
+    // merge children of erased node in place of it
+    void *left = block_left_ref(block);
+    void *right = block_right_ref(block);
+
+    while (left != nullptr && right != nullptr)
+    {
+        if (size_index_priority(left) >= size_index_priority(right))
+        {
+            *link = left;
+            link = &block_right_ref(left);
+            left = block_right_ref(left);
+        }
+        else
+        {
+            *link = right;
+            link = &block_left_ref(right);
+            right = block_left_ref(right);
+        }
+    }
+
+    *link = left != nullptr ? left : right;
+}
+
+void *allocator_sorted_list::size_index_lower_bound(size_t size) const noexcept
+{
+    void *result = nullptr;
+    void *node = size_index_root_ref(_trusted_memory);
+
+    while (node != nullptr)
+    {
+        if (block_size_ref(node) >= size)
+        {
+            result = node;
+            node = block_left_ref(node);
+        }
+        else
+        {
+            node = block_right_ref(node);
+        }
+    }
+
+    return result;
+}
+
+void *allocator_sorted_list::size_index_max() const noexcept
+{
+    void *node = size_index_root_ref(_trusted_memory);
+
+    while (node != nullptr && block_right_ref(node) != nullptr)
+    {
+        node = block_right_ref(node);
+    }
+
+    return node;
+}
+
+void allocator_sorted_list::publish_free_space() noexcept
+{
+    void *largest = size_index_max();
+
+    record_free_space(space_size_ref(_trusted_memory) - bytes_in_use(), largest == nullptr ? 0 : block_metadata_size + block_size_ref(largest));
+}
+
+void *allocator_sorted_list::find_first_fit(size_t size) const noexcept
+{
+    for (auto it = free_begin(), last = free_end(); it != last; ++it)
+    {
+        if (it.size() >= size)
+        {
+            return *it;
+        }
+    }
+
+    return nullptr;
+}
+
+void allocator_sorted_list::free_list_replace(void *block, void *replacement) noexcept
+{
+    void *prev = block_prev_free_ref(block);
+    void *next = block_next_ref(block);
+
+    block_prev_free_ref(replacement) = prev;
+    block_next_ref(replacement) = next;
+
+    if (prev != nullptr)
+    {
+        block_next_ref(prev) = replacement;
+    }
+    else
+    {
+        first_free_ref(_trusted_memory) = replacement;
+    }
+
+    if (next != nullptr)
+    {
+        block_prev_free_ref(next) = replacement;
+    }
+}
+
+void allocator_sorted_list::free_list_erase(void *block) noexcept
+{
+    void *prev = block_prev_free_ref(block);
+    void *next = block_next_ref(block);
+
+    if (prev != nullptr)
+    {
+        block_next_ref(prev) = next;
+    }
+    else
+    {
+        first_free_ref(_trusted_memory) = next;
+    }
+
+    if (next != nullptr)
+    {
+        block_prev_free_ref(next) = prev;
+    }
+}
+
+void *allocator_sorted_list::append_free(void *at, size_t size, void *last_free) noexcept
+{
+    block_size_ref(at) = size - block_metadata_size;
+    block_next_ref(at) = nullptr;
+    block_prev_free_ref(at) = last_free;
+
+    if (last_free != nullptr)
+    {
+        block_next_ref(last_free) = at;
+    }
+    else
+    {
+        first_free_ref(_trusted_memory) = at;
+    }
+
+    size_index_insert(at);
+
+    return at;
 }
 
 allocator_sorted_list::sorted_free_iterator allocator_sorted_list::free_begin() const noexcept
 {
-    throw not_implemented("allocator_sorted_list::sorted_free_iterator allocator_sorted_list::free_begin() const noexcept", "your code should be here...");
+    return sorted_free_iterator(_trusted_memory);
 }
 
 allocator_sorted_list::sorted_free_iterator allocator_sorted_list::free_end() const noexcept
 {
-    throw not_implemented("allocator_sorted_list::sorted_free_iterator allocator_sorted_list::free_end() const noexcept", "your code should be here...");
+    return sorted_free_iterator();
 }
 
 allocator_sorted_list::sorted_iterator allocator_sorted_list::begin() const noexcept
 {
-    throw not_implemented("allocator_sorted_list::sorted_iterator allocator_sorted_list::begin() const noexcept", "your code should be here...");
+    return sorted_iterator(_trusted_memory);
 }
 
 allocator_sorted_list::sorted_iterator allocator_sorted_list::end() const noexcept
 {
-    throw not_implemented("allocator_sorted_list::sorted_iterator allocator_sorted_list::end() const noexcept", "your code should be here...");
+    return sorted_iterator();
 }
 
 
 bool allocator_sorted_list::sorted_free_iterator::operator==(
         const allocator_sorted_list::sorted_free_iterator & other) const noexcept
 {
-    throw not_implemented("bool allocator_sorted_list::sorted_free_iterator::operator==(const allocator_sorted_list::sorted_free_iterator &) const noexcept", "your code should be here...");
+    return _free_ptr == other._free_ptr;
 }
 
 bool allocator_sorted_list::sorted_free_iterator::operator!=(
         const allocator_sorted_list::sorted_free_iterator &other) const noexcept
 {
-    throw not_implemented("bool allocator_sorted_list::sorted_free_iterator::operator!=(const allocator_sorted_list::sorted_free_iterator &) const noexcept", "your code should be here...");
+    return !(*this == other);
 }
 
 allocator_sorted_list::sorted_free_iterator &allocator_sorted_list::sorted_free_iterator::operator++() & noexcept
 {
-    throw not_implemented("allocator_sorted_list::sorted_free_iterator &allocator_sorted_list::sorted_free_iterator::operator++() & noexcept", "your code should be here...");
+    _free_ptr = block_next_ref(_free_ptr);
+
+    return *this;
 }
 
 allocator_sorted_list::sorted_free_iterator allocator_sorted_list::sorted_free_iterator::operator++(int n)
 {
-    throw not_implemented("allocator_sorted_list::sorted_free_iterator allocator_sorted_list::sorted_free_iterator::operator++(int)", "your code should be here...");
+    auto copy = *this;
+    ++*this;
+
+    return copy;
 }
 
 size_t allocator_sorted_list::sorted_free_iterator::size() const noexcept
 {
-    throw not_implemented("size_t allocator_sorted_list::sorted_free_iterator::size() const noexcept", "your code should be here...");
+    return block_size_ref(_free_ptr);
 }
 
 void *allocator_sorted_list::sorted_free_iterator::operator*() const noexcept
 {
-    throw not_implemented("void *allocator_sorted_list::sorted_free_iterator::operator*() const noexcept", "your code should be here...");
+    return _free_ptr;
 }
 
-allocator_sorted_list::sorted_free_iterator::sorted_free_iterator()
+allocator_sorted_list::sorted_free_iterator::sorted_free_iterator():
+    _free_ptr(nullptr)
 {
-    throw not_implemented("allocator_sorted_list::sorted_free_iterator::sorted_free_iterator()", "your code should be here...");
 }
 
-allocator_sorted_list::sorted_free_iterator::sorted_free_iterator(void *trusted)
+allocator_sorted_list::sorted_free_iterator::sorted_free_iterator(void *trusted):
+    _free_ptr(first_free_ref(trusted))
 {
-    throw not_implemented("allocator_sorted_list::sorted_free_iterator::sorted_free_iterator(void *)", "your code should be here...");
 }
 
 bool allocator_sorted_list::sorted_iterator::operator==(const allocator_sorted_list::sorted_iterator & other) const noexcept
 {
-    throw not_implemented("bool allocator_sorted_list::sorted_iterator::operator==(const allocator_sorted_list::sorted_iterator &) const noexcept", "your code should be here...");
+    return _current_ptr == other._current_ptr;
 }
 
 bool allocator_sorted_list::sorted_iterator::operator!=(const allocator_sorted_list::sorted_iterator &other) const noexcept
 {
-    throw not_implemented("bool allocator_sorted_list::sorted_iterator::operator!=(const allocator_sorted_list::sorted_iterator &) const noexcept", "your code should be here...");
+    return !(*this == other);
 }
 
 allocator_sorted_list::sorted_iterator &allocator_sorted_list::sorted_iterator::operator++() & noexcept
 {
-    throw not_implemented("allocator_sorted_list::sorted_iterator &allocator_sorted_list::sorted_iterator::operator++() & noexcept", "your code should be here...");
+    if (_current_ptr == _free_ptr)
+    {
+        _free_ptr = block_next_ref(_free_ptr);
+    }
+
+    _current_ptr = next_block(_current_ptr);
+
+    if (_current_ptr == blocks_end(_trusted_memory))
+    {
+        _current_ptr = nullptr;
+    }
+
+    return *this;
 }
 
 allocator_sorted_list::sorted_iterator allocator_sorted_list::sorted_iterator::operator++(int n)
 {
-    throw not_implemented("allocator_sorted_list::sorted_iterator allocator_sorted_list::sorted_iterator::operator++(int)", "your code should be here...");
+    auto copy = *this;
+    ++*this;
+
+    return copy;
 }
 
 size_t allocator_sorted_list::sorted_iterator::size() const noexcept
 {
-    throw not_implemented("size_t allocator_sorted_list::sorted_iterator::size() const noexcept", "your code should be here...");
+    return block_size_ref(_current_ptr);
 }
 
 void *allocator_sorted_list::sorted_iterator::operator*() const noexcept
 {
-    throw not_implemented("void *allocator_sorted_list::sorted_iterator::operator*() const noexcept", "your code should be here...");
+    return _current_ptr;
 }
 
-allocator_sorted_list::sorted_iterator::sorted_iterator()
+allocator_sorted_list::sorted_iterator::sorted_iterator():
+    _free_ptr(nullptr),
+    _current_ptr(nullptr),
+    _trusted_memory(nullptr)
 {
-    throw not_implemented("allocator_sorted_list::sorted_iterator::sorted_iterator() ", "your code should be here...");
 }
 
-allocator_sorted_list::sorted_iterator::sorted_iterator(void *trusted)
+allocator_sorted_list::sorted_iterator::sorted_iterator(void *trusted):
+    _free_ptr(first_free_ref(trusted)),
+    _current_ptr(blocks_begin(trusted)),
+    _trusted_memory(trusted)
 {
-    throw not_implemented("allocator_sorted_list::sorted_iterator::sorted_iterator(void *)", "your code should be here...");
 }
 
 bool allocator_sorted_list::sorted_iterator::occupied() const noexcept
 {
-    throw not_implemented("bool allocator_sorted_list::sorted_iterator::occupied() const noexcept", "your code should be here...");
+    return _current_ptr != _free_ptr;
 }
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
+#include <allocator_guards.h>
 #include <logger.h>
 #include <logger_builder.h>
 #include <client_logger_builder.h>
+#include <bit>
 #include <list>
 
 #include "../include/allocator_sorted_list.h"
@@ -137,6 +139,11 @@ TEST(allocatorSortedListPositiveTests, test3)
 
 TEST(allocatorSortedListPositiveTests, test4)
 {
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "heap is sized for the exact requests, guards overhead does not fit";
+    }
+
     std::unique_ptr<logger> logger_instance(create_logger(std::vector<std::pair<std::string, logger::severity>>
                                                     {
                                                             {
@@ -242,6 +249,193 @@ TEST(allocatorSortedListPositiveTests, test5)
     }
 }
 
+TEST(allocatorSortedListPositiveTests, test6)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "heap is sized for the exact requests, guards overhead does not fit";
+    }
+
+    // space and block sizes are multiples of alignof(std::max_align_t), so payload rounding does not shift the layout
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_sorted_list(4992, nullptr, nullptr, allocator_with_fit_mode::fit_mode::first_fit));
+    auto *the_same_subject = dynamic_cast<allocator_with_fit_mode *>(alloc.get());
+
+    auto first_block = alloc->allocate(sizeof(char) * 112);
+    auto first_separator = alloc->allocate(sizeof(char) * 48);
+    auto second_block = alloc->allocate(sizeof(char) * 304);
+    auto second_separator = alloc->allocate(sizeof(char) * 48);
+    auto third_block = alloc->allocate(sizeof(char) * 208);
+    auto tail = alloc->allocate(4992 - 720 - 6 * (sizeof(void *) + sizeof(size_t)));
+
+    alloc->deallocate(first_block, 1);
+    alloc->deallocate(second_block, 1);
+    alloc->deallocate(third_block, 1);
+
+    the_same_subject->set_fit_mode(allocator_with_fit_mode::fit_mode::the_best_fit);
+    ASSERT_EQ(alloc->allocate(sizeof(char) * 150), third_block);
+
+    the_same_subject->set_fit_mode(allocator_with_fit_mode::fit_mode::the_worst_fit);
+    ASSERT_EQ(alloc->allocate(sizeof(char) * 10), second_block);
+
+    the_same_subject->set_fit_mode(allocator_with_fit_mode::fit_mode::first_fit);
+    ASSERT_EQ(alloc->allocate(sizeof(char) * 90), first_block);
+
+    the_same_subject->set_fit_mode(allocator_with_fit_mode::fit_mode::the_best_fit);
+    ASSERT_THROW(static_cast<void>(alloc->allocate(sizeof(char) * 400)), std::bad_alloc);
+
+    alloc->deallocate(first_block, 1);
+    alloc->deallocate(second_block, 1);
+    alloc->deallocate(third_block, 1);
+    alloc->deallocate(first_separator, 1);
+    alloc->deallocate(second_separator, 1);
+    alloc->deallocate(tail, 1);
+
+    auto actual_blocks_state = dynamic_cast<allocator_test_utils *>(alloc.get())->get_blocks_info();
+    std::vector<allocator_test_utils::block_info> expected_blocks_state
+        {
+            { .block_size = 4992, .is_block_occupied = false }
+        };
+
+    ASSERT_EQ(actual_blocks_state, expected_blocks_state);
+}
+
+TEST(allocatorSortedListPositiveTests, test7)
+{
+    std::unique_ptr<smart_mem_resource> allocator(new allocator_sorted_list(1 << 20, nullptr, nullptr, allocator_with_fit_mode::fit_mode::first_fit));
+    auto *the_same_subject = dynamic_cast<allocator_with_fit_mode *>(allocator.get());
+
+    std::vector<std::pair<void *, size_t>> allocated_blocks;
+    srand((unsigned)time(nullptr));
+
+    for (auto i = 0; i < 100000; i++)
+    {
+        the_same_subject->set_fit_mode(static_cast<allocator_with_fit_mode::fit_mode>(rand() % 3));
+
+        if (rand() % 3 != 0 || allocated_blocks.empty())
+        {
+            try
+            {
+                size_t size = rand() % 100 + 1;
+                auto block = reinterpret_cast<unsigned char *>(allocator->allocate(size));
+                memset(block, static_cast<int>(size), size);
+                allocated_blocks.emplace_back(block, size);
+            }
+            catch (std::bad_alloc const &)
+            {
+            }
+        }
+        else
+        {
+            std::swap(allocated_blocks[rand() % allocated_blocks.size()], allocated_blocks.back());
+            auto [block, size] = allocated_blocks.back();
+
+            for (size_t j = 0; j < size; ++j)
+            {
+                ASSERT_EQ(reinterpret_cast<unsigned char *>(block)[j], static_cast<unsigned char>(size));
+            }
+
+            allocator->deallocate(block, 1);
+            allocated_blocks.pop_back();
+        }
+    }
+
+    auto actual_blocks_state = dynamic_cast<allocator_test_utils *>(allocator.get())->get_blocks_info();
+    size_t total_size = 0;
+
+    for (size_t i = 0; i < actual_blocks_state.size(); ++i)
+    {
+        total_size += actual_blocks_state[i].block_size;
+        ASSERT_FALSE(i > 0 && !actual_blocks_state[i - 1].is_block_occupied && !actual_blocks_state[i].is_block_occupied);
+    }
+
+    ASSERT_EQ(total_size, 1 << 20);
+
+    for (auto [block, size] : allocated_blocks)
+    {
+        allocator->deallocate(block, 1);
+    }
+
+    ASSERT_EQ(dynamic_cast<allocator_test_utils *>(allocator.get())->get_blocks_info().size(), 1);
+}
+
+TEST(allocatorSortedListPositiveTests, test8)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_sorted_list(1 << 16));
+
+    ASSERT_EQ(allocator_test_utils::check_alignments(*alloc), "");
+}
+
+TEST(allocatorSortedListPositiveTests, test9)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "statistics count requests grown by allocator guards overhead";
+    }
+
+    std::unique_ptr<logger> logger_instance(create_logger(std::vector<std::pair<std::string, logger::severity>>
+        {
+            {
+                "allocator_sorted_list_tests_logs_positive_test_9.txt",
+                logger::severity::information
+            }
+        }, false));
+    std::unique_ptr<smart_mem_resource> alloc(new allocator_sorted_list(1 << 12, nullptr, logger_instance.get(), allocator_with_fit_mode::fit_mode::first_fit));
+    auto *subject = dynamic_cast<allocator_with_statistics *>(alloc.get());
+
+    ASSERT_NE(subject, nullptr);
+
+    auto initial = subject->get_statistics();
+
+    ASSERT_EQ(initial.allocations, 0);
+    ASSERT_EQ(initial.bytes_in_use, 0);
+    ASSERT_EQ(initial.free_bytes, initial.largest_free_block);
+    ASSERT_EQ(initial.fragmentation(), 0.0);
+
+    std::vector<void *> blocks;
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        blocks.push_back(alloc->allocate(100));
+    }
+
+    auto full = subject->get_statistics();
+
+    ASSERT_EQ(full.allocations, 8);
+    ASSERT_EQ(full.request_size_histogram[std::bit_width(size_t(100))], 8);
+    ASSERT_GE(full.bytes_in_use, 800);
+    ASSERT_EQ(full.peak_bytes_in_use, full.bytes_in_use);
+    ASSERT_EQ(full.bytes_in_use + full.free_bytes, initial.free_bytes);
+
+    for (size_t i = 0; i < blocks.size(); i += 2)
+    {
+        alloc->deallocate(blocks[i], 100);
+    }
+
+    ASSERT_THROW(static_cast<void>(alloc->allocate(1 << 12)), std::bad_alloc);
+
+    auto holes = subject->get_statistics();
+
+    ASSERT_EQ(holes.deallocations, 4);
+    ASSERT_EQ(holes.failed_allocations, 1);
+    ASSERT_EQ(holes.peak_bytes_in_use, full.peak_bytes_in_use);
+    ASSERT_LT(holes.bytes_in_use, full.bytes_in_use);
+    ASSERT_GT(holes.fragmentation(), 0.0);
+    ASSERT_LT(holes.fragmentation(), 1.0);
+
+    for (size_t i = 1; i < blocks.size(); i += 2)
+    {
+        alloc->deallocate(blocks[i], 100);
+    }
+
+    auto released = subject->get_statistics();
+
+    ASSERT_EQ(released.bytes_in_use, 0);
+    ASSERT_EQ(released.free_bytes, initial.free_bytes);
+    ASSERT_EQ(released.largest_free_block, initial.largest_free_block);
+
+    subject->log_statistics();
+}
+
 TEST(allocatorSortedListNegativeTests, test1)
 {
     std::unique_ptr<logger> logger(create_logger(std::vector<std::pair<std::string, logger::severity>>
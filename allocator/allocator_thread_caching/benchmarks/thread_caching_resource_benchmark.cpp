@@ -0,0 +1,123 @@
+#include <thread_caching_resource.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Stands for allocator_* classes: every call goes through single mutex.
+ */
+class locked_mem_resource final : public smart_mem_resource
+{
+    std::mutex _mutex;
+
+    void *do_allocate_sm(size_t size) override
+    {
+        std::lock_guard lock(_mutex);
+        return ::operator new(size);
+    }
+
+    void do_deallocate_sm(void *at) override
+    {
+        std::lock_guard lock(_mutex);
+        ::operator delete(at);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+double run(std::pmr::memory_resource &resource, size_t threads_count, size_t operations_per_thread)
+{
+    constexpr const size_t working_set = 256;
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t t = 0; t < threads_count; ++t)
+    {
+        threads.emplace_back([&resource, operations_per_thread, t]()
+        {
+            std::mt19937 generator(t);
+            std::uniform_int_distribution<size_t> size_distribution(8, 512);
+            std::vector<std::pair<void *, size_t>> blocks(working_set, {nullptr, 0});
+
+            for (size_t i = 0; i < operations_per_thread; ++i)
+            {
+                auto &[block, size] = blocks[generator() % working_set];
+
+                if (block != nullptr)
+                {
+                    resource.deallocate(block, size);
+                    block = nullptr;
+                }
+                else
+                {
+                    size = size_distribution(generator);
+                    block = resource.allocate(size);
+                }
+            }
+
+            for (auto &[block, size] : blocks)
+            {
+                if (block != nullptr)
+                {
+                    resource.deallocate(block, size);
+                }
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return static_cast<double>(threads_count * operations_per_thread) / elapsed.count();
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    size_t max_threads = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    size_t operations_per_thread = argc > 2 ? std::stoul(argv[2]) : 1'000'000;
+
+    std::cout << std::setw(8) << "threads"
+              << std::setw(20) << "locked ops/sec"
+              << std::setw(20) << "cached ops/sec"
+              << std::setw(10) << "speedup" << std::endl;
+
+    std::vector<size_t> threads_counts;
+
+    for (size_t threads_count = 1; threads_count < max_threads; threads_count *= 2)
+    {
+        threads_counts.push_back(threads_count);
+    }
+
+    threads_counts.push_back(max_threads);
+
+    for (auto threads_count : threads_counts)
+    {
+        locked_mem_resource upstream;
+        double locked = run(upstream, threads_count, operations_per_thread);
+
+        thread_caching_resource cached_resource(&upstream);
+        double cached = run(cached_resource, threads_count, operations_per_thread);
+
+        std::cout << std::setw(8) << threads_count
+                  << std::setw(20) << std::fixed << std::setprecision(0) << locked
+                  << std::setw(20) << cached
+                  << std::setw(10) << std::setprecision(2) << cached / locked << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_THREAD_CACHING_RESOURCE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_THREAD_CACHING_RESOURCE_H
+
+#include <pp_allocator.h>
+#include <logger_guardant.h>
+#include <typename_holder.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Front-end over any upstream resource (usually one of allocator_* classes).
+ * Each thread keeps magazines of ready blocks per size class, so the common
+ * allocate/deallocate path never touches the upstream resource and its mutex.
+ * Magazines are refilled from and flushed to upstream in batches.
+ * Requests larger than the biggest size class are forwarded to upstream directly.
+ * Destruction and move assignment return caches of all threads to upstream, so no other thread
+ * may use the resource by then. Moved-from resource throws std::logic_error on allocation and deallocation.
+ */
+class thread_caching_resource final:
+    public smart_mem_resource,
+    private logger_guardant,
+    private typename_holder
+{
+
+public:
+
+    static constexpr const size_t min_size_class_power = 4;
+
+    static constexpr const size_t size_classes_count = 8;
+
+    static constexpr const size_t max_size_class = size_t(1) << (min_size_class_power + size_classes_count - 1);
+
+    static constexpr const size_t magazine_capacity = 64;
+
+    static constexpr const size_t batch_size = magazine_capacity / 2;
+
+private:
+
+    /**
+     * Holds requested (for large blocks) or size class (for cached blocks) size.
+     * Padded so user pointer keeps alignment given by upstream.
+     */
+    static constexpr const size_t block_metadata_size = alignof(std::max_align_t);
+
+    struct magazine
+    {
+        size_t count = 0;
+        std::array<void*, magazine_capacity> blocks;
+    };
+
+    struct thread_cache;
+
+    struct shared_state
+    {
+        std::pmr::memory_resource *upstream;
+        logger *log;
+        std::mutex mutex;
+        std::vector<thread_cache*> caches;
+        std::atomic<bool> alive;
+    };
+
+    struct thread_cache
+    {
+        std::shared_ptr<shared_state> state;
+        std::array<magazine, size_classes_count> magazines;
+    };
+
+    class thread_cache_registry final
+    {
+        std::vector<thread_cache*> _caches;
+        thread_cache* _last = nullptr;
+
+    public:
+
+        thread_cache_registry() = default;
+
+        thread_cache_registry(thread_cache_registry const &) = delete;
+
+        thread_cache_registry &operator=(thread_cache_registry const &) = delete;
+
+        ~thread_cache_registry();
+
+        thread_cache &get(std::shared_ptr<shared_state> const &state);
+    };
+
+    std::shared_ptr<shared_state> _state;
+
+public:
+
+    explicit thread_caching_resource(
+        std::pmr::memory_resource *upstream = nullptr,
+        logger *logger = nullptr);
+
+    thread_caching_resource(
+        thread_caching_resource const &other) = delete;
+
+    thread_caching_resource &operator=(
+        thread_caching_resource const &other) = delete;
+
+    thread_caching_resource(
+        thread_caching_resource &&other) noexcept;
+
+    thread_caching_resource &operator=(
+        thread_caching_resource &&other) noexcept;
+
+    ~thread_caching_resource() override;
+
+public:
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size) override;
+
+    void do_deallocate_sm(
+        void *at) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+
+    /**
+     * Returns all blocks cached by calling thread to upstream.
+     */
+    void flush_thread_cache();
+
+private:
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    static size_t size_class_index(size_t size) noexcept;
+
+    static size_t size_class_size(size_t index) noexcept;
+
+    static thread_cache &local_cache(std::shared_ptr<shared_state> const &state);
+
+    static void refill(shared_state &state, magazine &mag, size_t index);
+
+    static void flush(shared_state &state, magazine &mag, size_t index, size_t count);
+
+    static void drain(thread_cache &cache);
+
+    /**
+     * Throws std::logic_error for moved-from resource
+     */
+    shared_state &checked_state() const;
+
+    /**
+     * Drains caches of every thread, caller guarantees that none of them uses the resource any more
+     */
+    void destroy() noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_THREAD_CACHING_RESOURCE_H
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <bit>
+#include "../include/thread_caching_resource.h"
+
+thread_caching_resource::thread_caching_resource(
+    std::pmr::memory_resource *upstream,
+    logger *logger):
+    _state(std::make_shared<shared_state>())
+{
+    _state->upstream = upstream == nullptr ? std::pmr::get_default_resource() : upstream;
+    _state->log = logger;
+    _state->alive.store(true, std::memory_order_release);
+
+    debug_with_guard(get_typename() + ": created");
+}
+
+thread_caching_resource::thread_caching_resource(
+    thread_caching_resource &&other) noexcept:
+    _state(std::move(other._state))
+{
+}
+
+thread_caching_resource &thread_caching_resource::operator=(
+    thread_caching_resource &&other) noexcept
+{
+    if (this != &other)
+    {
+        destroy();
+        _state = std::move(other._state);
+    }
+
+    return *this;
+}
+
+thread_caching_resource::~thread_caching_resource()
+{
+    destroy();
+}
+
+void thread_caching_resource::destroy() noexcept
+{
+    if (_state == nullptr)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard lock(_state->mutex);
+
+        for (auto cache : _state->caches)
+        {
+            drain(*cache);
+        }
+
+        _state->caches.clear();
+        _state->alive.store(false, std::memory_order_release);
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+
+    _state.reset();
+}
+
+[[nodiscard]] void *thread_caching_resource::do_allocate_sm(
+    size_t size)
+{
+    auto &state = checked_state();
+    size_t index = size_class_index(size);
+
+    if (index == size_classes_count)
+    {
+        auto *block = reinterpret_cast<unsigned char *>(
+            state.upstream->allocate(size + block_metadata_size, alignof(std::max_align_t)));
+        *reinterpret_cast<size_t *>(block) = size;
+
+        return block + block_metadata_size;
+    }
+
+    auto &mag = local_cache(_state).magazines[index];
+
+    if (mag.count == 0)
+    {
+        refill(state, mag, index);
+    }
+
+    return reinterpret_cast<unsigned char *>(mag.blocks[--mag.count]) + block_metadata_size;
+}
+
+void thread_caching_resource::do_deallocate_sm(
+    void *at)
+{
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    auto &state = checked_state();
+    auto *block = reinterpret_cast<unsigned char *>(at) - block_metadata_size;
+    size_t size = *reinterpret_cast<size_t *>(block);
+    size_t index = size_class_index(size);
+
+    if (index == size_classes_count)
+    {
+        state.upstream->deallocate(block, size + block_metadata_size, alignof(std::max_align_t));
+        return;
+    }
+
+    auto &mag = local_cache(_state).magazines[index];
+
+    if (mag.count == magazine_capacity)
+    {
+        flush(state, mag, index, batch_size);
+    }
+
+    mag.blocks[mag.count++] = block;
+}
+
+bool thread_caching_resource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+void thread_caching_resource::flush_thread_cache()
+{
+    auto &state = checked_state();
+    auto &cache = local_cache(_state);
+
+    std::lock_guard lock(state.mutex);
+    drain(cache);
+}
+
+inline logger *thread_caching_resource::get_logger() const
+{
+    return _state == nullptr ? nullptr : _state->log;
+}
+
+inline std::string thread_caching_resource::get_typename() const
+{
+    return "thread_caching_resource";
+}
+
+thread_caching_resource::shared_state &thread_caching_resource::checked_state() const
+{
+    if (_state == nullptr)
+    {
+        throw std::logic_error("thread_caching_resource: resource was moved from");
+    }
+
+    return *_state;
+}
+
+size_t thread_caching_resource::size_class_index(size_t size) noexcept
+{
+    if (size > max_size_class)
+    {
+        return size_classes_count;
+    }
+
+    size_t power = std::bit_width(std::max(size, size_t(1) << min_size_class_power) - 1);
+
+    return power - min_size_class_power;
+}
+
+size_t thread_caching_resource::size_class_size(size_t index) noexcept
+{
+    return size_t(1) << (index + min_size_class_power);
+}
+
+thread_caching_resource::thread_cache &thread_caching_resource::local_cache(
+    std::shared_ptr<shared_state> const &state)
+{
+    static thread_local thread_cache_registry registry;
+
+    return registry.get(state);
+}
+
+void thread_caching_resource::refill(
+    shared_state &state,
+    magazine &mag,
+    size_t index)
+{
+    size_t size = size_class_size(index);
+
+    for (size_t i = 0; i < batch_size; ++i)
+    {
+        void *block;
+
+        try
+        {
+            block = state.upstream->allocate(size + block_metadata_size, alignof(std::max_align_t));
+        }
+        catch (std::bad_alloc const &)
+        {
+            if (mag.count == 0)
+            {
+                throw;
+            }
+
+            break;
+        }
+
+        *reinterpret_cast<size_t *>(block) = size;
+        mag.blocks[mag.count++] = block;
+    }
+}
+
+void thread_caching_resource::flush(
+    shared_state &state,
+    magazine &mag,
+    size_t index,
+    size_t count)
+{
+    size_t size = size_class_size(index);
+    count = std::min(count, mag.count);
+
+    // oldest blocks are at the bottom, hot ones stay cached
+    for (size_t i = 0; i < count; ++i)
+    {
+        state.upstream->deallocate(mag.blocks[i], size + block_metadata_size, alignof(std::max_align_t));
+    }
+
+    std::copy(mag.blocks.begin() + count, mag.blocks.begin() + mag.count, mag.blocks.begin());
+    mag.count -= count;
+}
+
+void thread_caching_resource::drain(thread_cache &cache)
+{
+    for (size_t index = 0; index < size_classes_count; ++index)
+    {
+        flush(*cache.state, cache.magazines[index], index, magazine_capacity);
+    }
+}
+
+thread_caching_resource::thread_cache_registry::~thread_cache_registry()
+{
+    for (auto cache : _caches)
+    {
+        {
+            std::lock_guard lock(cache->state->mutex);
+
+            if (cache->state->alive.load(std::memory_order_acquire))
+            {
+                drain(*cache);
+                auto &caches = cache->state->caches;
+                caches.erase(std::find(caches.begin(), caches.end(), cache));
+            }
+        }
+
+        delete cache;
+    }
+}
+
+thread_caching_resource::thread_cache &thread_caching_resource::thread_cache_registry::get(
+    std::shared_ptr<shared_state> const &state)
+{
+    if (_last != nullptr && _last->state == state)
+    {
+        return *_last;
+    }
+
+    auto it = std::find_if(_caches.begin(), _caches.end(),
+                           [&state](thread_cache *cache) { return cache->state == state; });
+
+    if (it != _caches.end())
+    {
+        _last = *it;
+        return *_last;
+    }
+
+    // caches of destroyed resources are already drained, so they are just dropped here
+    std::erase_if(_caches, [](thread_cache *cache)
+    {
+        if (cache->state->alive.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        delete cache;
+        return true;
+    });
+
+    auto cache = std::make_unique<thread_cache>();
+    cache->state = state;
+    _caches.reserve(_caches.size() + 1);
+
+    {
+        std::lock_guard lock(state->mutex);
+        state->caches.push_back(cache.get());
+    }
+
+    _caches.push_back(cache.get());
+    _last = cache.release();
+
+    return *_last;
+}
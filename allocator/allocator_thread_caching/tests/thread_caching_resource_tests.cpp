@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <allocator_guards.h>
+#include <client_logger_builder.h>
+#include <thread_caching_resource.h>
+#include <allocator_test_utils.h>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class counting_mem_resource final : public smart_mem_resource
+{
+
+public:
+
+    std::atomic<size_t> allocations = 0;
+
+    std::atomic<size_t> deallocations = 0;
+
+private:
+
+    std::mutex _mutex;
+
+    void *do_allocate_sm(size_t size) override
+    {
+        std::lock_guard lock(_mutex);
+        ++allocations;
+        return ::operator new(size);
+    }
+
+    void do_deallocate_sm(void *at) override
+    {
+        std::lock_guard lock(_mutex);
+        ++deallocations;
+        ::operator delete(at);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(threadCachingResourcePositiveTests, test1)
+{
+    counting_mem_resource upstream;
+    std::unique_ptr<smart_mem_resource> allocator_instance(new thread_caching_resource(&upstream));
+
+    auto first_block = reinterpret_cast<char *>(allocator_instance->allocate(sizeof(char) * 11));
+    strcpy(first_block, "0123456789");
+
+    ASSERT_EQ(upstream.allocations, thread_caching_resource::batch_size);
+
+    allocator_instance->deallocate(first_block, 1);
+    auto second_block = allocator_instance->allocate(sizeof(char) * 11);
+
+    ASSERT_EQ(first_block, second_block);
+    ASSERT_EQ(upstream.allocations, thread_caching_resource::batch_size);
+    ASSERT_EQ(upstream.deallocations, 0);
+
+    allocator_instance->deallocate(second_block, 1);
+    allocator_instance.reset();
+
+    ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(threadCachingResourcePositiveTests, test2)
+{
+    counting_mem_resource upstream;
+    thread_caching_resource allocator_instance(&upstream);
+
+    auto block = allocator_instance.allocate(thread_caching_resource::max_size_class + 1);
+
+    ASSERT_EQ(upstream.allocations, 1);
+
+    allocator_instance.deallocate(block, thread_caching_resource::max_size_class + 1);
+
+    ASSERT_EQ(upstream.deallocations, 1);
+}
+
+TEST(threadCachingResourcePositiveTests, test3)
+{
+    counting_mem_resource upstream;
+    thread_caching_resource allocator_instance(&upstream);
+
+    std::vector<void *> blocks;
+
+    for (size_t i = 0; i < thread_caching_resource::magazine_capacity * 3; ++i)
+    {
+        blocks.push_back(allocator_instance.allocate(sizeof(int) * 5));
+    }
+
+    for (auto block : blocks)
+    {
+        allocator_instance.deallocate(block, 1);
+    }
+
+    ASSERT_LE(upstream.allocations - upstream.deallocations, thread_caching_resource::magazine_capacity);
+
+    allocator_instance.flush_thread_cache();
+
+    ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(threadCachingResourcePositiveTests, test4)
+{
+    counting_mem_resource upstream;
+
+    {
+        thread_caching_resource allocator_instance(&upstream);
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&allocator_instance, t]()
+            {
+                std::list<void *> allocated_blocks;
+                srand(t);
+
+                for (int i = 0; i < 10000; ++i)
+                {
+                    if (rand() % 2 == 0 || allocated_blocks.empty())
+                    {
+                        size_t size = rand() % 3000 + 1;
+                        auto block = reinterpret_cast<unsigned char *>(allocator_instance.allocate(size));
+                        memset(block, t, size);
+                        allocated_blocks.push_back(block);
+                    }
+                    else
+                    {
+                        allocator_instance.deallocate(allocated_blocks.front(), 1);
+                        allocated_blocks.pop_front();
+                    }
+                }
+
+                for (auto block : allocated_blocks)
+                {
+                    allocator_instance.deallocate(block, 1);
+                }
+            });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(threadCachingResourcePositiveTests, test5)
+{
+    counting_mem_resource upstream;
+    thread_caching_resource allocator_instance(&upstream);
+
+    void *block = allocator_instance.allocate(sizeof(double) * 4);
+
+    std::thread([&allocator_instance, block]()
+    {
+        allocator_instance.deallocate(block, 1);
+    }).join();
+
+    allocator_instance.flush_thread_cache();
+
+    ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(threadCachingResourcePositiveTests, test6)
+{
+    std::unique_ptr<smart_mem_resource> alloc(new thread_caching_resource);
+
+    ASSERT_EQ(allocator_test_utils::check_alignments(*alloc), "");
+}
+
+TEST(threadCachingResourceFalsePositiveTests, test1)
+{
+    counting_mem_resource upstream;
+
+    {
+        thread_caching_resource source(&upstream);
+        void *block = source.allocate(24);
+
+        thread_caching_resource target(std::move(source));
+
+        ASSERT_THROW(static_cast<void>(source.allocate(24)), std::logic_error);
+        ASSERT_THROW(source.flush_thread_cache(), std::logic_error);
+
+        // allocator guards release the block before the resource is reached
+        if (!allocator_guards_enabled)
+        {
+            ASSERT_THROW(source.deallocate(block, 24), std::logic_error);
+        }
+
+        target.deallocate(block, 24);
+    }
+
+    ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+int main(
+    int argc,
+    char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
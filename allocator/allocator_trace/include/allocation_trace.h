@@ -0,0 +1,67 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATION_TRACE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATION_TRACE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Binary allocation trace: 8 bytes of magic followed by fixed size records in the order operations happened.
+ * Blocks are named by ids instead of addresses, so a trace can be replayed against any resource.
+ * Records are written in host byte order, traces are meant to be replayed on the machine kind they were taken on.
+ */
+class allocation_trace final
+{
+
+public:
+
+    enum class operation : uint8_t
+    {
+        allocate,
+        deallocate
+    };
+
+    struct record final
+    {
+
+        /**
+         * Nanoseconds since recording started
+         */
+        uint64_t timestamp;
+
+        uint64_t size;
+
+        uint64_t id;
+
+        /**
+         * Small number given to each recording thread in order of its first operation
+         */
+        uint32_t thread;
+
+        operation kind;
+
+        uint8_t alignment_power;
+
+        uint16_t reserved;
+
+        size_t alignment() const noexcept;
+
+    };
+
+    static_assert(sizeof(record) == 32);
+
+    static constexpr const std::array<char, 8> magic = { 'M', 'P', 'O', 'S', 'A', 'T', 'R', '1' };
+
+public:
+
+    /**
+     * Throws std::runtime_error if file can't be opened, has no trace magic or ends in the middle of a record
+     */
+    static std::vector<record> read(
+        std::string const &path);
+
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_ALLOCATION_TRACE_H
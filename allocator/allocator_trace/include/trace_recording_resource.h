@@ -0,0 +1,126 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_TRACE_RECORDING_RESOURCE_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_TRACE_RECORDING_RESOURCE_H
+
+#include <pp_allocator.h>
+#include <logger_guardant.h>
+#include <typename_holder.h>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "allocation_trace.h"
+
+/**
+ * Decorator over any upstream resource that appends every allocation and deallocation to an allocation_trace file.
+ * Put it between containers' pp_allocator and the real resource to capture the production allocation pattern,
+ * then feed the file to mp_os_allctr_allctr_trc_rplr to compare allocators and fit modes offline.
+ * Records are buffered and written in the order operations reach upstream, so the file is a valid sequential trace
+ * even when several threads share the resource.
+ */
+class trace_recording_resource final:
+    public smart_mem_resource,
+    private logger_guardant,
+    private typename_holder
+{
+
+public:
+
+    static constexpr const size_t buffer_capacity = 4096;
+
+private:
+
+    struct live_block
+    {
+        uint64_t id;
+        size_t size;
+        size_t alignment;
+    };
+
+    std::pmr::memory_resource *_upstream;
+
+    logger *_logger;
+
+    std::ofstream _stream;
+
+    std::mutex _mutex;
+
+    std::unordered_map<void *, live_block> _live;
+
+    std::vector<allocation_trace::record> _buffer;
+
+    uint64_t _next_id = 0;
+
+    std::chrono::steady_clock::time_point _start;
+
+public:
+
+    /**
+     * Throws std::runtime_error if trace file can't be created
+     */
+    explicit trace_recording_resource(
+        std::string const &trace_path,
+        std::pmr::memory_resource *upstream = nullptr,
+        logger *logger = nullptr);
+
+    trace_recording_resource(
+        trace_recording_resource const &other) = delete;
+
+    trace_recording_resource &operator=(
+        trace_recording_resource const &other) = delete;
+
+    trace_recording_resource(
+        trace_recording_resource &&other) = delete;
+
+    trace_recording_resource &operator=(
+        trace_recording_resource &&other) = delete;
+
+    ~trace_recording_resource() override;
+
+public:
+
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size) override;
+
+    void do_deallocate_sm(
+        void *at) override;
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+
+    /**
+     * Writes buffered records to the trace file
+     */
+    void flush();
+
+protected:
+
+    /**
+     * Upstream gets requested alignment as is, so the decorator does not change behaviour of the wrapped resource
+     */
+    [[nodiscard]] void *do_allocate_sm(
+        size_t size,
+        size_t alignment) override;
+
+    void do_deallocate_sm(
+        void *at,
+        size_t alignment) override;
+
+private:
+
+    inline logger *get_logger() const override;
+
+    inline std::string get_typename() const override;
+
+    void append(
+        allocation_trace::operation kind,
+        live_block const &block);
+
+    void flush_inner();
+
+    static uint32_t thread_number() noexcept;
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ALLOCATOR_TRACE_RECORDING_RESOURCE_H
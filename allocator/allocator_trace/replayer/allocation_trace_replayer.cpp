@@ -0,0 +1,216 @@
+#include <allocation_trace.h>
+#include <allocator_boundary_tags.h>
+#include <allocator_buddies_system.h>
+#include <allocator_global_heap.h>
+#include <allocator_red_black_tree.h>
+#include <allocator_slab.h>
+#include <allocator_sorted_list.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+struct subject
+{
+    std::string name;
+
+    std::string fit_mode;
+
+    std::function<std::unique_ptr<smart_mem_resource>()> create;
+};
+
+struct replay_result
+{
+    size_t operations = 0;
+
+    size_t failed = 0;
+
+    double seconds = 0;
+
+    uint64_t p99_nanoseconds = 0;
+
+    size_t peak_bytes_in_use = 0;
+
+    double fragmentation = 0;
+};
+
+std::vector<subject> subjects(size_t space_power)
+{
+    size_t space_size = size_t(1) << space_power;
+    std::vector<subject> result;
+
+    std::pair<allocator_with_fit_mode::fit_mode, std::string> const modes[] =
+        {
+            { allocator_with_fit_mode::fit_mode::first_fit, "first" },
+            { allocator_with_fit_mode::fit_mode::the_best_fit, "best" },
+            { allocator_with_fit_mode::fit_mode::the_worst_fit, "worst" }
+        };
+
+    for (auto const &[mode, mode_name] : modes)
+    {
+        result.push_back({ "sorted_list", mode_name, [=] { return std::make_unique<allocator_sorted_list>(space_size, nullptr, nullptr, mode); } });
+        result.push_back({ "boundary_tags", mode_name, [=] { return std::make_unique<allocator_boundary_tags>(space_size, nullptr, nullptr, mode); } });
+        result.push_back({ "red_black_tree", mode_name, [=] { return std::make_unique<allocator_red_black_tree>(space_size, nullptr, nullptr, mode); } });
+        result.push_back({ "buddies_system", mode_name, [=] { return std::make_unique<allocator_buddies_system>(space_power, nullptr, nullptr, mode); } });
+    }
+
+    result.push_back({ "slab", "-", [=] { return std::make_unique<allocator_slab>(space_size); } });
+    result.push_back({ "global_heap", "-", [] { return std::make_unique<allocator_global_heap>(); } });
+
+    return result;
+}
+
+/**
+ * Records are replayed sequentially in file order, which is the order operations reached the recorded resource.
+ * Blocks that failed to allocate are skipped when trace deallocates them
+ */
+replay_result replay(smart_mem_resource &resource, std::vector<allocation_trace::record> const &records)
+{
+    uint64_t ids_count = 0;
+
+    for (auto const &r : records)
+    {
+        ids_count = std::max(ids_count, r.id + 1);
+    }
+
+    std::vector<void *> blocks(ids_count, nullptr);
+    std::vector<uint64_t> latencies;
+    replay_result result;
+
+    latencies.reserve(records.size());
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto const &r : records)
+    {
+        void *&block = blocks[r.id];
+        auto operation_start = std::chrono::steady_clock::now();
+
+        if (r.kind == allocation_trace::operation::allocate)
+        {
+            try
+            {
+                block = resource.allocate(r.size, r.alignment());
+            }
+            catch (std::bad_alloc const &)
+            {
+                ++result.failed;
+            }
+        }
+        else if (block != nullptr)
+        {
+            resource.deallocate(block, r.size, r.alignment());
+            block = nullptr;
+        }
+        else
+        {
+            continue;
+        }
+
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - operation_start).count());
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.operations = latencies.size();
+
+    if (!latencies.empty())
+    {
+        auto p99 = latencies.begin() + static_cast<std::ptrdiff_t>(latencies.size() * 99 / 100);
+        std::nth_element(latencies.begin(), p99, latencies.end());
+        result.p99_nanoseconds = *p99;
+    }
+
+    if (auto *with_statistics = dynamic_cast<allocator_with_statistics *>(&resource))
+    {
+        auto statistics = with_statistics->get_statistics();
+
+        result.peak_bytes_in_use = statistics.peak_bytes_in_use;
+        result.fragmentation = statistics.fragmentation();
+    }
+
+    // blocks alive at the end of recording; size and alignment are taken from their allocation records
+    for (auto const &r : records)
+    {
+        if (r.kind == allocation_trace::operation::allocate && blocks[r.id] != nullptr)
+        {
+            resource.deallocate(blocks[r.id], r.size, r.alignment());
+            blocks[r.id] = nullptr;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Usage: mp_os_allctr_allctr_trc_rplr <trace file> [space size power] [allocator name]
+ * Trace is recorded by trace_recording_resource. Without allocator name every allocator and fit mode is replayed
+ */
+int main(
+    int argc,
+    char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <trace file> [space size power] [allocator name]" << std::endl;
+        return 1;
+    }
+
+    std::vector<allocation_trace::record> records;
+
+    try
+    {
+        records = allocation_trace::read(argv[1]);
+    }
+    catch (std::runtime_error const &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    size_t space_power = argc > 2 ? std::stoul(argv[2]) : 24;
+    std::string only = argc > 3 ? argv[3] : "";
+    std::set<uint32_t> threads;
+    uint64_t requested_bytes = 0;
+
+    for (auto const &r : records)
+    {
+        threads.insert(r.thread);
+        requested_bytes += r.kind == allocation_trace::operation::allocate ? r.size : 0;
+    }
+
+    std::cout << argv[1] << ": " << records.size() << " records from " << threads.size() << " threads, "
+              << requested_bytes << " bytes requested" << std::endl
+              << std::setw(16) << "allocator"
+              << std::setw(8) << "fit"
+              << std::setw(14) << "ops/sec"
+              << std::setw(10) << "p99 ns"
+              << std::setw(14) << "peak KiB"
+              << std::setw(8) << "frag"
+              << std::setw(10) << "failed" << std::endl;
+
+    for (auto const &s : subjects(space_power))
+    {
+        if (!only.empty() && s.name != only)
+        {
+            continue;
+        }
+
+        auto resource = s.create();
+        auto result = replay(*resource, records);
+
+        std::cout << std::setw(16) << s.name
+                  << std::setw(8) << s.fit_mode
+                  << std::setw(14) << std::fixed << std::setprecision(0) << result.operations / result.seconds
+                  << std::setw(10) << result.p99_nanoseconds
+                  << std::setw(14) << result.peak_bytes_in_use / 1024
+                  << std::setw(8) << std::setprecision(3) << result.fragmentation
+                  << std::setw(10) << result.failed << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <fstream>
+#include <stdexcept>
+#include "../include/allocation_trace.h"
+
+size_t allocation_trace::record::alignment() const noexcept
+{
+    return size_t(1) << alignment_power;
+}
+
+std::vector<allocation_trace::record> allocation_trace::read(
+    std::string const &path)
+{
+    std::ifstream stream(path, std::ios::binary);
+
+    if (!stream)
+    {
+        throw std::runtime_error("Cannot open allocation trace: " + path);
+    }
+
+    std::array<char, magic.size()> header{};
+
+    if (!stream.read(header.data(), header.size()) || header != magic)
+    {
+        throw std::runtime_error("Not an allocation trace: " + path);
+    }
+
+    std::vector<record> records;
+    record r;
+
+    while (stream.read(reinterpret_cast<char *>(&r), sizeof(record)))
+    {
+        records.push_back(r);
+    }
+
+    if (stream.gcount() != 0)
+    {
+        throw std::runtime_error("Allocation trace is truncated: " + path);
+    }
+
+    return records;
+}
@@ -0,0 +1,155 @@
+#include <atomic>
+#include <bit>
+#include <stdexcept>
+#include "../include/trace_recording_resource.h"
+
+trace_recording_resource::trace_recording_resource(
+    std::string const &trace_path,
+    std::pmr::memory_resource *upstream,
+    logger *logger):
+    _upstream(upstream == nullptr ? std::pmr::get_default_resource() : upstream),
+    _logger(logger),
+    _stream(trace_path, std::ios::binary | std::ios::trunc),
+    _start(std::chrono::steady_clock::now())
+{
+    if (!_stream)
+    {
+        throw std::runtime_error("Cannot open file: " + trace_path);
+    }
+
+    _stream.write(allocation_trace::magic.data(), allocation_trace::magic.size());
+    _buffer.reserve(buffer_capacity);
+
+    debug_with_guard(get_typename() + ": recording to " + trace_path);
+}
+
+trace_recording_resource::~trace_recording_resource()
+{
+    std::lock_guard lock(_mutex);
+
+    flush_inner();
+
+    if (!_live.empty())
+    {
+        warning_with_guard(get_typename() + ": " + std::to_string(_live.size()) + " blocks were not deallocated while recording");
+    }
+
+    debug_with_guard(get_typename() + ": destroyed");
+}
+
+[[nodiscard]] void *trace_recording_resource::do_allocate_sm(
+    size_t size)
+{
+    return do_allocate_sm(size, alignof(std::max_align_t));
+}
+
+void trace_recording_resource::do_deallocate_sm(
+    void *at)
+{
+    do_deallocate_sm(at, alignof(std::max_align_t));
+}
+
+[[nodiscard]] void *trace_recording_resource::do_allocate_sm(
+    size_t size,
+    size_t alignment)
+{
+    void *block = _upstream->allocate(size, alignment);
+
+    std::lock_guard lock(_mutex);
+
+    live_block recorded{ _next_id++, size, alignment };
+
+    _live.emplace(block, recorded);
+    append(allocation_trace::operation::allocate, recorded);
+
+    return block;
+}
+
+void trace_recording_resource::do_deallocate_sm(
+    void *at,
+    size_t)
+{
+    if (at == nullptr)
+    {
+        return;
+    }
+
+    live_block recorded;
+
+    {
+        // recorded before upstream can give the same address to another thread
+        std::lock_guard lock(_mutex);
+
+        auto it = _live.find(at);
+
+        if (it == _live.end())
+        {
+            error_with_guard(get_typename() + ": pointer was not allocated through this resource");
+            throw std::logic_error("trace_recording_resource: pointer was not allocated through this resource");
+        }
+
+        recorded = it->second;
+        _live.erase(it);
+        append(allocation_trace::operation::deallocate, recorded);
+    }
+
+    _upstream->deallocate(at, recorded.size, recorded.alignment);
+}
+
+bool trace_recording_resource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+void trace_recording_resource::flush()
+{
+    std::lock_guard lock(_mutex);
+
+    flush_inner();
+}
+
+void trace_recording_resource::append(
+    allocation_trace::operation kind,
+    live_block const &block)
+{
+    allocation_trace::record r{};
+
+    r.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+    r.size = block.size;
+    r.id = block.id;
+    r.thread = thread_number();
+    r.kind = kind;
+    r.alignment_power = static_cast<uint8_t>(std::countr_zero(block.alignment));
+
+    _buffer.push_back(r);
+
+    if (_buffer.size() == buffer_capacity)
+    {
+        flush_inner();
+    }
+}
+
+void trace_recording_resource::flush_inner()
+{
+    _stream.write(reinterpret_cast<char const *>(_buffer.data()), static_cast<std::streamsize>(_buffer.size() * sizeof(allocation_trace::record)));
+    _stream.flush();
+    _buffer.clear();
+}
+
+uint32_t trace_recording_resource::thread_number() noexcept
+{
+    static std::atomic<uint32_t> threads_count = 0;
+    thread_local uint32_t number = threads_count.fetch_add(1, std::memory_order_relaxed);
+
+    return number;
+}
+
+inline logger *trace_recording_resource::get_logger() const
+{
+    return _logger;
+}
+
+inline std::string trace_recording_resource::get_typename() const
+{
+    return "trace_recording_resource";
+}
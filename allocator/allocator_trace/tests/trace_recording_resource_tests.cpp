@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <allocator_guards.h>
+#include <allocator_sorted_list.h>
+#include <trace_recording_resource.h>
+#include <fstream>
+#include <list>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(traceRecordingResourcePositiveTests, test1)
+{
+    allocator_sorted_list upstream(1 << 16);
+
+    {
+        trace_recording_resource recorder("trace_recording_resource_tests_trace_1.bin", &upstream);
+        std::list<int, pp_allocator<int>> values{ pp_allocator<int>(&recorder) };
+
+        for (int i = 0; i < 100; ++i)
+        {
+            values.push_back(i);
+        }
+
+        for (int i = 0; i < 50; ++i)
+        {
+            values.pop_front();
+        }
+    }
+
+    auto records = allocation_trace::read("trace_recording_resource_tests_trace_1.bin");
+    std::map<uint64_t, uint64_t> live;
+    size_t allocations = 0;
+
+    ASSERT_EQ(records.size(), 200);
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        auto const &r = records[i];
+
+        ASSERT_EQ(r.alignment(), records[0].alignment());
+        ASSERT_EQ(r.thread, records[0].thread);
+
+        if (i > 0)
+        {
+            ASSERT_GE(r.timestamp, records[i - 1].timestamp);
+        }
+
+        if (r.kind == allocation_trace::operation::allocate)
+        {
+            ASSERT_TRUE(live.emplace(r.id, r.size).second);
+            ++allocations;
+            continue;
+        }
+
+        auto it = live.find(r.id);
+
+        ASSERT_NE(it, live.end());
+        ASSERT_EQ(it->second, r.size);
+        live.erase(it);
+    }
+
+    ASSERT_EQ(allocations, 100);
+    ASSERT_TRUE(live.empty());
+}
+
+TEST(traceRecordingResourcePositiveTests, test2)
+{
+    {
+        trace_recording_resource recorder("trace_recording_resource_tests_trace_2.bin");
+
+        void *block = recorder.allocate(100, 256);
+
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(block) % 256, 0);
+
+        recorder.deallocate(block, 100, 256);
+    }
+
+    auto records = allocation_trace::read("trace_recording_resource_tests_trace_2.bin");
+
+    ASSERT_EQ(records.size(), 2);
+    ASSERT_EQ(records[0].kind, allocation_trace::operation::allocate);
+    ASSERT_EQ(records[1].kind, allocation_trace::operation::deallocate);
+    ASSERT_EQ(records[0].id, records[1].id);
+    ASSERT_EQ(records[1].size, 100 + allocator_guards<allocator_guards_enabled>::overhead(256));
+    ASSERT_EQ(records[1].alignment(), 256);
+}
+
+TEST(traceRecordingResourcePositiveTests, test3)
+{
+    constexpr size_t threads_count = 4;
+    constexpr size_t blocks_count = 1000;
+
+    {
+        trace_recording_resource recorder("trace_recording_resource_tests_trace_3.bin");
+        std::vector<std::thread> threads;
+
+        for (size_t t = 0; t < threads_count; ++t)
+        {
+            threads.emplace_back([&recorder, t]
+            {
+                std::vector<void *> blocks;
+
+                for (size_t i = 0; i < blocks_count; ++i)
+                {
+                    blocks.push_back(recorder.allocate(8 + t));
+                }
+
+                for (void *block : blocks)
+                {
+                    recorder.deallocate(block, 8 + t);
+                }
+            });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    auto records = allocation_trace::read("trace_recording_resource_tests_trace_3.bin");
+    std::map<uint32_t, size_t> sizes_of_threads;
+    std::set<uint64_t> ids;
+
+    ASSERT_EQ(records.size(), 2 * threads_count * blocks_count);
+
+    for (auto const &r : records)
+    {
+        auto [it, inserted] = sizes_of_threads.emplace(r.thread, r.size);
+
+        ASSERT_EQ(it->second, r.size);
+
+        if (r.kind == allocation_trace::operation::allocate)
+        {
+            ASSERT_TRUE(ids.insert(r.id).second);
+        }
+        else
+        {
+            ASSERT_EQ(ids.erase(r.id), 1);
+        }
+    }
+
+    ASSERT_EQ(sizes_of_threads.size(), threads_count);
+    ASSERT_TRUE(ids.empty());
+}
+
+TEST(traceRecordingResourceNegativeTests, test1)
+{
+    if (allocator_guards_enabled)
+    {
+        GTEST_SKIP() << "allocator guards abort on a foreign pointer before the allocator can reject it";
+    }
+
+    trace_recording_resource recorder("trace_recording_resource_tests_trace_negative_1.bin");
+    int foreign;
+
+    ASSERT_THROW(recorder.deallocate(&foreign, sizeof(int)), std::logic_error);
+}
+
+TEST(traceRecordingResourceNegativeTests, test2)
+{
+    std::ofstream("trace_recording_resource_tests_not_a_trace.bin") << "plain text";
+
+    ASSERT_THROW(allocation_trace::read("trace_recording_resource_tests_not_a_trace.bin"), std::runtime_error);
+    ASSERT_THROW(allocation_trace::read("trace_recording_resource_tests_missing.bin"), std::runtime_error);
+}
+
+int main(
+    int argc,
+    char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
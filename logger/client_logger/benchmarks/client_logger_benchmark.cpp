@@ -0,0 +1,106 @@
+#include <client_logger.h>
+#include <client_logger_builder.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace
+{
+
+    constexpr size_t lines_count = 200000;
+
+    std::string const message = "allocator_boundary_tags: allocated 128 bytes at block 42 of chunk 7";
+
+    double lines_per_second(
+        std::function<void()> const &write_lines)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        write_lines();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return static_cast<double>(lines_count) / elapsed.count();
+    }
+
+    void report(
+        std::string const &name,
+        double rate)
+    {
+        std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed << std::setprecision(0)
+                  << rate << " lines/s" << std::endl;
+    }
+
+    /**
+     * File sink of client_logger before buffered sinks: std::ofstream written with std::endl
+     */
+    double ofstream_with_endl(
+        std::string const &path)
+    {
+        std::filesystem::remove(path);
+
+        std::ofstream stream(path, std::ios::app);
+
+        return lines_per_second([&stream]()
+        {
+            for (size_t i = 0; i < lines_count; ++i)
+            {
+                stream << message << std::endl;
+            }
+        });
+    }
+
+    double through_logger(
+        std::string const &path,
+        file_sink::flush_policy const &policy,
+        size_t async_capacity)
+    {
+        std::filesystem::remove(path);
+
+        client_logger_builder builder;
+
+        builder.set_flush_policy(policy).
+                add_file_stream(path, logger::severity::information).
+                set_format("[%d %t][%s] %m");
+
+        if (async_capacity != 0)
+        {
+            builder.set_async_mode(async_capacity);
+        }
+
+        std::unique_ptr<logger> log(builder.build());
+
+        return lines_per_second([&log]()
+        {
+            for (size_t i = 0; i < lines_count; ++i)
+            {
+                log->information(message);
+            }
+
+            dynamic_cast<client_logger &>(*log).flush();
+        });
+    }
+
+}
+
+int main()
+{
+    auto path = (std::filesystem::temp_directory_path() / "mp_os_client_logger_benchmark.log").string();
+    file_sink::flush_policy buffered{ file_sink::default_buffer_size, std::chrono::milliseconds(1000), logger::severity::error };
+
+    std::cout << lines_count << " lines of " << message.size() << " characters" << std::endl;
+
+    report("std::ofstream, std::endl per line (before)", ofstream_with_endl(path));
+    report("logger, write per line", through_logger(path, {}, 0));
+    report("logger, 64 KB buffer", through_logger(path, buffered, 0));
+    report("logger, 64 KB buffer, asynchronous", through_logger(path, buffered, 8192));
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_ASYNC_LOG_WRITER_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_ASYNC_LOG_WRITER_H
+
+#include <logger_builder.h>
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "file_sink.h"
+
+/**
+ * Bounded ring of records with a dedicated writer thread.
+ * Threads that log put either formatted text or serialized log_record into the ring, the writer takes all records ready,
+ * formats serialized ones, appends them to one buffer per destination and hands every destination its buffer once per batch
+ */
+class async_log_writer final
+{
+
+public:
+
+    using overflow_policy = logger_builder::async_overflow_policy;
+
+    struct destinations
+    {
+        std::vector<file_sink *> files;
+
+        bool console;
+    };
+
+    /**
+     * Appends text of serialized record logged at time to result, called on the writer thread
+     */
+    using record_formatter = std::function<void(logger::severity severity, std::time_t time, std::string_view record, std::string &result)>;
+
+private:
+
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+
+        logger::severity severity;
+
+        bool deferred;
+
+        /**
+         * Set when record could not be copied into the claimed cell, such cell is published only to keep the ring moving
+         */
+        bool skipped;
+
+        std::time_t time;
+
+        std::string record;
+    };
+
+    static constexpr const size_t max_batch_size = 256;
+
+    std::unordered_map<logger::severity, destinations> _destinations;
+
+    record_formatter _formatter;
+
+    overflow_policy _policy;
+
+    size_t _mask;
+
+    std::unique_ptr<cell[]> _cells;
+
+    alignas(64) std::atomic<size_t> _enqueue_position;
+
+    alignas(64) std::atomic<size_t> _dequeue_position;
+
+    /**
+     * Records put into the ring, the writer sleeps on it while the ring is empty
+     */
+    alignas(64) std::atomic<size_t> _pushed;
+
+    /**
+     * Records written or dropped from the ring, blocked producers and flush sleep on it
+     */
+    alignas(64) std::atomic<size_t> _processed;
+
+    std::atomic<size_t> _dropped;
+
+    std::atomic<bool> _stopping;
+
+    std::thread _writer;
+
+public:
+
+    /**
+     * Capacity is rounded up to a power of two. File sinks must outlive the writer
+     */
+    async_log_writer(
+        std::unordered_map<logger::severity, destinations> destinations,
+        record_formatter formatter,
+        size_t capacity,
+        overflow_policy policy);
+
+    async_log_writer(
+        async_log_writer const &other) = delete;
+
+    async_log_writer &operator=(
+        async_log_writer const &other) = delete;
+
+    async_log_writer(
+        async_log_writer &&other) = delete;
+
+    async_log_writer &operator=(
+        async_log_writer &&other) = delete;
+
+    /**
+     * Writes all records left in the ring and joins the writer thread
+     */
+    ~async_log_writer() noexcept;
+
+public:
+
+    /**
+     * Record is copied into its cell, cells keep their capacity, so steady logging does not allocate
+     */
+    void push(
+        logger::severity severity,
+        std::string_view record);
+
+    /**
+     * Serialized record is formatted by the writer thread
+     */
+    void push_deferred(
+        logger::severity severity,
+        std::time_t time,
+        std::string_view record);
+
+    /**
+     * Waits until every record pushed before the call is written or dropped
+     */
+    void flush();
+
+    size_t capacity() const noexcept;
+
+    overflow_policy policy() const noexcept;
+
+    size_t dropped_count() const noexcept;
+
+private:
+
+    void enqueue(
+        logger::severity severity,
+        bool deferred,
+        std::time_t time,
+        std::string_view record);
+
+    bool try_push(
+        logger::severity severity,
+        bool deferred,
+        std::time_t time,
+        std::string_view record);
+
+    bool try_pop(
+        logger::severity &severity,
+        bool &deferred,
+        bool &skipped,
+        std::time_t &time,
+        std::string &record) noexcept;
+
+    void run() noexcept;
+
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_ASYNC_LOG_WRITER_H
@@ -2,10 +2,16 @@
 #define MATH_PRACTICE_AND_OPERATING_SYSTEMS_CLIENT_LOGGER_H
 
 #include <logger.h>
+#include <logger_builder.h>
 #include <array>
+#include <memory>
 #include <unordered_map>
 #include <forward_list>
-#include <fstream>
+#include <ctime>
+#include <mutex>
+#include <vector>
+#include "async_log_writer.h"
+#include "file_sink.h"
 
 class client_logger_builder;
 
@@ -17,14 +23,23 @@ private:
 
     class refcounted_stream final
     {
-        static std::unordered_map<std::string, std::pair<size_t, std::ofstream>> _global_streams;
+        static std::unordered_map<std::string, std::pair<size_t, std::unique_ptr<file_sink>>> _global_streams;
+
+        //guards _global_streams and counters in it, sinks guard their own writes
+        static std::mutex _global_streams_mutex;
+
+        std::pair<std::string, file_sink*> _stream;
+
+        //used by the stream that opens the file, later streams share the sink as it is
+        file_sink::flush_policy _policy;
+
+        file_sink::rotation_policy _rotation;
 
-        std::pair<std::string, std::ofstream*> _stream;
         friend client_logger;
         friend client_logger_builder;
     public:
 
-        explicit refcounted_stream(const std::string& path);
+        explicit refcounted_stream(const std::string& path, file_sink::flush_policy policy = {}, file_sink::rotation_policy rotation = {});
 
         refcounted_stream(const refcounted_stream& oth);
 
@@ -34,7 +49,7 @@ private:
 
         refcounted_stream& operator=(refcounted_stream&& oth) noexcept;
 
-        //if ofstream* is nullptr initializes it with opened file from global map
+        //if file_sink* is nullptr initializes it with opened file from global map
         void open();
 
         ~refcounted_stream();
@@ -45,19 +60,48 @@ private:
     enum class flag
     { DATE, TIME, SEVERITY, MESSAGE, NO_FLAG };
 
+    //step of compiled format, NO_FLAG steps copy their literal
+    struct format_op
+    {
+        flag kind;
+
+        std::string literal;
+    };
+
 private:
 
     std::unordered_map<logger::severity ,std::pair<std::forward_list<refcounted_stream>, bool>> _output_streams;
 
-    std::string _format;
+    std::vector<format_op> _format_program;
+
+    bool _format_uses_timestamp;
+
+    //writes records in asynchronous mode, destroyed before streams it writes to
+    std::unique_ptr<async_log_writer> _async_writer;
 
 
 private:
 
-    //opens all streams
-    client_logger(const std::unordered_map<logger::severity ,std::pair<std::forward_list<refcounted_stream>, bool>>& streams, std::string format);
+    //opens all streams, async_capacity of zero builds synchronous logger
+    client_logger(
+        const std::unordered_map<logger::severity ,std::pair<std::forward_list<refcounted_stream>, bool>>& streams,
+        std::string format,
+        size_t async_capacity = 0,
+        logger_builder::async_overflow_policy async_policy = logger_builder::async_overflow_policy::block);
+
+    void start_async_writer(size_t capacity, logger_builder::async_overflow_policy policy);
+
+    //asynchronous logger puts serialized record into queue as it is, its writer formats it
+    logger& log_serialized(std::string_view record, logger::severity severity) & override;
+
+    //formats into thread local buffer reused by every log call of the thread
+    const std::string& make_format(std::string_view message, severity sev) const;
 
-    std::string make_format(const std::string& message, severity sev) const;
+    //appends message formatted by program as if it was logged at time when
+    static void apply_format(const std::vector<format_op>& program, std::string_view message, severity sev, std::time_t when, std::string& result);
+
+    //parses format once, adjacent literal characters become one step
+    static std::vector<format_op> compile_format(const std::string& format);
 
     static flag char_to_flag(char c) noexcept;
 
@@ -76,10 +120,18 @@ public:
 
 public:
 
+    using logger::log;
+
     [[nodiscard]] logger& log(
         const std::string &message,
         logger::severity severity) & override;
 
+    //waits until records logged before the call are written and writes buffers of its files
+    void flush();
+
+    //records lost by asynchronous logger to overflow_policy drop_newest or drop_oldest
+    [[nodiscard]] size_t dropped_records() const noexcept;
+
 };
 
 #endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_CLIENT_LOGGER_H
\ No newline at end of file
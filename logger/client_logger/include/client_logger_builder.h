@@ -16,6 +16,14 @@ private:
 
     std::string _format;
 
+    size_t _async_capacity = 0;
+
+    async_overflow_policy _async_policy = async_overflow_policy::block;
+
+    file_sink::flush_policy _flush_policy;
+
+    file_sink::rotation_policy _rotation_policy;
+
     void parse_severity(logger::severity, nlohmann::json& j);
 
 public:
@@ -53,6 +61,19 @@ public:
 
     logger_builder& set_destination(const std::string& format) & override;
 
+    //queue_capacity of zero makes built loggers synchronous again
+    logger_builder& set_async_mode(
+        size_t queue_capacity,
+        async_overflow_policy policy = async_overflow_policy::block) & override;
+
+    //applies to files added before and after the call, file shared with a logger built earlier keeps its policy
+    client_logger_builder& set_flush_policy(
+        file_sink::flush_policy const &policy) &;
+
+    //applies to files like set_flush_policy
+    client_logger_builder& set_rotation_policy(
+        file_sink::rotation_policy const &policy) &;
+
     logger_builder& clear() & override;
 
     [[nodiscard]] logger *build() const override;
@@ -0,0 +1,186 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_FILE_SINK_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_FILE_SINK_H
+
+#include <logger.h>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * Log file opened for appending with a user space buffer shared by every logger writing to it.
+ * Records are collected in the buffer and written when flush policy asks for it, a record that does not fit
+ * goes out in one writev call together with the buffer, so it is never copied.
+ * When rotation policy asks for it, the file is renamed to path.<date>-<time> and reopened under the sink lock,
+ * so no record is lost; compression and removal of old rotated files happen on a background thread.
+ * If the file can't be reopened, the renamed one takes its name back and rotation is retried a second later;
+ * rotated file is handed to the background thread only once nothing writes to it anymore
+ */
+class file_sink final
+{
+
+public:
+
+    struct flush_policy
+    {
+        /**
+         * Buffer is written when it holds that many bytes, zero writes every record at once
+         */
+        size_t bytes = 0;
+
+        /**
+         * Buffer is written at most that long after the previous write, by a background thread if no record comes
+         * to write it, zero disables it
+         */
+        std::chrono::milliseconds interval{ 0 };
+
+        /**
+         * Records of this severity and higher are written at once with everything buffered before them
+         */
+        logger::severity severity = logger::severity::error;
+    };
+
+    struct rotation_policy
+    {
+        /**
+         * File is rotated when it grows to that many bytes, zero disables it
+         */
+        size_t max_bytes = 0;
+
+        /**
+         * File is rotated by the first record after local midnight
+         */
+        bool daily = false;
+
+        /**
+         * Count of rotated files kept, older ones are removed, zero keeps all of them
+         */
+        size_t keep = 0;
+
+        /**
+         * Rotated files are compressed with gzip, if the logger is built with zlib
+         */
+        bool compress = true;
+    };
+
+    static constexpr const size_t default_buffer_size = 64 * 1024;
+
+private:
+
+    std::string _path;
+
+    int _descriptor;
+
+    flush_policy _policy;
+
+    rotation_policy _rotation;
+
+    size_t _file_size;
+
+    std::time_t _next_rollover;
+
+    std::time_t _rotation_retry;
+
+    /**
+     * Renamed file the descriptor still writes to, if it could neither be reopened nor take its name back
+     */
+    std::string _detached_path;
+
+    size_t _capacity;
+
+    std::string _buffer;
+
+    std::chrono::steady_clock::time_point _last_write;
+
+    std::mutex _mutex;
+
+public:
+
+    /**
+     * Throws std::runtime_error if file can't be opened
+     */
+    file_sink(
+        std::string const &path,
+        flush_policy policy,
+        rotation_policy rotation);
+
+    file_sink(
+        file_sink const &other) = delete;
+
+    file_sink &operator=(
+        file_sink const &other) = delete;
+
+    file_sink(
+        file_sink &&other) = delete;
+
+    file_sink &operator=(
+        file_sink &&other) = delete;
+
+    /**
+     * Writes what is left in buffer and closes file
+     */
+    ~file_sink() noexcept;
+
+public:
+
+    /**
+     * Appends record and line end
+     */
+    void write(
+        logger::severity severity,
+        std::string_view record);
+
+    /**
+     * Appends several records already ended with line ends, severity is the highest of them
+     */
+    void write_lines(
+        logger::severity severity,
+        std::string_view lines);
+
+    void flush();
+
+    /**
+     * Writes buffer if flush interval has passed since the previous write, returns when it is worth checking again
+     */
+    std::chrono::steady_clock::time_point flush_if_due();
+
+    flush_policy const &policy() const noexcept;
+
+    /**
+     * Whether rotated files are compressed when rotation policy asks for it
+     */
+    static bool compression_supported() noexcept;
+
+    /**
+     * Waits until files rotated so far are compressed and old ones are removed
+     */
+    static void wait_for_rotated_files();
+
+private:
+
+    /**
+     * Must be called under lock
+     */
+    bool rotation_due() const noexcept;
+
+    /**
+     * Writes buffer, renames file and opens a new one, must be called under lock
+     */
+    void rotate();
+
+    void append(
+        logger::severity severity,
+        std::string_view text,
+        std::string_view line_end);
+
+    /**
+     * Writes buffer followed by text and line end, must be called under lock
+     */
+    void write_out(
+        std::string_view text,
+        std::string_view line_end) noexcept;
+
+};
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_FILE_SINK_H
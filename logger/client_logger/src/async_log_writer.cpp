@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include "../include/async_log_writer.h"
+
+async_log_writer::async_log_writer(
+    std::unordered_map<logger::severity, destinations> destinations,
+    record_formatter formatter,
+    size_t capacity,
+    overflow_policy policy):
+    _destinations(std::move(destinations)),
+    _formatter(std::move(formatter)),
+    _policy(policy),
+    _mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+    _cells(new cell[_mask + 1]),
+    _enqueue_position(0),
+    _dequeue_position(0),
+    _pushed(0),
+    _processed(0),
+    _dropped(0),
+    _stopping(false)
+{
+    for (size_t i = 0; i <= _mask; ++i)
+    {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    _writer = std::thread(&async_log_writer::run, this);
+}
+
+async_log_writer::~async_log_writer() noexcept
+{
+    _stopping.store(true, std::memory_order_release);
+
+    // nothing flushes a writer being destroyed, so the extra count only wakes the writer thread
+    _pushed.fetch_add(1, std::memory_order_release);
+    _pushed.notify_one();
+
+    if (_writer.joinable())
+    {
+        _writer.join();
+    }
+}
+
+void async_log_writer::push(
+    logger::severity severity,
+    std::string_view record)
+{
+    enqueue(severity, false, 0, record);
+}
+
+void async_log_writer::push_deferred(
+    logger::severity severity,
+    std::time_t time,
+    std::string_view record)
+{
+    enqueue(severity, true, time, record);
+}
+
+void async_log_writer::enqueue(
+    logger::severity severity,
+    bool deferred,
+    std::time_t time,
+    std::string_view record)
+{
+    switch (_policy)
+    {
+        case overflow_policy::block:
+            while (!try_push(severity, deferred, time, record))
+            {
+                size_t processed = _processed.load(std::memory_order_acquire);
+
+                if (try_push(severity, deferred, time, record))
+                {
+                    break;
+                }
+
+                _processed.wait(processed, std::memory_order_acquire);
+            }
+            break;
+        case overflow_policy::drop_newest:
+            if (!try_push(severity, deferred, time, record))
+            {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            break;
+        case overflow_policy::drop_oldest:
+            while (!try_push(severity, deferred, time, record))
+            {
+                logger::severity oldest_severity;
+                bool oldest_deferred;
+                bool oldest_skipped;
+                std::time_t oldest_time;
+                std::string oldest;
+
+                if (try_pop(oldest_severity, oldest_deferred, oldest_skipped, oldest_time, oldest))
+                {
+                    _dropped.fetch_add(oldest_skipped ? 0 : 1, std::memory_order_relaxed);
+                    _processed.fetch_add(1, std::memory_order_release);
+                    _processed.notify_all();
+                }
+            }
+            break;
+    }
+
+    _pushed.fetch_add(1, std::memory_order_release);
+    _pushed.notify_one();
+}
+
+void async_log_writer::flush()
+{
+    size_t target = _enqueue_position.load(std::memory_order_acquire);
+    size_t processed;
+
+    while ((processed = _processed.load(std::memory_order_acquire)) < target)
+    {
+        _processed.wait(processed, std::memory_order_acquire);
+    }
+}
+
+size_t async_log_writer::capacity() const noexcept
+{
+    return _mask + 1;
+}
+
+async_log_writer::overflow_policy async_log_writer::policy() const noexcept
+{
+    return _policy;
+}
+
+size_t async_log_writer::dropped_count() const noexcept
+{
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+bool async_log_writer::try_push(
+    logger::severity severity,
+    bool deferred,
+    std::time_t time,
+    std::string_view record)
+{
+    size_t position = _enqueue_position.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        cell &target = _cells[position & _mask];
+        size_t sequence = target.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+        if (difference == 0)
+        {
+            if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                target.severity = severity;
+                target.deferred = deferred;
+                target.time = time;
+
+                // the writer swaps its drained string into the cell, so capacity circulates instead of being reallocated
+                try
+                {
+                    target.record.assign(record);
+                }
+                catch (...)
+                {
+                    // claimed cell is published anyway, an unpublished one would stall the writer forever,
+                    // the writer drops it and counts it as processed, so flush does not wait for it either
+                    target.skipped = true;
+                    target.sequence.store(position + 1, std::memory_order_release);
+                    _pushed.fetch_add(1, std::memory_order_release);
+                    _pushed.notify_one();
+                    throw;
+                }
+
+                target.skipped = false;
+                target.sequence.store(position + 1, std::memory_order_release);
+
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = _enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool async_log_writer::try_pop(
+    logger::severity &severity,
+    bool &deferred,
+    bool &skipped,
+    std::time_t &time,
+    std::string &record) noexcept
+{
+    size_t position = _dequeue_position.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        cell &target = _cells[position & _mask];
+        size_t sequence = target.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+        if (difference == 0)
+        {
+            if (_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                severity = target.severity;
+                deferred = target.deferred;
+                skipped = target.skipped;
+                time = target.time;
+                record.swap(target.record);
+                target.sequence.store(position + _mask + 1, std::memory_order_release);
+
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = _dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void async_log_writer::run() noexcept
+{
+    // lines of the batch for every file and the highest severity among them, which file flush policy looks at
+    std::unordered_map<file_sink *, std::pair<logger::severity, std::string>> file_buffers;
+    std::string console_buffer;
+    std::string formatted;
+    logger::severity severity;
+    bool deferred;
+    bool skipped;
+    std::time_t time;
+    std::string record;
+
+    while (true)
+    {
+        size_t pushed = _pushed.load(std::memory_order_acquire);
+        size_t batch_size = 0;
+
+        try
+        {
+            while (batch_size < max_batch_size && try_pop(severity, deferred, skipped, time, record))
+            {
+                ++batch_size;
+
+                auto found = _destinations.find(severity);
+
+                if (skipped || found == _destinations.end())
+                {
+                    continue;
+                }
+
+                std::string const *text = &record;
+
+                if (deferred)
+                {
+                    formatted.clear();
+                    _formatter(severity, time, record, formatted);
+                    text = &formatted;
+                }
+
+                if (found->second.console)
+                {
+                    console_buffer.append(*text).push_back('\n');
+                }
+
+                for (auto *file : found->second.files)
+                {
+                    auto &[highest, lines] = file_buffers[file];
+
+                    highest = lines.empty() ? severity : std::max(highest, severity);
+                    lines.append(*text).push_back('\n');
+                }
+            }
+
+            // console is flushed once per batch, files get the whole batch in one call and flush by their policy
+            if (!console_buffer.empty())
+            {
+                std::cout.write(console_buffer.data(), static_cast<std::streamsize>(console_buffer.size()));
+                std::cout.flush();
+                console_buffer.clear();
+            }
+
+            for (auto &[file, buffer] : file_buffers)
+            {
+                if (!buffer.second.empty())
+                {
+                    file->write_lines(buffer.first, buffer.second);
+                }
+
+                buffer.second.clear();
+            }
+        }
+        catch (...)
+        {
+            // records of a batch that failed to be buffered are lost, the writer keeps serving the ring
+            console_buffer.clear();
+            file_buffers.clear();
+        }
+
+        if (batch_size != 0)
+        {
+            _processed.fetch_add(batch_size, std::memory_order_release);
+            _processed.notify_all();
+            continue;
+        }
+
+        if (_stopping.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        _pushed.wait(pushed, std::memory_order_acquire);
+    }
+}
@@ -7,19 +7,66 @@
 #include "../include/client_logger.h"
 #include <not_implemented.h>
 
-std::unordered_map<std::string, std::pair<size_t, std::ofstream>> client_logger::refcounted_stream::_global_streams;
+std::unordered_map<std::string, std::pair<size_t, std::unique_ptr<file_sink>>> client_logger::refcounted_stream::_global_streams;
 
+std::mutex client_logger::refcounted_stream::_global_streams_mutex;
 
-client_logger::refcounted_stream::refcounted_stream(const std::string &path)
+namespace
+{
+
+    //date and time strings of the current second, rebuilt only when the second changes
+    struct timestamp_cache
+    {
+        std::time_t second = -1;
+
+        char date[16] = {};
+
+        size_t date_length = 0;
+
+        char time[16] = {};
+
+        size_t time_length = 0;
+
+        void refresh(std::time_t now)
+        {
+            if (now == second)
+            {
+                return;
+            }
+
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &now);
+#else
+            localtime_r(&now, &local);
+#endif
+            date_length = std::strftime(date, sizeof(date), "%d.%m.%Y", &local);
+            time_length = std::strftime(time, sizeof(time), "%H:%M:%S", &local);
+            second = now;
+        }
+    };
+
+    thread_local timestamp_cache timestamp;
+
+    thread_local std::string format_buffer;
+
+}
+
+
+client_logger::refcounted_stream::refcounted_stream(const std::string &path, file_sink::flush_policy policy, file_sink::rotation_policy rotation)
+    : _policy(policy), _rotation(rotation)
 {
     _stream.first = path;
     _stream.second = nullptr;
 }
 
 client_logger::refcounted_stream::refcounted_stream(const refcounted_stream &oth)
+    : _policy(oth._policy), _rotation(oth._rotation)
 {
-    _stream = oth._stream;
-    if (!_stream.first.empty() && _stream.second == nullptr)
+    // copy takes its own reference, so each of the copies releases one
+    _stream.first = oth._stream.first;
+    _stream.second = nullptr;
+    if (!_stream.first.empty())
     {
         open();
     }
@@ -36,6 +83,7 @@ client_logger::refcounted_stream &client_logger::refcounted_stream::operator=(co
 }
 
 client_logger::refcounted_stream::refcounted_stream(refcounted_stream &&oth) noexcept
+    : _policy(oth._policy), _rotation(oth._rotation)
 {
     _stream = std::move(oth._stream);
     oth._stream.second = nullptr;
@@ -58,32 +106,28 @@ void client_logger::refcounted_stream::open()
         return;
     }
 
+    std::lock_guard lock(_global_streams_mutex);
+
     auto it = _global_streams.find(_stream.first);
     if (it == _global_streams.end())
     {
-        std::ofstream stream(_stream.first, std::ios::app);
-        if (!stream.is_open())
-        {
-            throw std::runtime_error("Cannot open file: " + _stream.first);
-        }
-        _global_streams.emplace(_stream.first, std::make_pair(1, std::move(stream)));
-        _stream.second = &_global_streams.at(_stream.first).second;
-    }
-    else
-    {
-        ++it->second.first;
-        _stream.second = &it->second.second;
+        it = _global_streams.emplace(_stream.first, std::make_pair(0, std::make_unique<file_sink>(_stream.first, _policy, _rotation))).first;
     }
+
+    ++it->second.first;
+    _stream.second = it->second.second.get();
 }
 
 client_logger::refcounted_stream::~refcounted_stream()
 {
     if (!_stream.first.empty() && _stream.second != nullptr)
     {
+        std::lock_guard lock(_global_streams_mutex);
+
         auto it = _global_streams.find(_stream.first);
         if (it != _global_streams.end() && --it->second.first == 0)
         {
-            it->second.second.close();
+            // sink writes what is left in its buffer when destroyed
             _global_streams.erase(it);
         }
     }
@@ -95,9 +139,16 @@ client_logger::refcounted_stream::~refcounted_stream()
 
 client_logger::client_logger(
     const std::unordered_map<logger::severity, std::pair<std::forward_list<refcounted_stream>, bool>> &streams,
-    std::string format)
-    : _output_streams(streams), _format(std::move(format))
+    std::string format,
+    size_t async_capacity,
+    logger_builder::async_overflow_policy async_policy)
+    : _output_streams(streams), _format_program(compile_format(format))
 {
+    _format_uses_timestamp = std::any_of(_format_program.begin(), _format_program.end(), [](const format_op &op)
+    {
+        return op.kind == flag::DATE || op.kind == flag::TIME;
+    });
+
     for (auto &[severity, streams_pair] : _output_streams)
     {
         for (auto &stream : streams_pair.first)
@@ -105,10 +156,15 @@ client_logger::client_logger(
             stream.open();
         }
     }
+
+    if (async_capacity != 0)
+    {
+        start_async_writer(async_capacity, async_policy);
+    }
 }
 
 client_logger::client_logger(const client_logger &other)
-    : _output_streams(other._output_streams), _format(other._format)
+    : logger(other), _output_streams(other._output_streams), _format_program(other._format_program), _format_uses_timestamp(other._format_uses_timestamp)
 {
     for (auto &[severity, streams_pair] : _output_streams)
     {
@@ -117,6 +173,12 @@ client_logger::client_logger(const client_logger &other)
             stream.open();
         }
     }
+
+    // copy gets its own queue and writer thread with the same settings
+    if (other._async_writer)
+    {
+        start_async_writer(other._async_writer->capacity(), other._async_writer->policy());
+    }
 }
 
 client_logger &client_logger::operator=(const client_logger &other)
@@ -130,7 +192,7 @@ client_logger &client_logger::operator=(const client_logger &other)
 }
 
 client_logger::client_logger(client_logger &&other) noexcept
-    : _output_streams(std::move(other._output_streams)), _format(std::move(other._format))
+    : logger(std::move(other)), _output_streams(std::move(other._output_streams)), _format_program(std::move(other._format_program)), _format_uses_timestamp(other._format_uses_timestamp), _async_writer(std::move(other._async_writer))
 {
 }
 
@@ -146,11 +208,18 @@ client_logger &client_logger::operator=(client_logger &&other) noexcept
 
 client_logger::~client_logger() noexcept
 {
+    // records left in queue are written while their files are still open
+    _async_writer.reset();
     // Деструкторы refcounted_stream сами уменьшат счетчики и закроют файлы при необходимости
 }
 
 logger &client_logger::log(const std::string &message, logger::severity severity) &
 {
+    if (!is_enabled(severity))
+    {
+        return *this;
+    }
+
     auto it = _output_streams.find(severity);
     if (it == _output_streams.end())
     {
@@ -158,7 +227,13 @@ logger &client_logger::log(const std::string &message, logger::severity severity
     }
 
     const auto &[streams, use_console] = it->second;
-    std::string formatted_message = make_format(message, severity);
+    const std::string &formatted_message = make_format(message, severity);
+
+    if (_async_writer)
+    {
+        _async_writer->push(severity, formatted_message);
+        return *this;
+    }
 
     if (use_console)
     {
@@ -167,42 +242,148 @@ logger &client_logger::log(const std::string &message, logger::severity severity
 
     for (const auto &stream : streams)
     {
-        if (stream._stream.second != nullptr && stream._stream.second->is_open())
+        if (stream._stream.second != nullptr)
         {
-            *stream._stream.second << formatted_message << std::endl;
+            stream._stream.second->write(severity, formatted_message);
         }
     }
 
     return *this;
 }
 
-std::string client_logger::make_format(const std::string &message, severity sev) const
+logger &client_logger::log_serialized(std::string_view record, logger::severity severity) &
 {
-    std::string result;
+    if (!_async_writer)
+    {
+        return logger::log_serialized(record, severity);
+    }
+
+    // logger::log filtered disabled severities already
+    _async_writer->push_deferred(severity, _format_uses_timestamp ? std::time(nullptr) : 0, record);
+
+    return *this;
+}
+
+void client_logger::flush()
+{
+    if (_async_writer)
+    {
+        _async_writer->flush();
+    }
+
+    for (auto &[severity, streams_pair] : _output_streams)
+    {
+        for (auto &stream : streams_pair.first)
+        {
+            if (stream._stream.second != nullptr)
+            {
+                stream._stream.second->flush();
+            }
+        }
+    }
+}
+
+size_t client_logger::dropped_records() const noexcept
+{
+    return _async_writer ? _async_writer->dropped_count() : 0;
+}
+
+void client_logger::start_async_writer(size_t capacity, logger_builder::async_overflow_policy policy)
+{
+    std::unordered_map<logger::severity, async_log_writer::destinations> destinations;
+
+    for (const auto &[severity, streams_pair] : _output_streams)
+    {
+        auto &target = destinations[severity];
+
+        target.console = streams_pair.second;
+
+        for (const auto &stream : streams_pair.first)
+        {
+            if (stream._stream.second != nullptr)
+            {
+                target.files.push_back(stream._stream.second);
+            }
+        }
+    }
+
+    // writer outlives moves of the logger, so it gets its own copy of format program
+    auto formatter = [program = _format_program](logger::severity severity, std::time_t time, std::string_view record, std::string &result)
+    {
+        thread_local std::string message;
+
+        message.clear();
+        log_record::format(record, message);
+        apply_format(program, message, severity, time, result);
+    };
+
+    _async_writer = std::make_unique<async_log_writer>(std::move(destinations), std::move(formatter), capacity, policy);
+}
+
+const std::string &client_logger::make_format(std::string_view message, severity sev) const
+{
+    format_buffer.clear();
+    apply_format(_format_program, message, sev, _format_uses_timestamp ? std::time(nullptr) : 0, format_buffer);
+
+    return format_buffer;
+}
+
+void client_logger::apply_format(const std::vector<format_op> &program, std::string_view message, severity sev, std::time_t when, std::string &result)
+{
+    for (const auto &op : program)
+    {
+        switch (op.kind)
+        {
+            case flag::DATE:
+                timestamp.refresh(when);
+                result.append(timestamp.date, timestamp.date_length);
+                break;
+            case flag::TIME:
+                timestamp.refresh(when);
+                result.append(timestamp.time, timestamp.time_length);
+                break;
+            case flag::SEVERITY:
+                result += logger::severity_to_string(sev);
+                break;
+            case flag::MESSAGE:
+                result += message;
+                break;
+            case flag::NO_FLAG:
+                result += op.literal;
+                break;
+        }
+    }
+}
+
+std::vector<client_logger::format_op> client_logger::compile_format(const std::string &format)
+{
+    std::vector<format_op> program;
+
+    auto append_literal = [&program](std::string_view literal)
+    {
+        if (program.empty() || program.back().kind != flag::NO_FLAG)
+        {
+            program.push_back({ flag::NO_FLAG, {} });
+        }
+        program.back().literal += literal;
+    };
+
     bool in_format = false;
 
-    for (char c : _format)
+    for (char c : format)
     {
         if (in_format)
         {
-            switch (char_to_flag(c))
+            flag kind = char_to_flag(c);
+
+            if (kind == flag::NO_FLAG)
+            {
+                append_literal({ "%" });
+                append_literal({ &c, 1 });
+            }
+            else
             {
-                case flag::DATE:
-                    result += logger::current_date_to_string();
-                    break;
-                case flag::TIME:
-                    result += logger::current_time_to_string();
-                    break;
-                case flag::SEVERITY:
-                    result += logger::severity_to_string(sev);
-                    break;
-                case flag::MESSAGE:
-                    result += message;
-                    break;
-                case flag::NO_FLAG:
-                    result += '%';
-                    result += c;
-                    break;
+                program.push_back({ kind, {} });
             }
             in_format = false;
         }
@@ -212,16 +393,16 @@ std::string client_logger::make_format(const std::string &message, severity sev)
         }
         else
         {
-            result += c;
+            append_literal({ &c, 1 });
         }
     }
 
     if (in_format)
     {
-        result += '%';
+        append_literal({ "%" });
     }
 
-    return result;
+    return program;
 }
 
 client_logger::flag client_logger::char_to_flag(char c) noexcept
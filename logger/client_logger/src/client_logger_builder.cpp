@@ -11,7 +11,7 @@ logger_builder& client_logger_builder::add_file_stream(
     logger::severity severity) &
 {
     auto& [streams, use_console] = _output_streams[severity];
-    streams.emplace_front(stream_file_path);
+    streams.emplace_front(stream_file_path, _flush_policy, _rotation_policy);
     return *this;
 }
 
@@ -58,6 +58,37 @@ logger_builder& client_logger_builder::transform_with_configuration(
             _format = current->at("format").get<std::string>();
         }
 
+        // Асинхронный режим: "async": { "capacity": 4096, "overflow": "block" | "drop_newest" | "drop_oldest" }
+        if (current->contains("async")) {
+            auto const &async = current->at("async");
+            set_async_mode(
+                async.value("capacity", size_t(4096)),
+                string_to_async_overflow_policy(async.value("overflow", std::string("block"))));
+        }
+
+        // Сброс буферов файлов: "flush": { "bytes": 65536, "milliseconds": 1000, "severity": "ERROR" }
+        if (current->contains("flush")) {
+            auto const &flush = current->at("flush");
+            file_sink::flush_policy policy;
+            policy.bytes = flush.value("bytes", policy.bytes);
+            policy.interval = std::chrono::milliseconds(flush.value("milliseconds", policy.interval.count()));
+            if (flush.contains("severity")) {
+                policy.severity = string_to_severity(flush.at("severity").get<std::string>());
+            }
+            set_flush_policy(policy);
+        }
+
+        // Ротация файлов: "rotation": { "max_bytes": 10485760, "daily": true, "keep": 7, "compress": true }
+        if (current->contains("rotation")) {
+            auto const &rotation = current->at("rotation");
+            file_sink::rotation_policy policy;
+            policy.max_bytes = rotation.value("max_bytes", policy.max_bytes);
+            policy.daily = rotation.value("daily", policy.daily);
+            policy.keep = rotation.value("keep", policy.keep);
+            policy.compress = rotation.value("compress", policy.compress);
+            set_rotation_policy(policy);
+        }
+
         // Очищаем текущие настройки
         _output_streams.clear();
 
@@ -116,12 +147,72 @@ logger_builder& client_logger_builder::clear() &
 {
     _output_streams.clear();
     _format = "%m";
+    _async_capacity = 0;
+    _async_policy = async_overflow_policy::block;
+    _flush_policy = {};
+    _rotation_policy = {};
+    return *this;
+}
+
+client_logger_builder& client_logger_builder::set_rotation_policy(
+    file_sink::rotation_policy const &policy) &
+{
+    _rotation_policy = policy;
+
+    for (auto &[severity, streams] : _output_streams)
+    {
+        for (auto &stream : streams.first)
+        {
+            stream._rotation = policy;
+        }
+    }
+
+    return *this;
+}
+
+client_logger_builder& client_logger_builder::set_flush_policy(
+    file_sink::flush_policy const &policy) &
+{
+    _flush_policy = policy;
+
+    for (auto &[severity, streams] : _output_streams)
+    {
+        for (auto &stream : streams.first)
+        {
+            stream._policy = policy;
+        }
+    }
+
+    return *this;
+}
+
+logger_builder& client_logger_builder::set_async_mode(
+    size_t queue_capacity,
+    async_overflow_policy policy) &
+{
+    _async_capacity = queue_capacity;
+    _async_policy = policy;
     return *this;
 }
 
 logger* client_logger_builder::build() const
 {
-    return new client_logger(_output_streams, _format);
+    auto *result = new client_logger(_output_streams, _format, _async_capacity, _async_policy);
+
+    // severities without a file or console are filtered by is_enabled before any message is built
+    unsigned enabled_severities = 0;
+
+    for (const auto &[severity, streams] : _output_streams)
+    {
+        if (streams.second || !streams.first.empty())
+        {
+            enabled_severities |= client_logger::severity_bit(severity);
+        }
+    }
+
+    result->set_enabled_severities(enabled_severities);
+
+    return result;
 }
 
 logger_builder& client_logger_builder::set_format(const std::string& format) &
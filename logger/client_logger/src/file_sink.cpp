@@ -0,0 +1,632 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef MP_OS_LOGGER_ZLIB
+#include <zlib.h>
+#endif
+#include "../include/file_sink.h"
+
+namespace
+{
+
+    struct rotated_file
+    {
+        std::string path;
+
+        std::string base_path;
+
+        size_t keep;
+
+        bool compress;
+    };
+
+    /**
+     * Compresses rotated files and removes old ones one by one, so logging threads never wait for it
+     */
+    class rotated_files_worker final
+    {
+
+        std::mutex _mutex;
+
+        std::condition_variable _changed;
+
+        std::deque<rotated_file> _files;
+
+        bool _busy = false;
+
+        bool _stopping = false;
+
+        std::thread _thread;
+
+    public:
+
+        static rotated_files_worker &instance()
+        {
+            static rotated_files_worker worker;
+
+            return worker;
+        }
+
+        void submit(
+            rotated_file file)
+        {
+            {
+                std::lock_guard lock(_mutex);
+
+                _files.push_back(std::move(file));
+            }
+
+            _changed.notify_all();
+        }
+
+        void wait()
+        {
+            std::unique_lock lock(_mutex);
+
+            _changed.wait(lock, [this]() { return _files.empty() && !_busy; });
+        }
+
+        ~rotated_files_worker()
+        {
+            {
+                std::lock_guard lock(_mutex);
+
+                _stopping = true;
+            }
+
+            _changed.notify_all();
+            _thread.join();
+        }
+
+    private:
+
+        rotated_files_worker():
+            _thread(&rotated_files_worker::run, this)
+        {
+        }
+
+        void run()
+        {
+            std::unique_lock lock(_mutex);
+
+            while (true)
+            {
+                _changed.wait(lock, [this]() { return _stopping || !_files.empty(); });
+
+                // files rotated before exit are still processed
+                if (_files.empty())
+                {
+                    return;
+                }
+
+                auto file = std::move(_files.front());
+
+                _files.pop_front();
+                _busy = true;
+                lock.unlock();
+
+                try
+                {
+                    if (file.compress)
+                    {
+                        compress(file.path);
+                    }
+
+                    remove_old(file.base_path, file.keep);
+                }
+                catch (...)
+                {
+                    // rotated file stays as it is, logging is not affected
+                }
+
+                lock.lock();
+                _busy = false;
+                _changed.notify_all();
+            }
+        }
+
+        static void compress(
+            std::string const &path)
+        {
+#ifdef MP_OS_LOGGER_ZLIB
+            std::string const compressed = path + ".gz";
+            std::string const temporary = compressed + ".tmp";
+            std::ifstream source(path, std::ios::binary);
+
+            // file may already be gone, removed as old while waiting for its turn
+            if (!source.is_open())
+            {
+                return;
+            }
+
+            gzFile target = gzopen(temporary.c_str(), "wb");
+
+            if (target == nullptr)
+            {
+                return;
+            }
+
+            std::vector<char> chunk(file_sink::default_buffer_size);
+            bool written = true;
+
+            while (written && source)
+            {
+                source.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+
+                auto count = static_cast<unsigned>(source.gcount());
+
+                written = count == 0 || gzwrite(target, chunk.data(), count) == static_cast<int>(count);
+            }
+
+            if (gzclose(target) == Z_OK && written)
+            {
+                std::filesystem::rename(temporary, compressed);
+                std::filesystem::remove(path);
+            }
+            else
+            {
+                std::filesystem::remove(temporary);
+            }
+#else
+            static_cast<void>(path);
+#endif
+        }
+
+        static void remove_old(
+            std::string const &base_path,
+            size_t keep)
+        {
+            if (keep == 0)
+            {
+                return;
+            }
+
+            std::filesystem::path base(base_path);
+            auto directory = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+            auto prefix = base.filename().string() + ".";
+
+            // rotated names are prefix followed by date and time, so they sort by age
+            std::vector<std::pair<std::string, std::filesystem::path>> rotated;
+
+            for (auto const &entry : std::filesystem::directory_iterator(directory))
+            {
+                auto name = entry.path().filename().string();
+
+                if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+                    !std::isdigit(static_cast<unsigned char>(name[prefix.size()])) || name.ends_with(".tmp"))
+                {
+                    continue;
+                }
+
+                rotated.emplace_back(name.ends_with(".gz") ? name.substr(0, name.size() - 3) : name, entry.path());
+            }
+
+            if (rotated.size() <= keep)
+            {
+                return;
+            }
+
+            std::sort(rotated.begin(), rotated.end(), std::greater<>());
+
+            for (size_t i = keep; i < rotated.size(); ++i)
+            {
+                std::filesystem::remove(rotated[i].second);
+            }
+        }
+
+    };
+
+    /**
+     * Writes buffers of sinks with flush interval when no record comes to do it
+     */
+    class interval_flusher final
+    {
+
+        std::mutex _mutex;
+
+        std::condition_variable _changed;
+
+        std::vector<file_sink *> _sinks;
+
+        bool _stopping = false;
+
+        std::thread _thread;
+
+    public:
+
+        static interval_flusher &instance()
+        {
+            static interval_flusher flusher;
+
+            return flusher;
+        }
+
+        void add(
+            file_sink *sink)
+        {
+            {
+                std::lock_guard lock(_mutex);
+
+                _sinks.push_back(sink);
+            }
+
+            _changed.notify_all();
+        }
+
+        /**
+         * Sink is never flushed after this returns
+         */
+        void remove(
+            file_sink *sink) noexcept
+        {
+            std::lock_guard lock(_mutex);
+
+            _sinks.erase(std::find(_sinks.begin(), _sinks.end(), sink));
+        }
+
+        ~interval_flusher()
+        {
+            {
+                std::lock_guard lock(_mutex);
+
+                _stopping = true;
+            }
+
+            _changed.notify_all();
+            _thread.join();
+        }
+
+    private:
+
+        interval_flusher():
+            _thread(&interval_flusher::run, this)
+        {
+        }
+
+        void run()
+        {
+            std::unique_lock lock(_mutex);
+
+            while (!_stopping)
+            {
+                auto next = std::chrono::steady_clock::time_point::max();
+
+                // sink lock is taken under the flusher one, sinks never take them in the other order
+                for (auto *sink : _sinks)
+                {
+                    try
+                    {
+                        next = std::min(next, sink->flush_if_due());
+                    }
+                    catch (...)
+                    {
+                        // the sink is checked again with the next record or wake up
+                    }
+                }
+
+                if (next == std::chrono::steady_clock::time_point::max())
+                {
+                    _changed.wait(lock);
+                }
+                else
+                {
+                    _changed.wait_until(lock, next);
+                }
+            }
+        }
+
+    };
+
+    constexpr std::time_t rotation_retry_delay = 1;
+
+    /**
+     * Free name of form path.<date>-<time>[-<number>] for file rotated at given time
+     */
+    std::string rotated_path(
+        std::string const &path,
+        std::time_t now)
+    {
+        std::tm local{};
+        char stamp[32];
+
+        localtime_r(&now, &local);
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+
+        std::string rotated = path + "." + stamp;
+
+        std::error_code checked;
+
+        for (size_t i = 1; std::filesystem::exists(rotated, checked) || std::filesystem::exists(rotated + ".gz", checked); ++i)
+        {
+            char suffix[8];
+
+            std::snprintf(suffix, sizeof(suffix), "-%03zu", i);
+            rotated = path + "." + stamp + suffix;
+        }
+
+        return rotated;
+    }
+
+    std::time_t next_midnight(
+        std::time_t now)
+    {
+        std::tm local{};
+
+        localtime_r(&now, &local);
+        local.tm_hour = 0;
+        local.tm_min = 0;
+        local.tm_sec = 0;
+        ++local.tm_mday;
+        local.tm_isdst = -1;
+
+        return std::mktime(&local);
+    }
+
+}
+
+file_sink::file_sink(
+    std::string const &path,
+    flush_policy policy,
+    rotation_policy rotation):
+    _path(path),
+    _descriptor(::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)),
+    _policy(policy),
+    _rotation(rotation),
+    _file_size(0),
+    _next_rollover(next_midnight(std::time(nullptr))),
+    _rotation_retry(0),
+    _capacity(std::max(default_buffer_size, policy.bytes)),
+    _last_write(std::chrono::steady_clock::now())
+{
+    if (_descriptor == -1)
+    {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+
+    struct stat status;
+
+    if (::fstat(_descriptor, &status) == 0)
+    {
+        _file_size = static_cast<size_t>(status.st_size);
+    }
+
+    _buffer.reserve(_capacity);
+
+    // with zero bytes every record is written at once, so there is never anything to flush later
+    if (_policy.interval.count() != 0 && _policy.bytes != 0)
+    {
+        try
+        {
+            interval_flusher::instance().add(this);
+        }
+        catch (...)
+        {
+            ::close(_descriptor);
+            throw;
+        }
+    }
+}
+
+file_sink::~file_sink() noexcept
+{
+    if (_policy.interval.count() != 0 && _policy.bytes != 0)
+    {
+        interval_flusher::instance().remove(this);
+    }
+
+    write_out({}, {});
+    ::close(_descriptor);
+}
+
+void file_sink::write(
+    logger::severity severity,
+    std::string_view record)
+{
+    append(severity, record, "\n");
+}
+
+void file_sink::write_lines(
+    logger::severity severity,
+    std::string_view lines)
+{
+    append(severity, lines, {});
+}
+
+void file_sink::flush()
+{
+    std::lock_guard lock(_mutex);
+
+    write_out({}, {});
+}
+
+std::chrono::steady_clock::time_point file_sink::flush_if_due()
+{
+    std::lock_guard lock(_mutex);
+
+    auto now = std::chrono::steady_clock::now();
+
+    if (!_buffer.empty() && now - _last_write >= _policy.interval)
+    {
+        write_out({}, {});
+    }
+
+    // a record coming into empty buffer long after the last write is written by append itself
+    return _buffer.empty() && now - _last_write >= _policy.interval
+        ? now + _policy.interval
+        : _last_write + _policy.interval;
+}
+
+file_sink::flush_policy const &file_sink::policy() const noexcept
+{
+    return _policy;
+}
+
+bool file_sink::compression_supported() noexcept
+{
+#ifdef MP_OS_LOGGER_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+void file_sink::wait_for_rotated_files()
+{
+    rotated_files_worker::instance().wait();
+}
+
+bool file_sink::rotation_due() const noexcept
+{
+    return ((_rotation.max_bytes != 0 && _file_size + _buffer.size() >= _rotation.max_bytes) ||
+            (_rotation.daily && std::time(nullptr) >= _next_rollover)) &&
+           (_rotation_retry == 0 || std::time(nullptr) >= _rotation_retry);
+}
+
+void file_sink::rotate()
+{
+    write_out({}, {});
+
+    auto now = std::time(nullptr);
+
+    _next_rollover = next_midnight(now);
+
+    std::string rotated;
+
+    if (_detached_path.empty())
+    {
+        rotated = rotated_path(_path, now);
+
+        // old descriptor keeps pointing to the renamed file, so records go somewhere at every moment
+        std::error_code renamed;
+
+        std::filesystem::rename(_path, rotated, renamed);
+        if (renamed)
+        {
+            _file_size = 0;
+            return;
+        }
+    }
+    else
+    {
+        rotated = std::move(_detached_path);
+        _detached_path.clear();
+    }
+
+    int descriptor = ::open(_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+    if (descriptor == -1)
+    {
+        // records still go to the renamed file, so it must not be compressed or removed;
+        // link does not replace a file somebody else has created under the name meanwhile
+        if (::link(rotated.c_str(), _path.c_str()) == 0)
+        {
+            ::unlink(rotated.c_str());
+        }
+        else
+        {
+            _detached_path = std::move(rotated);
+        }
+
+        _rotation_retry = now + rotation_retry_delay;
+        return;
+    }
+
+    ::close(_descriptor);
+    _descriptor = descriptor;
+    _file_size = 0;
+    _rotation_retry = 0;
+
+    rotated_files_worker::instance().submit({ std::move(rotated), _path, _rotation.keep, _rotation.compress && compression_supported() });
+}
+
+void file_sink::append(
+    logger::severity severity,
+    std::string_view text,
+    std::string_view line_end)
+{
+    std::lock_guard lock(_mutex);
+
+    if (rotation_due())
+    {
+        rotate();
+    }
+
+    if (_buffer.size() + text.size() + line_end.size() > _capacity)
+    {
+        write_out(text, line_end);
+        return;
+    }
+
+    _buffer.append(text).append(line_end);
+
+    if (_policy.bytes == 0 || _buffer.size() >= _policy.bytes || severity >= _policy.severity ||
+        (_policy.interval.count() != 0 && std::chrono::steady_clock::now() - _last_write >= _policy.interval))
+    {
+        write_out({}, {});
+    }
+}
+
+void file_sink::write_out(
+    std::string_view text,
+    std::string_view line_end) noexcept
+{
+    iovec parts[3];
+    int count = 0;
+
+    for (auto part : { std::string_view(_buffer), text, line_end })
+    {
+        if (!part.empty())
+        {
+            parts[count++] = { const_cast<char *>(part.data()), part.size() };
+        }
+    }
+
+    iovec *next = parts;
+
+    while (count != 0)
+    {
+        ssize_t written = ::writev(_descriptor, next, count);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            // like a failed ofstream, logging goes on without the lines that could not be written
+            break;
+        }
+
+        auto left = static_cast<size_t>(written);
+
+        _file_size += left;
+
+        for (; count != 0 && left >= next->iov_len; ++next, --count)
+        {
+            left -= next->iov_len;
+        }
+
+        if (count != 0)
+        {
+            next->iov_base = static_cast<char *>(next->iov_base) + left;
+            next->iov_len -= left;
+        }
+    }
+
+    _buffer.clear();
+    _last_write = std::chrono::steady_clock::now();
+}
@@ -1,8 +1,641 @@
 #include <gtest/gtest.h>
 #include "../include/client_logger.h"
 #include "../include/client_logger_builder.h"
+#include "../include/async_log_writer.h"
+#include <logger_guardant.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace
+{
+
+    /**
+     * Makes allocations of the calling thread fail, for paths that must survive std::bad_alloc
+     */
+    thread_local bool fail_allocations = false;
+
+}
+
+void *operator new(
+    std::size_t size)
+{
+    if (!fail_allocations)
+    {
+        if (void *block = std::malloc(size == 0 ? 1 : size); block != nullptr)
+        {
+            return block;
+        }
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(
+    void *block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(
+    void *block,
+    std::size_t) noexcept
+{
+    std::free(block);
+}
+
+namespace
+{
+
+    std::vector<std::string> read_lines(
+        std::string const &path)
+    {
+        std::ifstream file(path);
+        std::vector<std::string> lines;
+
+        for (std::string line; std::getline(file, line);)
+        {
+            lines.push_back(line);
+        }
+
+        return lines;
+    }
+
+    size_t log_from_threads(
+        logger_builder::async_overflow_policy policy,
+        size_t queue_capacity,
+        std::string const &path)
+    {
+        constexpr size_t threads_count = 4;
+        constexpr size_t records_count = 500;
+
+        std::filesystem::remove(path);
+
+        client_logger_builder builder;
+
+        builder.add_file_stream(path, logger::severity::information).
+                set_async_mode(queue_capacity, policy);
+
+        std::unique_ptr<logger> log(builder.build());
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < threads_count; ++i)
+        {
+            threads.emplace_back([&log, i]()
+            {
+                for (size_t j = 0; j < records_count; ++j)
+                {
+                    log->information(std::to_string(i) + " " + std::to_string(j));
+                }
+            });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        auto &async_log = dynamic_cast<client_logger &>(*log);
+
+        async_log.flush();
+
+        size_t written = read_lines(path).size();
+
+        EXPECT_EQ(written + async_log.dropped_records(), threads_count * records_count);
+
+        return async_log.dropped_records();
+    }
+
+}
+
+TEST(clientLoggerFormatTests, compiledFormatKeepsUnknownFlagsAndTimestamp)
+{
+    std::string const path = "format.txt";
+
+    std::filesystem::remove(path);
+
+    {
+        client_logger_builder builder;
+
+        builder.add_file_stream(path, logger::severity::error).
+                set_format("%d %t [%s] %m %q 100%");
+
+        std::unique_ptr<logger> log(builder.build());
+
+        log->error("first").error("second");
+    }
+
+    auto lines = read_lines(path);
+
+    ASSERT_EQ(lines.size(), 2);
+
+    std::regex const expected(R"(\d{2}\.\d{2}\.\d{4} \d{2}:\d{2}:\d{2} \[ERROR\] (first|second) %q 100%)");
+
+    EXPECT_TRUE(std::regex_match(lines[0], expected)) << lines[0];
+    EXPECT_TRUE(std::regex_match(lines[1], expected)) << lines[1];
+    EXPECT_NE(lines[0].find("first"), std::string::npos);
+}
+
+namespace
+{
+
+    struct counted_argument
+    {
+        size_t *printed;
+    };
+
+    std::ostream &operator<<(
+        std::ostream &stream,
+        counted_argument const &argument)
+    {
+        ++*argument.printed;
+        return stream << "counted";
+    }
+
+    std::vector<std::string> log_structured(
+        bool async)
+    {
+        std::string const path = async ? "structured_async.txt" : "structured.txt";
+
+        std::filesystem::remove(path);
+
+        {
+            client_logger_builder builder;
+
+            builder.add_file_stream(path, logger::severity::information).
+                    set_format("[%s] %m");
+
+            if (async)
+            {
+                builder.set_async_mode(4);
+            }
+
+            std::unique_ptr<logger> log(builder.build());
+            size_t printed = 0;
+
+            log->log(logger::severity::information, "{} + {} = {}, {{braces}}", -2, 3u, 1.5).
+                 log(logger::severity::information, "{} {} {} {:x} {}", true, 'c', std::string("text"), "literal", counted_argument{ &printed }).
+                 log(logger::severity::information, "missing {}").
+                 log(logger::severity::information, "{} {}", static_cast<char const *>(nullptr), nullptr);
+
+            log->log(logger::severity::debug, "{}", counted_argument{ &printed });
+
+            EXPECT_EQ(printed, 1);
+        }
+
+        return read_lines(path);
+    }
+
+}
+
+TEST(clientLoggerStructuredTests, argumentsAreFormattedIntoPlaceholders)
+{
+    std::vector<std::string> const expected
+    {
+        "[INFORMATION] -2 + 3 = 1.5, {braces}",
+        "[INFORMATION] true c text literal counted",
+        "[INFORMATION] missing {}",
+        "[INFORMATION] (null) 0x0"
+    };
+
+    EXPECT_EQ(log_structured(false), expected);
+    EXPECT_EQ(log_structured(true), expected);
+}
+
+namespace
+{
+
+    class guarded final:
+        public logger_guardant
+    {
+
+        logger *_logger;
+
+    public:
+
+        explicit guarded(
+            logger *logger):
+            _logger(logger)
+        {
+        }
+
+    private:
+
+        logger *get_logger() const override
+        {
+            return _logger;
+        }
+
+    };
+
+}
+
+TEST(clientLoggerFilterTests, builderEnablesOnlyConfiguredSeverities)
+{
+    std::string const path = "filter.txt";
+
+    std::filesystem::remove(path);
+
+    client_logger_builder builder;
+
+    builder.add_file_stream(path, logger::severity::warning).
+            add_console_stream(logger::severity::critical);
+
+    std::unique_ptr<logger> log(builder.build());
+
+    EXPECT_FALSE(log->is_enabled(logger::severity::trace));
+    EXPECT_FALSE(log->is_enabled(logger::severity::error));
+    EXPECT_TRUE(log->is_enabled(logger::severity::warning));
+    EXPECT_TRUE(log->is_enabled(logger::severity::critical));
+
+    client_logger copy(dynamic_cast<client_logger &>(*log));
+
+    EXPECT_FALSE(copy.is_enabled(logger::severity::trace));
+
+    guarded guardant(log.get());
+    size_t built = 0;
+
+    guardant.trace_with_guard([&built] { ++built; return std::string("trace"); }).
+             warning_with_guard([&built] { ++built; return std::string("warning"); });
+
+    EXPECT_EQ(built, 1);
+    EXPECT_EQ(read_lines(path), std::vector<std::string>{ "warning" });
+
+    guarded without_logger(nullptr);
+
+    without_logger.critical_with_guard([&built] { ++built; return std::string("critical"); });
+
+    EXPECT_EQ(built, 1);
+}
+
+TEST(clientLoggerSinkTests, bufferedFileIsWrittenByPolicy)
+{
+    std::string const path = "buffered.txt";
+
+    std::filesystem::remove(path);
+
+    client_logger_builder builder;
+
+    builder.add_file_stream(path, logger::severity::information).
+            add_file_stream(path, logger::severity::error);
+    builder.set_flush_policy({ 1 << 20, std::chrono::milliseconds(0), logger::severity::error });
+
+    std::unique_ptr<logger> log(builder.build());
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        log->information(std::to_string(i));
+    }
+
+    EXPECT_TRUE(read_lines(path).empty());
+
+    log->error("error");
+
+    EXPECT_EQ(read_lines(path).size(), 11);
+
+    log->information("buffered");
+    dynamic_cast<client_logger &>(*log).flush();
+
+    EXPECT_EQ(read_lines(path).back(), "buffered");
+}
+
+TEST(clientLoggerSinkTests, intervalFlushNeedsNoNewRecord)
+{
+    std::string const path = "interval.txt";
+
+    std::filesystem::remove(path);
+
+    for (bool async : { false, true })
+    {
+        client_logger_builder builder;
+
+        builder.set_flush_policy({ 1 << 20, std::chrono::milliseconds(20), logger::severity::critical }).
+                add_file_stream(path, logger::severity::information);
+
+        if (async)
+        {
+            builder.set_async_mode(16);
+        }
+
+        std::unique_ptr<logger> log(builder.build());
+
+        log->information(async ? "async" : "sync");
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while (read_lines(path).size() != (async ? 2 : 1) && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        EXPECT_EQ(read_lines(path).back(), async ? "async" : "sync");
+    }
+}
+
+TEST(clientLoggerSinkTests, sharedFileKeepsLinesWhole)
+{
+    constexpr size_t threads_count = 4;
+    constexpr size_t records_count = 2000;
+    std::string const path = "shared.txt";
+
+    std::filesystem::remove(path);
+
+    {
+        client_logger_builder builder;
+
+        builder.set_flush_policy({ 4096, std::chrono::milliseconds(0), logger::severity::critical }).
+                add_file_stream(path, logger::severity::debug);
+
+        std::unique_ptr<logger> first(builder.build());
+        std::unique_ptr<logger> second(builder.build());
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < threads_count; ++i)
+        {
+            threads.emplace_back([&target = i % 2 == 0 ? first : second]()
+            {
+                for (size_t j = 0; j < records_count; ++j)
+                {
+                    target->debug(std::string(64, static_cast<char>('a' + j % 26)));
+                }
+            });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    auto lines = read_lines(path);
+
+    ASSERT_EQ(lines.size(), threads_count * records_count);
+
+    for (auto const &line : lines)
+    {
+        ASSERT_EQ(line, std::string(64, line.front()));
+    }
+}
+
+namespace
+{
+
+    std::vector<std::filesystem::path> rotated_files(
+        std::filesystem::path const &base)
+    {
+        std::vector<std::filesystem::path> result;
+
+        for (auto const &entry : std::filesystem::directory_iterator(base.parent_path()))
+        {
+            if (entry.path() != base)
+            {
+                result.push_back(entry.path());
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+
+        return result;
+    }
+
+}
+
+TEST(clientLoggerRotationTests, sizeRotationLosesNoLines)
+{
+    std::filesystem::path const directory = "rotation_size";
+    auto const base = directory / "rotated.log";
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    {
+        client_logger_builder builder;
+
+        builder.set_rotation_policy({ 1000, false, 0, false }).
+                add_file_stream(base.string(), logger::severity::information);
+
+        std::unique_ptr<logger> log(builder.build());
+
+        for (size_t i = 0; i < 500; ++i)
+        {
+            log->information("record " + std::to_string(i));
+        }
+    }
+
+    file_sink::wait_for_rotated_files();
+
+    auto files = rotated_files(base);
+
+    EXPECT_GT(files.size(), 2);
+
+    files.push_back(base);
+
+    std::vector<std::string> lines;
+
+    for (auto const &file : files)
+    {
+        EXPECT_LE(std::filesystem::file_size(file), 1000 + 16);
+
+        auto file_lines = read_lines(file.string());
+
+        lines.insert(lines.end(), file_lines.begin(), file_lines.end());
+    }
+
+    ASSERT_EQ(lines.size(), 500);
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        EXPECT_EQ(lines[i], "record " + std::to_string(i));
+    }
+}
+
+TEST(clientLoggerRotationTests, onlyNewestRotatedFilesAreKept)
+{
+    std::filesystem::path const directory = "rotation_keep";
+    auto const base = directory / "kept.log";
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    {
+        client_logger_builder builder;
+
+        builder.set_rotation_policy({ 500, false, 2, true }).
+                add_file_stream(base.string(), logger::severity::information);
+
+        std::unique_ptr<logger> log(builder.build());
+
+        for (size_t i = 0; i < 300; ++i)
+        {
+            log->information("record " + std::to_string(i));
+        }
+    }
+
+    file_sink::wait_for_rotated_files();
+
+    auto files = rotated_files(base);
+
+    ASSERT_EQ(files.size(), 2);
+
+    if (file_sink::compression_supported())
+    {
+        EXPECT_EQ(files[0].extension(), ".gz");
+        EXPECT_EQ(files[1].extension(), ".gz");
+    }
+
+    EXPECT_EQ(read_lines(base.string()).back(), "record 299");
+}
+
+TEST(clientLoggerRotationTests, failedReopenKeepsLogFile)
+{
+    std::filesystem::path const directory = "rotation_reopen";
+    auto const base = directory / "reopened.log";
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    {
+        client_logger_builder builder;
+
+        builder.set_rotation_policy({ 200, false, 1, false }).
+                add_file_stream(base.string(), logger::severity::information);
+
+        std::unique_ptr<logger> log(builder.build());
+
+        // no descriptor can be opened while the limit is the lowest free one
+        rlimit saved;
+        int probe = ::dup(0);
+
+        ::close(probe);
+        ::getrlimit(RLIMIT_NOFILE, &saved);
+
+        rlimit lowered = saved;
+
+        lowered.rlim_cur = static_cast<rlim_t>(probe);
+        ::setrlimit(RLIMIT_NOFILE, &lowered);
+
+        for (size_t i = 0; i < 50; ++i)
+        {
+            log->information("record " + std::to_string(i));
+        }
+
+        ::setrlimit(RLIMIT_NOFILE, &saved);
+
+        file_sink::wait_for_rotated_files();
+
+        EXPECT_TRUE(rotated_files(base).empty());
+        EXPECT_EQ(read_lines(base.string()).size(), 50);
+    }
+
+    auto lines = read_lines(base.string());
+
+    ASSERT_EQ(lines.size(), 50);
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        EXPECT_EQ(lines[i], "record " + std::to_string(i));
+    }
+}
+
+TEST(clientLoggerAsyncTests, recordsAreWrittenInOrder)
+{
+    std::string const path = "async_order.txt";
+
+    std::filesystem::remove(path);
+
+    {
+        client_logger_builder builder;
+
+        builder.add_file_stream(path, logger::severity::debug).
+                set_async_mode(16);
+
+        std::unique_ptr<logger> log(builder.build());
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            log->debug(std::to_string(i));
+        }
+    }
+
+    auto lines = read_lines(path);
+
+    ASSERT_EQ(lines.size(), 1000);
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        EXPECT_EQ(lines[i], std::to_string(i));
+    }
+}
+
+TEST(clientLoggerAsyncTests, blockingQueueLosesNothing)
+{
+    EXPECT_EQ(log_from_threads(logger_builder::async_overflow_policy::block, 4, "async_block.txt"), 0);
+}
+
+TEST(clientLoggerAsyncTests, droppingQueuesCountLostRecords)
+{
+    log_from_threads(logger_builder::async_overflow_policy::drop_newest, 2, "async_drop_newest.txt");
+    log_from_threads(logger_builder::async_overflow_policy::drop_oldest, 2, "async_drop_oldest.txt");
+}
+
+TEST(clientLoggerAsyncTests, recordFailedToQueueIsNotWritten)
+{
+    std::string const path = "async_failed_record.txt";
+    std::string const long_record(1000, 'x');
+
+    std::filesystem::remove(path);
+
+    {
+        file_sink sink(path, {}, {});
+        async_log_writer writer({ { logger::severity::information, { { &sink }, false } } }, nullptr, 4,
+                                logger_builder::async_overflow_policy::block);
+
+        writer.push(logger::severity::information, "before");
+
+        fail_allocations = true;
+        EXPECT_THROW(writer.push(logger::severity::information, long_record), std::bad_alloc);
+        fail_allocations = false;
+
+        writer.push(logger::severity::information, "after");
+        writer.flush();
+    }
+
+    EXPECT_EQ(read_lines(path), (std::vector<std::string>{ "before", "after" }));
+}
+
+TEST(clientLoggerAsyncTests, copyWritesThroughItsOwnQueue)
+{
+    std::string const path = "async_copy.txt";
+
+    std::filesystem::remove(path);
+
+    client_logger_builder builder;
+
+    builder.add_file_stream(path, logger::severity::warning).
+            set_async_mode(8, logger_builder::async_overflow_policy::block);
+
+    std::unique_ptr<logger> log(builder.build());
+
+    client_logger copy(dynamic_cast<client_logger &>(*log));
+
+    log->warning("from original");
+    copy.warning("from copy");
+
+    dynamic_cast<client_logger &>(*log).flush();
+    copy.flush();
+
+    EXPECT_EQ(read_lines(path).size(), 2);
+}
+
 
 int main(int argc, char *argv[])
 {
@@ -0,0 +1,152 @@
+#ifndef MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOG_RECORD_H
+#define MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOG_RECORD_H
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Binary form of a log call: format string followed by its arguments, each one tagged with its kind.
+ * Arguments are copied as they are, text is built by format only when the record is written,
+ * possibly by another thread
+ */
+class log_record final
+{
+
+public:
+
+    enum class tag : unsigned char
+    {
+        signed_integer,
+        unsigned_integer,
+        floating,
+        boolean,
+        character,
+        text,
+        pointer
+    };
+
+public:
+
+    /**
+     * Appends record to the end of buffer, so buffer reused between calls does not allocate.
+     * Types other than arithmetic, text and pointers are put as text made by their operator<<
+     */
+    template<typename ...arguments>
+    static void serialize(
+        std::string &buffer,
+        std::string_view format,
+        arguments const &...values);
+
+    /**
+     * Appends text of record to result. Every {} is replaced by the next argument, {{ and }} are braces.
+     * Anything between braces of placeholder is ignored, placeholders without arguments stay as they are
+     */
+    static void format(
+        std::string_view record,
+        std::string &result);
+
+private:
+
+    template<typename value_type>
+    static void put(
+        std::string &buffer,
+        value_type const &value);
+
+    static void put_raw(
+        std::string &buffer,
+        void const *data,
+        size_t size);
+
+    static void put_text(
+        std::string &buffer,
+        std::string_view text);
+
+};
+
+template<typename ...arguments>
+void log_record::serialize(
+    std::string &buffer,
+    std::string_view format,
+    arguments const &...values)
+{
+    put_text(buffer, format);
+    (put(buffer, values), ...);
+}
+
+template<typename value_type>
+void log_record::put(
+    std::string &buffer,
+    value_type const &value)
+{
+    if constexpr (std::is_same_v<value_type, bool>)
+    {
+        buffer.push_back(static_cast<char>(tag::boolean));
+        buffer.push_back(value ? 1 : 0);
+    }
+    else if constexpr (std::is_same_v<value_type, char>)
+    {
+        buffer.push_back(static_cast<char>(tag::character));
+        buffer.push_back(value);
+    }
+    else if constexpr (std::is_enum_v<value_type>)
+    {
+        put(buffer, static_cast<std::underlying_type_t<value_type>>(value));
+    }
+    else if constexpr (std::is_integral_v<value_type> && std::is_signed_v<value_type>)
+    {
+        auto widened = static_cast<int64_t>(value);
+
+        buffer.push_back(static_cast<char>(tag::signed_integer));
+        put_raw(buffer, &widened, sizeof(widened));
+    }
+    else if constexpr (std::is_integral_v<value_type>)
+    {
+        auto widened = static_cast<uint64_t>(value);
+
+        buffer.push_back(static_cast<char>(tag::unsigned_integer));
+        put_raw(buffer, &widened, sizeof(widened));
+    }
+    else if constexpr (std::is_floating_point_v<value_type>)
+    {
+        auto widened = static_cast<double>(value);
+
+        buffer.push_back(static_cast<char>(tag::floating));
+        put_raw(buffer, &widened, sizeof(widened));
+    }
+    else if constexpr (std::is_convertible_v<value_type const &, std::string_view>)
+    {
+        buffer.push_back(static_cast<char>(tag::text));
+
+        // string_view of null pointer is undefined, null string is written the way printf does it
+        if constexpr (std::is_pointer_v<value_type>)
+        {
+            put_text(buffer, value == nullptr ? std::string_view("(null)") : std::string_view(value));
+        }
+        else
+        {
+            put_text(buffer, std::string_view(value));
+        }
+    }
+    else if constexpr (std::is_pointer_v<value_type> || std::is_null_pointer_v<value_type>)
+    {
+        auto address = reinterpret_cast<uintptr_t>(static_cast<void const *>(value));
+
+        buffer.push_back(static_cast<char>(tag::pointer));
+        put_raw(buffer, &address, sizeof(address));
+    }
+    else
+    {
+        std::ostringstream text;
+
+        text << value;
+
+        buffer.push_back(static_cast<char>(tag::text));
+        put_text(buffer, text.view());
+    }
+}
+
+#endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOG_RECORD_H
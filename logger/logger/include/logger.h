@@ -2,6 +2,9 @@
 #define MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOGGER_H
 
 #include <iostream>
+#include <string>
+#include <string_view>
+#include "log_record.h"
 
 class logger
 {
@@ -28,6 +31,25 @@ public:
         std::string const &message,
         logger::severity severity) & = 0;
 
+    /**
+     * Whether records of severity reach any output, one bit test, so disabled logging costs no more than a branch
+     */
+    [[nodiscard]] bool is_enabled(
+        logger::severity severity) const noexcept
+    {
+        return (_enabled_severities & severity_bit(severity)) != 0;
+    }
+
+    /**
+     * Logs format with {} placeholders replaced by values. Values are serialized into binary record
+     * in thread local buffer and formatted by log_serialized, asynchronous loggers defer it to their writer
+     */
+    template<typename ...arguments>
+    logger& log(
+        logger::severity severity,
+        std::string_view format,
+        arguments const &...values) &;
+
 public:
 
     logger& trace(
@@ -50,6 +72,27 @@ public:
 
 protected:
 
+    static constexpr unsigned severity_bit(
+        logger::severity severity) noexcept
+    {
+        return 1u << static_cast<unsigned>(severity);
+    }
+
+    /**
+     * Set by builder from the outputs it configured, every severity is enabled by default
+     */
+    void set_enabled_severities(
+        unsigned severities_mask) noexcept;
+
+    /**
+     * Takes record made by log_record::serialize, by default formats it and logs it as string
+     */
+    virtual logger& log_serialized(
+        std::string_view record,
+        logger::severity severity) &;
+
+    static std::string &record_buffer() noexcept;
+
     static std::string severity_to_string(
         logger::severity severity);
 
@@ -59,7 +102,29 @@ protected:
 
     static std::string current_time_to_string();
 
+private:
+
+    unsigned _enabled_severities = ~0u;
+
 };
 
+template<typename ...arguments>
+logger& logger::log(
+    logger::severity severity,
+    std::string_view format,
+    arguments const &...values) &
+{
+    if (!is_enabled(severity))
+    {
+        return *this;
+    }
+
+    auto &record = record_buffer();
+
+    record.clear();
+    log_record::serialize(record, format, values...);
+
+    return log_serialized(record, severity);
+}
 
 #endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOGGER_H
\ No newline at end of file
@@ -6,6 +6,18 @@
 class logger_builder
 {
 
+public:
+
+    /**
+     * What logging thread does when queue of asynchronous logger is full
+     */
+    enum class async_overflow_policy
+    {
+        block,
+        drop_newest,
+        drop_oldest
+    };
+
 public:
 
     virtual ~logger_builder() noexcept = default;
@@ -31,9 +43,20 @@ public:
 
     virtual logger_builder& set_destination(const std::string& format) & =0;
 
+    /**
+     * Built logger puts formatted records into bounded queue of queue_capacity records and writes them
+     * from its own thread. Throws std::logic_error for loggers that can't write asynchronously
+     */
+    virtual logger_builder& set_async_mode(
+        size_t queue_capacity,
+        async_overflow_policy policy = async_overflow_policy::block) &;
+
     static logger::severity string_to_severity(
         std::string const &severity_string);
 
+    static async_overflow_policy string_to_async_overflow_policy(
+        std::string const &policy_string);
+
 };
 
 #endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOGGER_BUILDER_H
\ No newline at end of file
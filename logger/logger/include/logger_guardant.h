@@ -2,6 +2,9 @@
 #define MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOGGER_GUARDANT_H
 
 #include "logger.h"
+#include <string>
+#include <type_traits>
+#include <utility>
 
 class logger_guardant
 {
@@ -34,10 +37,227 @@ public:
     logger_guardant &critical_with_guard(
         std::string const &message) &;
 
+    /**
+     * Format with {} placeholders, nothing is serialized when there is no logger or severity is disabled
+     */
+    template<typename ...arguments>
+    logger_guardant &log_with_guard(
+        logger::severity severity,
+        std::string_view format,
+        arguments const &...values) &;
+
+    template<typename argument, typename ...arguments>
+    logger_guardant &trace_with_guard(
+        std::string_view format,
+        argument const &value,
+        arguments const &...values) &;
+
+    template<typename argument, typename ...arguments>
+    logger_guardant &debug_with_guard(
+        std::string_view format,
+        argument const &value,
+        arguments const &...values) &;
+
+    template<typename argument, typename ...arguments>
+    logger_guardant &information_with_guard(
+        std::string_view format,
+        argument const &value,
+        arguments const &...values) &;
+
+    template<typename argument, typename ...arguments>
+    logger_guardant &warning_with_guard(
+        std::string_view format,
+        argument const &value,
+        arguments const &...values) &;
+
+    template<typename argument, typename ...arguments>
+    logger_guardant &error_with_guard(
+        std::string_view format,
+        argument const &value,
+        arguments const &...values) &;
+
+    template<typename argument, typename ...arguments>
+    logger_guardant &critical_with_guard(
+        std::string_view format,
+        argument const &value,
+        arguments const &...values) &;
+
+    /**
+     * Message is built by calling message_builder only when there is a logger and severity is enabled,
+     * so expensive messages such as dumps cost nothing while their severity is disabled
+     */
+    template<typename message_builder>
+    requires std::is_invocable_r_v<std::string, message_builder>
+    logger_guardant &log_with_guard(
+        logger::severity severity,
+        message_builder &&build_message) &;
+
+    template<typename message_builder>
+    requires std::is_invocable_r_v<std::string, message_builder>
+    logger_guardant &trace_with_guard(
+        message_builder &&build_message) &;
+
+    template<typename message_builder>
+    requires std::is_invocable_r_v<std::string, message_builder>
+    logger_guardant &debug_with_guard(
+        message_builder &&build_message) &;
+
+    template<typename message_builder>
+    requires std::is_invocable_r_v<std::string, message_builder>
+    logger_guardant &information_with_guard(
+        message_builder &&build_message) &;
+
+    template<typename message_builder>
+    requires std::is_invocable_r_v<std::string, message_builder>
+    logger_guardant &warning_with_guard(
+        message_builder &&build_message) &;
+
+    template<typename message_builder>
+    requires std::is_invocable_r_v<std::string, message_builder>
+    logger_guardant &error_with_guard(
+        message_builder &&build_message) &;
+
+    template<typename message_builder>
+    requires std::is_invocable_r_v<std::string, message_builder>
+    logger_guardant &critical_with_guard(
+        message_builder &&build_message) &;
+
 protected:
 
     inline virtual logger *get_logger() const = 0;
 
 };
 
+template<typename ...arguments>
+logger_guardant &logger_guardant::log_with_guard(
+    logger::severity severity,
+    std::string_view format,
+    arguments const &...values) &
+{
+    logger *got_logger = get_logger();
+    if (got_logger != nullptr)
+    {
+        got_logger->log(severity, format, values...);
+    }
+
+    return *this;
+}
+
+template<typename argument, typename ...arguments>
+logger_guardant &logger_guardant::trace_with_guard(
+    std::string_view format,
+    argument const &value,
+    arguments const &...values) &
+{
+    return log_with_guard(logger::severity::trace, format, value, values...);
+}
+
+template<typename argument, typename ...arguments>
+logger_guardant &logger_guardant::debug_with_guard(
+    std::string_view format,
+    argument const &value,
+    arguments const &...values) &
+{
+    return log_with_guard(logger::severity::debug, format, value, values...);
+}
+
+template<typename argument, typename ...arguments>
+logger_guardant &logger_guardant::information_with_guard(
+    std::string_view format,
+    argument const &value,
+    arguments const &...values) &
+{
+    return log_with_guard(logger::severity::information, format, value, values...);
+}
+
+template<typename argument, typename ...arguments>
+logger_guardant &logger_guardant::warning_with_guard(
+    std::string_view format,
+    argument const &value,
+    arguments const &...values) &
+{
+    return log_with_guard(logger::severity::warning, format, value, values...);
+}
+
+template<typename argument, typename ...arguments>
+logger_guardant &logger_guardant::error_with_guard(
+    std::string_view format,
+    argument const &value,
+    arguments const &...values) &
+{
+    return log_with_guard(logger::severity::error, format, value, values...);
+}
+
+template<typename argument, typename ...arguments>
+logger_guardant &logger_guardant::critical_with_guard(
+    std::string_view format,
+    argument const &value,
+    arguments const &...values) &
+{
+    return log_with_guard(logger::severity::critical, format, value, values...);
+}
+
+template<typename message_builder>
+requires std::is_invocable_r_v<std::string, message_builder>
+logger_guardant &logger_guardant::log_with_guard(
+    logger::severity severity,
+    message_builder &&build_message) &
+{
+    logger *got_logger = get_logger();
+    if (got_logger != nullptr && got_logger->is_enabled(severity))
+    {
+        got_logger->log(std::string(std::forward<message_builder>(build_message)()), severity);
+    }
+
+    return *this;
+}
+
+template<typename message_builder>
+requires std::is_invocable_r_v<std::string, message_builder>
+logger_guardant &logger_guardant::trace_with_guard(
+    message_builder &&build_message) &
+{
+    return log_with_guard(logger::severity::trace, std::forward<message_builder>(build_message));
+}
+
+template<typename message_builder>
+requires std::is_invocable_r_v<std::string, message_builder>
+logger_guardant &logger_guardant::debug_with_guard(
+    message_builder &&build_message) &
+{
+    return log_with_guard(logger::severity::debug, std::forward<message_builder>(build_message));
+}
+
+template<typename message_builder>
+requires std::is_invocable_r_v<std::string, message_builder>
+logger_guardant &logger_guardant::information_with_guard(
+    message_builder &&build_message) &
+{
+    return log_with_guard(logger::severity::information, std::forward<message_builder>(build_message));
+}
+
+template<typename message_builder>
+requires std::is_invocable_r_v<std::string, message_builder>
+logger_guardant &logger_guardant::warning_with_guard(
+    message_builder &&build_message) &
+{
+    return log_with_guard(logger::severity::warning, std::forward<message_builder>(build_message));
+}
+
+template<typename message_builder>
+requires std::is_invocable_r_v<std::string, message_builder>
+logger_guardant &logger_guardant::error_with_guard(
+    message_builder &&build_message) &
+{
+    return log_with_guard(logger::severity::error, std::forward<message_builder>(build_message));
+}
+
+template<typename message_builder>
+requires std::is_invocable_r_v<std::string, message_builder>
+logger_guardant &logger_guardant::critical_with_guard(
+    message_builder &&build_message) &
+{
+    return log_with_guard(logger::severity::critical, std::forward<message_builder>(build_message));
+}
+
 #endif //MATH_PRACTICE_AND_OPERATING_SYSTEMS_LOGGER_GUARDANT_H
\ No newline at end of file
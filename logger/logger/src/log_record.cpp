@@ -0,0 +1,144 @@
+#include <charconv>
+#include "../include/log_record.h"
+
+namespace
+{
+
+    template<typename value_type>
+    value_type take(
+        std::string_view &record)
+    {
+        value_type value;
+
+        std::memcpy(&value, record.data(), sizeof(value_type));
+        record.remove_prefix(sizeof(value_type));
+
+        return value;
+    }
+
+    std::string_view take_text(
+        std::string_view &record)
+    {
+        auto length = take<size_t>(record);
+        auto text = record.substr(0, length);
+
+        record.remove_prefix(length);
+
+        return text;
+    }
+
+    template<typename value_type>
+    void append_number(
+        std::string &result,
+        value_type value,
+        int base = 10)
+    {
+        char digits[32];
+        std::to_chars_result converted;
+
+        if constexpr (std::is_floating_point_v<value_type>)
+        {
+            converted = std::to_chars(digits, digits + sizeof(digits), value);
+        }
+        else
+        {
+            converted = std::to_chars(digits, digits + sizeof(digits), value, base);
+        }
+
+        result.append(digits, converted.ptr);
+    }
+
+    void append_argument(
+        std::string_view &record,
+        std::string &result)
+    {
+        switch (static_cast<log_record::tag>(take<char>(record)))
+        {
+            case log_record::tag::signed_integer:
+                append_number(result, take<int64_t>(record));
+                break;
+            case log_record::tag::unsigned_integer:
+                append_number(result, take<uint64_t>(record));
+                break;
+            case log_record::tag::floating:
+                append_number(result, take<double>(record));
+                break;
+            case log_record::tag::boolean:
+                result += take<char>(record) != 0 ? "true" : "false";
+                break;
+            case log_record::tag::character:
+                result += take<char>(record);
+                break;
+            case log_record::tag::text:
+                result += take_text(record);
+                break;
+            case log_record::tag::pointer:
+                result += "0x";
+                append_number(result, take<uintptr_t>(record), 16);
+                break;
+        }
+    }
+
+}
+
+void log_record::format(
+    std::string_view record,
+    std::string &result)
+{
+    auto format = take_text(record);
+
+    for (size_t i = 0; i < format.size(); ++i)
+    {
+        char c = format[i];
+
+        if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c)
+        {
+            result += c;
+            ++i;
+            continue;
+        }
+
+        if (c != '{')
+        {
+            result += c;
+            continue;
+        }
+
+        auto closing = format.find('}', i);
+
+        if (closing == std::string_view::npos)
+        {
+            result += format.substr(i);
+            break;
+        }
+
+        if (record.empty())
+        {
+            result += format.substr(i, closing - i + 1);
+        }
+        else
+        {
+            append_argument(record, result);
+        }
+
+        i = closing;
+    }
+}
+
+void log_record::put_raw(
+    std::string &buffer,
+    void const *data,
+    size_t size)
+{
+    buffer.append(reinterpret_cast<char const *>(data), size);
+}
+
+void log_record::put_text(
+    std::string &buffer,
+    std::string_view text)
+{
+    size_t length = text.size();
+
+    put_raw(buffer, &length, sizeof(length));
+    buffer.append(text);
+}
@@ -38,6 +38,31 @@ logger &logger::critical(
     return log(message, logger::severity::critical);
 }
 
+void logger::set_enabled_severities(
+    unsigned severities_mask) noexcept
+{
+    _enabled_severities = severities_mask;
+}
+
+logger &logger::log_serialized(
+    std::string_view record,
+    logger::severity severity) &
+{
+    thread_local std::string message;
+
+    message.clear();
+    log_record::format(record, message);
+
+    return log(message, severity);
+}
+
+std::string &logger::record_buffer() noexcept
+{
+    thread_local std::string buffer;
+
+    return buffer;
+}
+
 std::string logger::severity_to_string(
     logger::severity severity)
 {
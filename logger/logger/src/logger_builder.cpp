@@ -1,3 +1,4 @@
+#include <stdexcept>
 #include "../include/logger_builder.h"
 
 logger::severity logger_builder::string_to_severity(
@@ -29,4 +30,30 @@ logger::severity logger_builder::string_to_severity(
     }
 
     throw std::out_of_range("invalid severity string value");
-}
\ No newline at end of file
+}
+
+logger_builder& logger_builder::set_async_mode(
+    size_t,
+    async_overflow_policy) &
+{
+    throw std::logic_error("asynchronous mode is not supported by this logger");
+}
+
+logger_builder::async_overflow_policy logger_builder::string_to_async_overflow_policy(
+    std::string const &policy_string)
+{
+    if (policy_string == "block")
+    {
+        return async_overflow_policy::block;
+    }
+    if (policy_string == "drop_newest")
+    {
+        return async_overflow_policy::drop_newest;
+    }
+    if (policy_string == "drop_oldest")
+    {
+        return async_overflow_policy::drop_oldest;
+    }
+
+    throw std::out_of_range("invalid async overflow policy string value");
+}
@@ -31,6 +31,8 @@ public:
 
 public:
 
+    using logger::log;
+
     [[nodiscard]] logger& log(
         const std::string &message,
         logger::severity severity) & override;